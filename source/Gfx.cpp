@@ -1,8 +1,20 @@
 #include "Gfx.hpp"
 #include "utils/SDL_FontCache.h"
+#include "utils/TextRenderCache.hpp"
+#include "utils/GlyphPrewarmer.hpp"
+#include "utils/GlyphAtlas.hpp"
+#include "utils/GeometryBatch.hpp"
+#include "utils/NineSliceCache.hpp"
+#include "utils/FileLogger.hpp"
+#include "utils/FrameDamage.hpp"
+#include "utils/FrameProfiler.hpp"
 #include <cstdarg>
 #include <cmath>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <zlib.h>
 
 #include <coreinit/debug.h>
 #include <coreinit/memory.h>
@@ -40,6 +52,77 @@ namespace {
 
     std::map<Uint16, SDL_Texture *> iconCache;
 
+    // Glyph layouts of drawn strings and width/height measurements
+    TextRenderCache textCache;
+    
+    // Background rasterization of glyphs that are about to be drawn
+    GlyphPrewarmer glyphPrewarmer;
+    
+    // Untextured primitives, flushed before anything textured is drawn
+    GeometryBatch geometry;
+    
+    // Anti-aliased rounded rect corners, drawn through the geometry batch
+    NineSliceCache nineSlices;
+    
+    // Sizes that get their own FC_Font and glyph cache (includes GLYPH_SIZES baked by the
+    // Makefile); every other size is drawn scaled down from the next larger tier
+    constexpr int FONT_SIZE_TIERS[] = {24, 28, 32, 40, 48, 64};
+    
+    // A font size baked into a glyph atlas; glyphs point into the embedded atlas data
+    struct BakedFace {
+        bool latin;
+        int size;
+        int height;
+        SDL_Texture *texture;
+        const GlyphAtlasGlyph *glyphs;
+        uint32_t count;
+    };
+    
+    struct BakedIcon {
+        SDL_Texture *texture;
+        SDL_Rect rect;
+    };
+    
+    // Loaded atlases stay alive until shutdown, fonts keep pointing at their glyphs
+    std::vector<const uint8_t *> loadedAtlases;
+    
+    std::vector<SDL_Texture *> atlasTextures;
+    
+    std::vector<BakedFace> bakedFaces;
+    
+    std::map<Uint16, BakedIcon> bakedIcons;
+    
+    // Atlas textures shared as extra FC cache levels, detached before FC_FreeFont
+    std::vector<std::pair<FC_Font *, int>> attachedLevels;
+    
+    bool HasBakedFace(bool latin, int size) {
+        return std::any_of(bakedFaces.begin(), bakedFaces.end(), [&](const BakedFace &face) {
+            return face.latin == latin && face.size == size;
+        });
+    }
+    
+    void AttachBakedFace(FC_Font *font, const BakedFace &face) {
+        // The atlas cells are only valid for the exact metrics SDL_ttf reports here
+        if (FC_GetLineHeight(font) != face.height) {
+            FileLogger::GetInstance().LogError("[GlyphAtlas] Height mismatch at %dpt (%d baked, %d runtime), not using atlas",
+                face.size, face.height, (int) FC_GetLineHeight(font));
+            return;
+        }
+        
+        int level = FC_GetNumCacheLevels(font);
+        if (!FC_SetGlyphCacheLevel(font, level, face.texture)) {
+            return;
+        }
+        attachedLevels.push_back({font, level});
+        
+        for (uint32_t i = 0; i < face.count; i++) {
+            const GlyphAtlasGlyph &glyph = face.glyphs[i];
+            if (!FC_HasGlyph(font, glyph.codepoint)) {
+                FC_SetGlyphData(font, glyph.codepoint, FC_MakeGlyphData(level, glyph.x, glyph.y, glyph.w, glyph.h));
+            }
+        }
+    }
+    
     FC_Font *GetFontForSize(int size) {
         // Choose appropriate font cache based on current font setting
         auto &cache = useLatinFont ? latinFontMap : fontMap;
@@ -57,15 +140,70 @@ namespace {
         void *selectedFontData = useLatinFont ? latinFontData : fontData;
         uint32_t selectedFontSize = useLatinFont ? latinFontSize : fontSize;
 
+        // Baked sizes skip the ASCII preload, the atlas already has those glyphs
+        if (HasBakedFace(useLatinFont, size)) {
+            FC_SetLoadingString(font, "");
+        }
+        
         if (!FC_LoadFont_RW(font, renderer, SDL_RWFromMem(selectedFontData, selectedFontSize), 1, size, Gfx::COLOR_BLACK, TTF_STYLE_NORMAL)) {
             FC_FreeFont(font);
             return nullptr;
         }
 
+        for (const auto &face : bakedFaces) {
+            if (face.latin == useLatinFont && face.size == size) {
+                AttachBakedFace(font, face);
+            }
+        }
+        
+        // glyphs of in-between sizes are drawn scaled from this cache
+        FC_SetFilterMode(font, FC_FILTER_LINEAR);
+        
         cache.insert({size, font});
         return font;
     }
 
+    int GetFontTier(int size) {
+        for (int tier : FONT_SIZE_TIERS) {
+            if (size <= tier) {
+                return tier;
+            }
+        }
+        return FONT_SIZE_TIERS[std::size(FONT_SIZE_TIERS) - 1];
+    }
+    
+    // Font for any requested size: the next larger tier, drawn with scale = size / tier
+    FC_Font *GetScaledFont(int size, float &scale) {
+        int tier = GetFontTier(size);
+        scale = (float) size / tier;
+        return GetFontForSize(tier);
+    }
+    
+    // Texture memory of all text glyph caches, shared atlas textures counted once
+    void LogFontTextureMemory() {
+        std::vector<SDL_Texture *> textures;
+        size_t bytes = 0;
+        
+        for (const auto *cache : {&fontMap, &latinFontMap}) {
+            for (const auto &[size, font] : *cache) {
+                for (int i = 0; i < FC_GetNumCacheLevels(font); i++) {
+                    SDL_Texture *texture = FC_GetGlyphCacheLevel(font, i);
+                    if (!texture || std::find(textures.begin(), textures.end(), texture) != textures.end()) {
+                        continue;
+                    }
+                    textures.push_back(texture);
+                    
+                    int w, h;
+                    SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+                    bytes += (size_t) w * h * 4;
+                }
+            }
+        }
+        
+        FileLogger::GetInstance().LogInfo("[Gfx] Font textures: %zu fonts, %zu textures, %zu KB",
+            fontMap.size() + latinFontMap.size(), textures.size(), bytes / 1024);
+    }
+    
     SDL_Texture *LoadIcon(Uint16 icon) {
         if (iconCache.contains(icon)) {
             return iconCache[icon];
@@ -86,6 +224,23 @@ namespace {
         return texture;
     }
 
+    // Baked icons come from the atlas, everything else is rendered on first use
+    SDL_Texture *GetIconTexture(Uint16 icon, SDL_Rect &src) {
+        auto it = bakedIcons.find(icon);
+        if (it != bakedIcons.end()) {
+            src = it->second.rect;
+            return it->second.texture;
+        }
+        
+        SDL_Texture *texture = LoadIcon(icon);
+        if (texture) {
+            src.x = 0;
+            src.y = 0;
+            SDL_QueryTexture(texture, nullptr, nullptr, &src.w, &src.h);
+        }
+        return texture;
+    }
+    
 } // namespace
 
 namespace Gfx {
@@ -117,6 +272,11 @@ namespace Gfx {
 
         TTF_Init();
 
+        // solid primitives sample the white block of the nine-slice atlas, so both share one batch
+        if (nineSlices.Init(renderer)) {
+            geometry.SetTexture(renderer, nineSlices.GetTexture(), nineSlices.GetSolidUV());
+        }
+        
         monospaceFont = FC_CreateFont();
         if (!monospaceFont) {
             return false;
@@ -137,6 +297,16 @@ namespace Gfx {
     }
 
     void Shutdown() {
+        glyphPrewarmer.Shutdown();
+        textCache.Clear();
+        LogFontTextureMemory();
+        
+        // atlas textures are shared between fonts, release them only once below
+        for (const auto &[font, level] : attachedLevels) {
+            FC_SetGlyphCacheLevel(font, level, nullptr);
+        }
+        attachedLevels.clear();
+        
         for (const auto &[key, value] : fontMap) {
             FC_FreeFont(value);
         }
@@ -148,7 +318,18 @@ namespace Gfx {
         for (const auto &[key, value] : iconCache) {
             SDL_DestroyTexture(value);
         }
+        
+        for (SDL_Texture *texture : atlasTextures) {
+            SDL_DestroyTexture(texture);
+        }
+        atlasTextures.clear();
+        bakedFaces.clear();
+        bakedIcons.clear();
+        loadedAtlases.clear();
 
+        geometry.SetTexture(renderer, nullptr, SDL_FPoint{0.0f, 0.0f});
+        nineSlices.Shutdown();
+        
         FC_FreeFont(monospaceFont);
         TTF_CloseFont(iconFont);
         TTF_Quit();
@@ -166,16 +347,129 @@ namespace Gfx {
         return useLatinFont;
     }
 
+    void PrewarmGlyphs(std::string_view text, std::initializer_list<int> sizes) {
+        if (!renderer || text.empty()) {
+            return;
+        }
+        
+        void *selectedFontData = useLatinFont ? latinFontData : fontData;
+        uint32_t selectedFontSize = useLatinFont ? latinFontSize : fontSize;
+        
+        for (int size : sizes) {
+            int tier = GetFontTier(size);
+            FC_Font *font = GetFontForSize(tier);
+            if (font) {
+                glyphPrewarmer.Request(font, selectedFontData, selectedFontSize, tier, text);
+            }
+        }
+    }
+    
+    bool LoadGlyphAtlas(const uint8_t *data, size_t size) {
+        if (!renderer || !data || size < sizeof(GlyphAtlasHeader)) {
+            return false;
+        }
+        
+        // switching back to an earlier language reuses its atlas
+        if (std::find(loadedAtlases.begin(), loadedAtlases.end(), data) != loadedAtlases.end()) {
+            return true;
+        }
+        
+        auto t1 = std::chrono::steady_clock::now();
+        
+        const GlyphAtlasHeader *header = reinterpret_cast<const GlyphAtlasHeader *>(data);
+        const size_t facesOffset = sizeof(GlyphAtlasHeader);
+        const size_t glyphsOffset = facesOffset + (size_t) header->faceCount * sizeof(GlyphAtlasFace);
+        const size_t pixelsOffset = glyphsOffset + (size_t) header->glyphCount * sizeof(GlyphAtlasGlyph);
+        
+        if (header->magic != GLYPHATLAS_MAGIC || header->version != GLYPHATLAS_VERSION ||
+            header->width == 0 || header->height == 0 || pixelsOffset + header->dataSize > size) {
+            FileLogger::GetInstance().LogError("[GlyphAtlas] Invalid atlas data");
+            return false;
+        }
+        
+        // 8-bit coverage -> white RGBA, color comes from texture color mod like FC glyphs
+        std::vector<uint8_t> coverage((size_t) header->width * header->height);
+        uLongf coverageSize = coverage.size();
+        if (uncompress(coverage.data(), &coverageSize, data + pixelsOffset, header->dataSize) != Z_OK ||
+            coverageSize != coverage.size()) {
+            FileLogger::GetInstance().LogError("[GlyphAtlas] Failed to decompress atlas");
+            return false;
+        }
+        
+        std::vector<Uint32> pixels(coverage.size());
+        for (size_t i = 0; i < coverage.size(); i++) {
+            pixels[i] = 0xFFFFFF00u | coverage[i];
+        }
+        
+        SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC,
+                                                 header->width, header->height);
+        if (!texture) {
+            FileLogger::GetInstance().LogError("[GlyphAtlas] Failed to create %ux%u texture", header->width, header->height);
+            return false;
+        }
+        SDL_UpdateTexture(texture, nullptr, pixels.data(), header->width * sizeof(Uint32));
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        
+        atlasTextures.push_back(texture);
+        loadedAtlases.push_back(data);
+        
+        const bool latin = (header->flags & GLYPHATLAS_FLAG_CJK) == 0;
+        const GlyphAtlasFace *faces = reinterpret_cast<const GlyphAtlasFace *>(data + facesOffset);
+        const GlyphAtlasGlyph *glyphs = reinterpret_cast<const GlyphAtlasGlyph *>(data + glyphsOffset);
+        
+        for (uint32_t i = 0; i < header->faceCount; i++) {
+            const GlyphAtlasFace &face = faces[i];
+            if (face.firstGlyph + face.glyphCount > header->glyphCount) {
+                continue;
+            }
+            
+            if (face.kind == GLYPHATLAS_FACE_ICON) {
+                for (uint32_t g = face.firstGlyph; g < face.firstGlyph + face.glyphCount; g++) {
+                    SDL_Rect rect{glyphs[g].x, glyphs[g].y, glyphs[g].w, glyphs[g].h};
+                    bakedIcons.insert({(Uint16) glyphs[g].codepoint, BakedIcon{texture, rect}});
+                }
+                continue;
+            }
+            
+            BakedFace baked{latin, (int) face.size, (int) face.height, texture, glyphs + face.firstGlyph, face.glyphCount};
+            bakedFaces.push_back(baked);
+            
+            // fonts created before this atlas (e.g. after a language switch) get the glyphs too
+            auto &cache = latin ? latinFontMap : fontMap;
+            auto it = cache.find(baked.size);
+            if (it != cache.end()) {
+                AttachBakedFace(it->second, baked);
+            }
+        }
+        
+        auto t2 = std::chrono::steady_clock::now();
+        FileLogger::GetInstance().LogInfo("  [+%lldms] Glyph atlas loaded (%ux%u, %u faces, %u glyphs, %u KB texture)",
+            std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(),
+            header->width, header->height, header->faceCount, header->glyphCount,
+            (unsigned) (coverage.size() * sizeof(Uint32) / 1024));
+        
+        return true;
+    }
+    
     void Clear(SDL_Color color) {
+        geometry.Flush(renderer);
         SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
         SDL_RenderClear(renderer);
     }
 
     void Render() {
+        geometry.Flush(renderer);
+        geometry.OnFrame();
+        textCache.OnFrame();
         SDL_RenderPresent(renderer);
+        
+        // upload a few prewarmed glyphs between frames
+        glyphPrewarmer.UploadBatch();
     }
     
     SDL_Renderer* GetRenderer() {
+        // callers draw directly, keep the order with batched primitives
+        geometry.Flush(renderer);
         return renderer;
     }
     
@@ -188,10 +482,8 @@ namespace Gfx {
     }
 
     void DrawRectFilled(int x, int y, int w, int h, SDL_Color color) {
-        SDL_Rect rect{x, y, w, h};
-        Uint8 finalAlpha = (Uint8)(color.a * globalAlpha);
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, finalAlpha);
-        SDL_RenderFillRect(renderer, &rect);
+        color.a = (Uint8)(color.a * globalAlpha);
+        geometry.AddRect(x, y, w, h, color);
     }
 
     void DrawRect(int x, int y, int w, int h, int borderSize, SDL_Color color) {
@@ -202,23 +494,28 @@ namespace Gfx {
     }
 
     void DrawIcon(int x, int y, int size, SDL_Color color, Uint16 icon, AlignFlags align, double angle) {
-        SDL_Texture *iconTex = LoadIcon(icon);
+        SDL_Rect src;
+        SDL_Texture *iconTex = GetIconTexture(icon, src);
         if (!iconTex) {
             return;
         }
 
+        geometry.Flush(renderer);
+        
+        // Rotated icons are loading spinners, keep redrawing while they are visible
+        if (angle != 0.0) {
+            FrameDamage::Mark();
+        }
+        
         SDL_SetTextureColorMod(iconTex, color.r, color.g, color.b);
         Uint8 finalAlpha = (Uint8)(color.a * globalAlpha);
         SDL_SetTextureAlphaMod(iconTex, finalAlpha);
 
-        int w, h;
-        SDL_QueryTexture(iconTex, nullptr, nullptr, &w, &h);
-
         SDL_Rect rect;
         rect.x = x;
         rect.y = y;
         // scale the width based on hight to keep AR
-        rect.w = (int) (((float) w / h) * size);
+        rect.w = (int) (((float) src.w / src.h) * size);
         rect.h = size;
 
         if (align & ALIGN_RIGHT) {
@@ -235,26 +532,26 @@ namespace Gfx {
 
         // draw the icon
         if (angle) {
-            SDL_RenderCopyEx(renderer, iconTex, nullptr, &rect, angle, nullptr, SDL_FLIP_NONE);
+            SDL_RenderCopyEx(renderer, iconTex, &src, &rect, angle, nullptr, SDL_FLIP_NONE);
         } else {
-            SDL_RenderCopy(renderer, iconTex, nullptr, &rect);
+            SDL_RenderCopy(renderer, iconTex, &src, &rect);
         }
     }
 
     int GetIconWidth(int size, Uint16 icon) {
-        SDL_Texture *iconTex = LoadIcon(icon);
+        SDL_Rect src;
+        SDL_Texture *iconTex = GetIconTexture(icon, src);
         if (!iconTex) {
             return 0;
         }
 
-        int w, h;
-        SDL_QueryTexture(iconTex, nullptr, nullptr, &w, &h);
-
-        return (int) (((float) w / h) * size);
+        return (int) (((float) src.w / src.h) * size);
     }
 
-    void Print(int x, int y, int size, SDL_Color color, std::string text, AlignFlags align, bool monospace) {
-        FC_Font *font = monospace ? monospaceFont : GetFontForSize(size);
+    void Print(int x, int y, int size, SDL_Color color, std::string_view text, AlignFlags align, bool monospace) {
+        ProfileScope scope(FrameProfiler::STAGE_PRINT);
+        float fontScale = 1.0f;
+        FC_Font *font = monospace ? monospaceFont : GetScaledFont(size, fontScale);
         if (!font) {
             return;
         }
@@ -269,7 +566,7 @@ namespace Gfx {
             // TODO figure out how to center this properly
             y += 5;
         } else {
-            effect.scale = FC_MakeScale(1, 1);
+            effect.scale = FC_MakeScale(fontScale, fontScale);
         }
 
         if (align & ALIGN_LEFT) {
@@ -289,69 +586,61 @@ namespace Gfx {
             y -= GetTextHeight(size, text, monospace) / 2;
         }
 
-        FC_DrawEffect(font, renderer, x, y, effect, "%s", text.c_str());
+        geometry.Flush(renderer);
+        textCache.Draw(renderer, font, x, y, effect, text);
     }
 
-    int GetTextWidth(int size, std::string text, bool monospace) {
-        FC_Font *font = monospace ? monospaceFont : GetFontForSize(size);
+    int GetTextWidth(int size, std::string_view text, bool monospace) {
+        float scale = 1.0f;
+        FC_Font *font = monospace ? monospaceFont : GetScaledFont(size, scale);
         if (!font) {
             return 0;
         }
 
-        float scale = monospace ? (size / 28.0f) : 1.0f;
+        if (monospace) {
+            scale = size / 28.0f;
+        }
 
-        return FC_GetWidth(font, "%s", text.c_str()) * scale;
+        return textCache.GetWidth(font, text) * scale;
     }
 
-    int GetTextHeight(int size, std::string text, bool monospace) {
+    int GetTextHeight(int size, std::string_view text, bool monospace) {
         // TODO this doesn't work nicely with monospace yet
         monospace = false;
 
-        FC_Font *font = monospace ? monospaceFont : GetFontForSize(size);
+        float scale = 1.0f;
+        FC_Font *font = monospace ? monospaceFont : GetScaledFont(size, scale);
         if (!font) {
             return 0;
         }
 
-        float scale = monospace ? (size / 28.0f) : 1.0f;
+        if (monospace) {
+            scale = size / 28.0f;
+        }
 
-        return FC_GetHeight(GetFontForSize(size), "%s", text.c_str()) * scale;
+        return textCache.GetHeight(font, text) * scale;
     }
 
     void DrawRectRounded(int x, int y, int w, int h, int radius, SDL_Color color) {
-        Uint8 finalAlpha = (Uint8)(color.a * globalAlpha);
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, finalAlpha);
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-
-        // Draw center rectangle
-        SDL_Rect centerRect = {x + radius, y, w - 2 * radius, h};
-        SDL_RenderFillRect(renderer, &centerRect);
-
-        // Draw left and right rectangles
-        SDL_Rect leftRect = {x, y + radius, radius, h - 2 * radius};
-        SDL_RenderFillRect(renderer, &leftRect);
-        SDL_Rect rightRect = {x + w - radius, y + radius, radius, h - 2 * radius};
-        SDL_RenderFillRect(renderer, &rightRect);
-
-        // Draw corners (approximated with filled rectangles)
-        for (int i = 0; i < radius; i++) {
-            int offset = radius - i;
-            int width = (int)(sqrt(radius * radius - offset * offset) + 0.5);
-            
-            // Top-left
-            SDL_Rect tlRect = {x + radius - width, y + i, width, 1};
-            SDL_RenderFillRect(renderer, &tlRect);
-            
-            // Top-right
-            SDL_Rect trRect = {x + w - radius, y + i, width, 1};
-            SDL_RenderFillRect(renderer, &trRect);
-            
-            // Bottom-left
-            SDL_Rect blRect = {x + radius - width, y + h - i - 1, width, 1};
-            SDL_RenderFillRect(renderer, &blRect);
-            
-            // Bottom-right
-            SDL_Rect brRect = {x + w - radius, y + h - i - 1, width, 1};
-            SDL_RenderFillRect(renderer, &brRect);
+        ProfileScope scope(FrameProfiler::STAGE_ROUNDED_RECT);
+        color.a = (Uint8)(color.a * globalAlpha);
+        radius = std::min(radius, std::min(w, h) / 2);
+        if (radius <= 0) {
+            geometry.AddRect(x, y, w, h, color);
+            return;
+        }
+        
+        const NineSliceCache::Slice *slice = nineSlices.Find(radius);
+        if (!slice && radius <= NineSliceCache::MAX_RADIUS) {
+            // adding may reset a full atlas, submit vertices that still point into it
+            geometry.Flush(renderer);
+            slice = nineSlices.Add(radius);
+        }
+        
+        if (slice) {
+            geometry.AddNineSlice(x, y, w, h, slice->rect, slice->radius, nineSlices.GetTextureSize(), color);
+        } else {
+            geometry.AddRoundedRect(x, y, w, h, radius, color);
         }
     }
 
@@ -368,35 +657,14 @@ namespace Gfx {
     }
 
     void DrawGradientV(int x, int y, int w, int h, SDL_Color colorTop, SDL_Color colorBottom) {
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-        
-        for (int i = 0; i < h; i++) {
-            float ratio = (float)i / (float)h;
-            SDL_Color color = {
-                (Uint8)(colorTop.r + (colorBottom.r - colorTop.r) * ratio),
-                (Uint8)(colorTop.g + (colorBottom.g - colorTop.g) * ratio),
-                (Uint8)(colorTop.b + (colorBottom.b - colorTop.b) * ratio),
-                (Uint8)((colorTop.a + (colorBottom.a - colorTop.a) * ratio) * globalAlpha)
-            };
-            
-            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-            SDL_RenderDrawLine(renderer, x, y + i, x + w, y + i);
-        }
+        colorTop.a = (Uint8)(colorTop.a * globalAlpha);
+        colorBottom.a = (Uint8)(colorBottom.a * globalAlpha);
+        geometry.AddGradientV(x, y, w, h, colorTop, colorBottom);
     }
 
     void DrawShadow(int x, int y, int w, int h, int blur) {
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-        
-        // Simple rectangular shadow for performance - keep original fast version
-        for (int i = 0; i < blur; i++) {
-            int alpha = (COLOR_SHADOW.a * (blur - i)) / blur;
-            SDL_Color shadowColor = COLOR_SHADOW;
-            shadowColor.a = alpha;
-            
-            SDL_SetRenderDrawColor(renderer, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
-            SDL_Rect shadowRect = {x - i, y - i, w + i * 2, h + i * 2};
-            SDL_RenderDrawRect(renderer, &shadowRect);
-        }
+        // alpha fades out over blur pixels outside the rect
+        geometry.AddShadowFrame(x, y, w, h, blur, COLOR_SHADOW);
     }
 
 } // namespace Gfx
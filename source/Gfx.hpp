@@ -2,6 +2,8 @@
 
 #include <SDL.h>
 #include <string>
+#include <string_view>
+#include <initializer_list>
 
 namespace Gfx {
     constexpr uint32_t SCREEN_WIDTH  = 1920;
@@ -49,6 +51,14 @@ namespace Gfx {
     void SetUseLatinFont(bool useLatin);  // Switch between Latin and CJK font
     
     bool GetUseLatinFont();  // Get current font setting
+    
+    // Rasterize the glyphs of text for the given sizes in the background (current font),
+    // so they are already cached when first drawn
+    void PrewarmGlyphs(std::string_view text, std::initializer_list<int> sizes);
+    
+    // Load a build-time glyph atlas (tools/glyphbake.cpp) as one texture; its text glyphs
+    // and icons are used instead of rasterizing them at runtime
+    bool LoadGlyphAtlas(const uint8_t *data, size_t size);
 
     void Clear(SDL_Color color);
 
@@ -78,9 +88,9 @@ namespace Gfx {
 
     static inline int GetIconHeight(int size, Uint16 icon) { return size; }
 
-    void Print(int x, int y, int size, SDL_Color color, std::string text, AlignFlags align = ALIGN_LEFT | ALIGN_TOP, bool monospace = false);
+    void Print(int x, int y, int size, SDL_Color color, std::string_view text, AlignFlags align = ALIGN_LEFT | ALIGN_TOP, bool monospace = false);
 
-    int GetTextWidth(int size, std::string text, bool monospace = false);
+    int GetTextWidth(int size, std::string_view text, bool monospace = false);
 
-    int GetTextHeight(int size, std::string text, bool monospace = false);
+    int GetTextHeight(int size, std::string_view text, bool monospace = false);
 } // namespace Gfx
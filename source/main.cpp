@@ -14,8 +14,12 @@
 #include "utils/SwkbdManager.hpp"
 #include "utils/RemoteNotification.hpp"
 #include "utils/DownloadQueue.hpp"
+#include "utils/FrameDamage.hpp"
+#include "utils/FrameProfiler.hpp"
 #include <coreinit/title.h>
 #include <coreinit/launch.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
 #include <memory>
 #include <padscore/kpad.h>
 #include <sndcore2/core.h>
@@ -148,18 +152,36 @@ int main(int argc, char const *argv[]) {
     bool shouldQuit = false;
     try {
         while (WHBProcIsRunning()) {
-            baseInput.reset();
-            if (vpadInput.update(1280, 720)) {
-                baseInput.combine(vpadInput);
-            }
-            for (auto &wpadInput : wpadInputs) {
-                if (wpadInput.update(1280, 720)) {
-                    baseInput.combine(wpadInput);
+            OSTime frameStart = OSGetSystemTime();
+            FrameProfiler& profiler = FrameProfiler::GetInstance();
+            profiler.BeginFrame();
+            
+            {
+                ProfileScope scope(FrameProfiler::STAGE_INPUT);
+                baseInput.reset();
+                if (vpadInput.update(1280, 720)) {
+                    baseInput.combine(vpadInput);
                 }
+                for (auto &wpadInput : wpadInputs) {
+                    if (wpadInput.update(1280, 720)) {
+                        baseInput.combine(wpadInput);
+                    }
+                }
+                baseInput.process();
+            }
+            
+            // 有按键或触摸时画面可能变化
+            if (baseInput.data.buttons_h || baseInput.data.buttons_d || baseInput.data.buttons_r ||
+                baseInput.data.touched || baseInput.lastData.touched) {
+                FrameDamage::Mark();
             }
-            baseInput.process();
 
-            if (!mainScreen->Update(baseInput)) {
+            bool keepRunning;
+            {
+                ProfileScope scope(FrameProfiler::STAGE_UPDATE);
+                keepRunning = mainScreen->Update(baseInput);
+            }
+            if (!keepRunning) {
                 // screen requested quit
                 shouldQuit = true;
                 break;
@@ -167,24 +189,56 @@ int main(int argc, char const *argv[]) {
             
             // Process download queue (for RemoteNotification, BgmDownloader, etc.)
             if (DownloadQueue::GetInstance()) {
+                ProfileScope scope(FrameProfiler::STAGE_DOWNLOAD_QUEUE);
                 DownloadQueue::GetInstance()->Process();
             }
             
+            // Upload images decoded by the worker threads
+            {
+                ProfileScope scope(FrameProfiler::STAGE_IMAGE_UPLOAD);
+                ImageLoader::UploadDecoded();
+            }
+            
             // Update BGM downloader
-            BgmDownloader::GetInstance().Update();
+            {
+                ProfileScope scope(FrameProfiler::STAGE_BGM_DOWNLOADER);
+                BgmDownloader::GetInstance().Update();
+            }
             
             // Update music player
-            MusicPlayer::GetInstance().Update();
+            {
+                ProfileScope scope(FrameProfiler::STAGE_MUSIC);
+                MusicPlayer::GetInstance().Update();
+            }
             
             // Update BGM notification
             Screen::UpdateBgmNotification();
 
-            mainScreen->Draw();
+            if (!FrameDamage::BeginFrame()) {
+                // 画面没有变化: 不绘制也不 present, 没有 vsync 等待, 自行休眠到下一帧
+                OSTime elapsed = OSGetSystemTime() - frameStart;
+                OSTime frameTicks = OSNanosecondsToTicks(1000000000ll / 60);
+                if (elapsed < frameTicks) {
+                    OSSleepTicks(frameTicks - elapsed);
+                }
+                continue;
+            }
             
-            // Draw BGM notification on top
-            Screen::DrawBgmNotification();
+            profiler.SetFrameDrawn();
+            {
+                ProfileScope scope(FrameProfiler::STAGE_DRAW);
+                mainScreen->Draw();
+                
+                // Draw BGM notification on top
+                Screen::DrawBgmNotification();
+            }
+            
+            profiler.DrawOverlay();
             
-            Gfx::Render();
+            {
+                ProfileScope scope(FrameProfiler::STAGE_RENDER);
+                Gfx::Render();
+            }
         }
     } catch (const std::exception& e) {
         FileLogger::GetInstance().LogError("Fatal exception in main loop: %s", e.what());
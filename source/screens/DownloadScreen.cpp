@@ -8,7 +8,10 @@
 #include "../utils/Utils.hpp"
 #include "../utils/logger.h"
 #include "../utils/FileLogger.hpp"
+#include "../utils/FrameDamage.hpp"
+#include "../utils/ThumbnailStore.hpp"
 #include "../utils/ThemePatcher.hpp"
+#include "../utils/InstalledThemeIndex.hpp"
 #include "../utils/SwkbdManager.hpp"
 #include "../input/CombinedInput.h"
 #include "../input/VPADInput.h"
@@ -50,6 +53,7 @@ DownloadScreen::DownloadScreen() {
                 mState = STATE_SHOW_THEMES;
                 mLoadedThemeCount = mThemeManager->GetThemes().size();
                 InitAnimations(mLoadedThemeCount);
+                RefreshCatalogView();
                 break;
             case ThemeManager::FETCH_ERROR:
                 mState = STATE_ERROR;
@@ -60,6 +64,20 @@ DownloadScreen::DownloadScreen() {
         }
     });
     
+    // 增量同步合并后主题下标可能变化, 重建动画和搜索结果
+    mThemeManager->SetSyncCallback([this](size_t added, size_t changed, size_t removed) {
+        FileLogger::GetInstance().LogInfo("Theme list synced: +%zu ~%zu -%zu", added, changed, removed);
+        mLoadedThemeCount = mThemeManager->GetThemes().size();
+        InitAnimations(mLoadedThemeCount);
+        RefreshCatalogView();
+        
+        int count = (int)GetDisplayCount();
+        if (mSelectedTheme >= count) {
+            mSelectedTheme = count > 0 ? count - 1 : 0;
+        }
+        mPrevSelectedTheme = -1;
+    });
+    
     // 立即显示加载动画，延迟所有阻塞操作到第一帧Update
     mState = STATE_INIT;
     
@@ -199,7 +217,8 @@ void DownloadScreen::Draw() {
             // 进度条背景
             Gfx::DrawRectRounded(barX, barY, barW, barH, 20, Gfx::COLOR_ALT_BACKGROUND);
             
-            // 计算实际进度
+            // 计算实际进度 (按帧推进, 保持重绘)
+            FrameDamage::Mark();
             int elapsedFrames = mFrameCount - mDownloadStartFrame;
             float progress = std::min(elapsedFrames / 120.0f, 1.0f);
             int progressW = (int)(barW * progress);
@@ -260,6 +279,8 @@ void DownloadScreen::Draw() {
         std::string middleHint = std::string("\ue000 ") + _("download.download") + " | \ue002 " + _("download.local_install") + " | \ue003 " + _("download.refresh");
         
         // 如果检测到更新,添加提示
+        middleHint += std::string(" | \ue083/\ue084 ") + _("download.sort_label") + ": " + _(LangKey(ThemeCatalogView::GetSortLabelKey(mCatalogView.GetSortOrder())));
+        
         if (mThemeManager->HasUpdates()) {
             middleHint += " | " + std::string(_("download.update_available"));
         }
@@ -333,7 +354,7 @@ bool DownloadScreen::Update(Input &input) {
             std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(),
             cacheValid ? "true" : "false");
         
-        if (cacheValid) {
+        if (cacheValid || (cacheLoaded && mThemeManager->GetThemes().size() >= 50)) {
             // 缓存有效，显示主题列表
             mState = STATE_SHOW_THEMES;
             mLoadedThemeCount = mThemeManager->GetThemes().size();
@@ -345,14 +366,17 @@ bool DownloadScreen::Update(Input &input) {
                 std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(),
                 mLoadedThemeCount);
             
+            RefreshCatalogView();
+            
             // 如果缓存主题数量少于50个，自动刷新
             if (mLoadedThemeCount < 50) {
                 FileLogger::GetInstance().LogInfo("  Cache has only %zu themes, triggering refresh", mLoadedThemeCount);
                 mState = STATE_LOADING;
                 mThemeManager->FetchThemes();
+            } else {
+                // 先显示缓存, 后台异步增量同步 (过期缓存也走增量同步)
+                mThemeManager->CheckForUpdates();
             }
-            // 注意：CheckForUpdates() 会阻塞22秒，移除以避免卡顿
-            // 用户可以手动按Y键刷新来检查更新
         } else {
             // 缓存无效，从网络获取
             FileLogger::GetInstance().LogInfo("  Cache invalid, fetching from network");
@@ -395,11 +419,24 @@ bool DownloadScreen::Update(Input &input) {
         
         // Y键刷新主题列表
         if (input.data.buttons_d & Input::BUTTON_Y) {
+            // 同时完整重新扫描本地主题, 发现从电脑复制到 SD 卡的主题
+            InstalledThemeIndex::GetInstance().Rescan();
+            ScanInstalledThemes();
             mState = STATE_LOADING;
             mThemeManager->ForceRefresh();
             return true;
         }
         
+        // L/R键切换排序方式
+        if (input.data.buttons_d & Input::BUTTON_L) {
+            CycleSortOrder(-1);
+            return true;
+        }
+        if (input.data.buttons_d & Input::BUTTON_R) {
+            CycleSortOrder(1);
+            return true;
+        }
+        
         // X键进入本地安装
         if (input.data.buttons_d & Input::BUTTON_X) {
             FileLogger::GetInstance().LogInfo("Opening LocalInstallScreen from DownloadScreen");
@@ -484,8 +521,7 @@ bool DownloadScreen::Update(Input &input) {
                     // 点击了清除按钮
                     FileLogger::GetInstance().LogInfo("Clearing search filter");
                     mSearchText.clear();
-                    mSearchActive = false;
-                    mFilteredIndices.clear();
+                    ApplySearch();
                     mSelectedTheme = 0;
                     mScrollOffset = 0;
                     return true;
@@ -508,13 +544,13 @@ bool DownloadScreen::Update(Input &input) {
             const int visibleCount = 3;
             
             // 确定显示的主题数量（搜索状态下为过滤结果，否则为全部）
-            size_t displayCount = mSearchActive ? mFilteredIndices.size() : themes.size();
+            size_t displayCount = GetDisplayCount();
             
             // 检查点击了哪个主题卡片
             for (int i = 0; i < visibleCount && (mScrollOffset + i) < (int)displayCount; i++) {
                 int themeIndex = mScrollOffset + i;
                 // 获取实际主题索引（搜索状态下需要从过滤列表映射）
-                size_t realIndex = mSearchActive ? mFilteredIndices[themeIndex] : themeIndex;
+                size_t realIndex = GetDisplayIndex(themeIndex);
                 
                 int cardX = listX;
                 int cardY = listY + i * (cardH + spacing);
@@ -635,7 +671,7 @@ bool DownloadScreen::Update(Input &input) {
         }
         
         // 上下选择(支持循环)
-        const int themeCount = mSearchActive ? (int)mFilteredIndices.size() : (int)themes.size();
+        const int themeCount = (int)GetDisplayCount();
         if (shouldMoveUp) {
             if (mSelectedTheme > 0) {
                 mSelectedTheme--;
@@ -669,12 +705,12 @@ bool DownloadScreen::Update(Input &input) {
             int realPrevIndex = mPrevSelectedTheme;
             int realCurrentIndex = mSelectedTheme;
             
-            if (mSearchActive && !mFilteredIndices.empty()) {
-                if (mPrevSelectedTheme >= 0 && mPrevSelectedTheme < (int)mFilteredIndices.size()) {
-                    realPrevIndex = mFilteredIndices[mPrevSelectedTheme];
+            if (mDisplayIndices && !mDisplayIndices->empty()) {
+                if (mPrevSelectedTheme >= 0 && mPrevSelectedTheme < (int)mDisplayIndices->size()) {
+                    realPrevIndex = (*mDisplayIndices)[mPrevSelectedTheme];
                 }
-                if (mSelectedTheme >= 0 && mSelectedTheme < (int)mFilteredIndices.size()) {
-                    realCurrentIndex = mFilteredIndices[mSelectedTheme];
+                if (mSelectedTheme >= 0 && mSelectedTheme < (int)mDisplayIndices->size()) {
+                    realCurrentIndex = (*mDisplayIndices)[mSelectedTheme];
                 }
             }
             
@@ -693,10 +729,10 @@ bool DownloadScreen::Update(Input &input) {
         
         // A键打开主题详情
         if (input.data.buttons_d & Input::BUTTON_A) {
-            size_t displayCount = mSearchActive ? mFilteredIndices.size() : themes.size();
+            size_t displayCount = GetDisplayCount();
             if (mSelectedTheme < (int)displayCount) {
-                // 获取实际主题索引（搜索状态下需要从过滤列表映射）
-                size_t realIndex = mSearchActive ? mFilteredIndices[mSelectedTheme] : mSelectedTheme;
+                // 获取实际主题索引（搜索/排序状态下需要从视图映射）
+                size_t realIndex = GetDisplayIndex(mSelectedTheme);
                 
                 // 创建详情屏幕（使用真实索引）
                 mDetailScreen = new ThemeDetailScreen(&themes[realIndex], mThemeManager.get());
@@ -802,11 +838,10 @@ void DownloadScreen::DrawThemeList() {
     }
     
     // 使用过滤后的主题列表
-    const std::vector<size_t>* displayIndices = &mFilteredIndices;
-    size_t displayCount = mSearchActive ? mFilteredIndices.size() : allThemes.size();
+    size_t displayCount = GetDisplayCount();
     
     // 如果搜索结果为空
-    if (mSearchActive && mFilteredIndices.empty()) {
+    if (mSearchActive && displayCount == 0) {
         const int cardW = 800;
         const int cardH = 300;
         const int cardX = (Gfx::SCREEN_WIDTH - cardW) / 2;
@@ -833,16 +868,40 @@ void DownloadScreen::DrawThemeList() {
     int currentY = listY;
     int endIndex = std::min(mScrollOffset + visibleCount, (int)displayCount);
     
+    std::vector<std::string> visibleThumbs;
+    for (int i = mScrollOffset; i < endIndex; i++) {
+        visibleThumbs.push_back(allThemes[GetDisplayIndex(i)].collagePreview.thumbUrl);
+    }
+    mVisibleThumbs.Update(visibleThumbs);
+    
     for (int i = mScrollOffset; i < endIndex; i++) {
         bool selected = (i == mSelectedTheme);
         // 获取实际主题索引
-        size_t realIndex = mSearchActive ? mFilteredIndices[i] : i;
+        size_t realIndex = GetDisplayIndex(i);
         // 需要非 const 访问来修改缩略图状态
         auto& themesVec = const_cast<std::vector<Theme>&>(allThemes);
         DrawThemeCard(listX, currentY, cardW, cardH, themesVec[realIndex], selected, realIndex);
         currentY += cardH + cardSpacing;
     }
     
+    // 用于对比缩略图存储命中前后的列表打开速度
+    if (!mListOpenLogged && endIndex > mScrollOffset) {
+        if (mListOpenStart == 0) {
+            mListOpenStart = OSGetSystemTime();
+        }
+        bool ready = true;
+        for (int i = mScrollOffset; i < endIndex && ready; i++) {
+            const auto& preview = allThemes[GetDisplayIndex(i)].collagePreview;
+            ready = preview.thumbUrl.empty() || preview.thumbTexture;
+        }
+        if (ready) {
+            mListOpenLogged = true;
+            FileLogger::GetInstance().LogInfo("[Perf] Theme list thumbnails ready in %.1f ms (thumb store hits %u, misses %u)",
+                OSTicksToMicroseconds(OSGetSystemTime() - mListOpenStart) / 1000.0f,
+                ThumbnailStore::GetInstance().GetHits(), ThumbnailStore::GetInstance().GetMisses());
+        }
+    }
+    
     // 绘制滚动指示器
     if (displayCount > visibleCount) {
         char scrollInfo[32];
@@ -861,6 +920,10 @@ void DownloadScreen::DrawThemeCard(int x, int y, int w, int h, Theme& theme, boo
         highlight = mThemeAnims[themeIndex].highlightAnim.GetValue();
     }
     
+    // 缩略图解码尺寸 (不随选中动画变化, 保证与 ThumbnailStore 中的缓存尺寸一致)
+    const int decodeH = h - 40;
+    const int decodeW = (int)(decodeH * 16.0f / 9.0f);
+    
     // 应用缩放
     int scaledW = (int)(w * scale);
     int scaledH = (int)(h * scale);
@@ -901,14 +964,21 @@ void DownloadScreen::DrawThemeCard(int x, int y, int w, int h, Theme& theme, boo
     const int thumbX = x + 20;
     const int thumbY = y + 20;
     
+    // 离开可见范围期间纹理可能已被缓存淘汰, 重新加载
+    if (theme.collagePreview.thumbTexture &&
+        !ImageLoader::IsCached(theme.collagePreview.thumbUrl, theme.collagePreview.thumbTexture)) {
+        theme.collagePreview.thumbTexture = nullptr;
+        theme.collagePreview.thumbLoaded = false;
+    }
+    
     // 绘制缩略图
     if (theme.collagePreview.thumbTexture) {
         // 已加载,绘制纹理
         SDL_Rect dstRect = {thumbX, thumbY, thumbW, thumbH};
         
-        // 获取纹理尺寸
-        int texW, texH;
-        SDL_QueryTexture(theme.collagePreview.thumbTexture, nullptr, nullptr, &texW, &texH);
+        // 获取图片尺寸 (缩略图在图集中时只是其中一块)
+        SDL_Rect srcRect = ImageLoader::GetSourceRect(theme.collagePreview.thumbUrl, theme.collagePreview.thumbTexture);
+        int texW = srcRect.w, texH = srcRect.h;
         
         // 计算缩放以保持纵横比
         float scale = std::min((float)thumbW / texW, (float)thumbH / texH);
@@ -925,7 +995,7 @@ void DownloadScreen::DrawThemeCard(int x, int y, int w, int h, Theme& theme, boo
         Gfx::DrawRectFilled(thumbX, thumbY, thumbW, thumbH, Gfx::COLOR_ALT_BACKGROUND);
         
         // 绘制纹理
-        SDL_RenderCopy(Gfx::GetRenderer(), theme.collagePreview.thumbTexture, nullptr, &dstRect);
+        SDL_RenderCopy(Gfx::GetRenderer(), theme.collagePreview.thumbTexture, &srcRect, &dstRect);
         
     } else if (!theme.collagePreview.thumbUrl.empty() && !theme.collagePreview.thumbLoaded) {
         // 还未加载,显示占位符并异步加载
@@ -946,14 +1016,23 @@ void DownloadScreen::DrawThemeCard(int x, int y, int w, int h, Theme& theme, boo
         ImageLoader::LoadRequest request;
         request.url = theme.collagePreview.thumbUrl;
         request.highPriority = selected; // 选中的优先加载
-        request.callback = [this, themeIndex](SDL_Texture* texture) {
-            // 通过索引访问主题,避免引用失效
+        // 按未缩放卡片中的显示尺寸解码
+        request.targetWidth = decodeW;
+        request.targetHeight = decodeH;
+        request.thumbnail = true;
+        request.callback = [this, alive = std::weak_ptr<bool>(mAlive), themeId = theme.id](SDL_Texture* texture) {
+            // 解码在工作线程完成, 回调可能在界面销毁之后才执行
+            if (alive.expired()) {
+                return;
+            }
+            // 通过 uuid 查找主题,增量同步后下标可能已变化
             if (!mThemeManager) {
                 DEBUG_FUNCTION_LINE("ThemeManager is null in callback!");
                 return;
             }
             
             auto& themes = mThemeManager->GetThemes();
+            int themeIndex = mThemeManager->FindThemeIndex(themeId);
             if (themeIndex >= 0 && themeIndex < (int)themes.size()) {
                 themes[themeIndex].collagePreview.thumbTexture = texture;
                 DEBUG_FUNCTION_LINE("Set texture for theme %d: %p", themeIndex, texture);
@@ -1038,28 +1117,11 @@ void DownloadScreen::DrawThemeCard(int x, int y, int w, int h, Theme& theme, boo
     }
 }
 
-// 扫描已安装的主题
+// 扫描已安装的主题 (读取已安装主题索引, 目录未变化时不扫描)
 void DownloadScreen::ScanInstalledThemes() {
-    mInstalledThemeIds.clear();
-    
-    const char* installedDir = "fs:/vol/external01/UTheme/installed";
-    DIR* dir = opendir(installedDir);
-    if (!dir) {
-        FileLogger::GetInstance().LogInfo("DownloadScreen: installed directory not found");
-        return;
-    }
-    
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string filename = entry->d_name;
-        // 检查是否是 .json 文件
-        if (filename.length() > 5 && filename.substr(filename.length() - 5) == ".json") {
-            // 提取主题ID (去掉 .json 后缀)
-            std::string themeId = filename.substr(0, filename.length() - 5);
-            mInstalledThemeIds.insert(themeId);
-        }
-    }
-    closedir(dir);
+    InstalledThemeIndex& index = InstalledThemeIndex::GetInstance();
+    index.Load();
+    mInstalledThemeIds = index.GetInstalledIds();
     
     FileLogger::GetInstance().LogInfo("DownloadScreen: Found %zu installed themes", mInstalledThemeIds.size());
 }
@@ -1104,7 +1166,7 @@ void DownloadScreen::DrawSearchBox() {
     // 显示搜索结果计数
     if (mSearchActive && !mSearchText.empty()) {
         char countText[64];
-        snprintf(countText, sizeof(countText), "%zu %s", mFilteredIndices.size(), _("download.search_results").c_str());
+        snprintf(countText, sizeof(countText), "%zu %s", GetDisplayCount(), _("download.search_results").c_str());
         Gfx::Print(boxX + boxW + 30, boxY + boxH/2, 28, Gfx::COLOR_ALT_TEXT, countText, Gfx::ALIGN_VERTICAL);
     }
     
@@ -1149,75 +1211,121 @@ void DownloadScreen::ShowKeyboard() {
 
 void DownloadScreen::ApplySearch() {
     mFilteredIndices.clear();
+    mDisplayIndices = nullptr;
+    mSearchActive = !mSearchText.empty();
+    
+    // 拆分搜索文本: "#标签" 作为标签筛选, 其余部分作为搜索关键词
+    std::vector<std::string> tags;
+    std::string query;
+    size_t pos = 0;
+    while (pos < mSearchText.size()) {
+        size_t end = mSearchText.find(' ', pos);
+        if (end == std::string::npos) {
+            end = mSearchText.size();
+        }
+        std::string token = mSearchText.substr(pos, end - pos);
+        pos = end + 1;
+        
+        if (token.size() > 1 && token[0] == '#') {
+            tags.push_back(token.substr(1));
+        } else if (!token.empty()) {
+            if (!query.empty()) {
+                query += ' ';
+            }
+            query += token;
+        }
+    }
+    mCatalogView.SetActiveTags(tags);
     
-    if (mSearchText.empty()) {
-        mSearchActive = false;
+    if (query.empty()) {
+        // 只有排序/标签: 直接使用预先计算的视图, 不复制下标
+        if (!mCatalogView.IsIdentity()) {
+            mDisplayIndices = &mCatalogView.GetOrder();
+        }
         return;
     }
     
-    mSearchActive = true;
-    const auto& themes = mThemeManager->GetThemes();
+    // 通过索引做容错排序搜索 (名称/作者/标签 + T<ID>), 结果按相关度排列, 索引在主题列表加载时建立
+    // 返回全部匹配结果, 不截断
+    auto t1 = std::chrono::steady_clock::now();
+    const ThemeSearchIndex& searchIndex = mThemeManager->GetSearchIndex();
+    std::vector<size_t> results = searchIndex.SearchRanked(query, searchIndex.GetDocumentCount());
+    for (size_t index : results) {
+        if (mCatalogView.Matches(index)) {
+            mFilteredIndices.push_back(index);
+        }
+    }
     
-    // 转换搜索文本为小写
-    std::string searchLower = mSearchText;
-    std::transform(searchLower.begin(), searchLower.end(), searchLower.begin(), ::tolower);
-    
-    // 检查是否是 T+ID 格式搜索
-    bool isIdSearch = false;
-    std::string searchId;
-    if (searchLower.length() >= 2 && searchLower[0] == 't') {
-        // 提取 T 后面的内容作为 ID
-        searchId = searchLower.substr(1);
-        isIdSearch = true;
-        FileLogger::GetInstance().LogInfo("[ApplySearch] ID search mode: T%s", searchId.c_str());
+    // 选择了排序方式时按该排序显示, 默认按相关度
+    if (mCatalogView.GetSortOrder() != ThemeCatalogView::SORT_DEFAULT) {
+        mCatalogView.SortByView(mFilteredIndices);
     }
+    mDisplayIndices = &mFilteredIndices;
+    auto t2 = std::chrono::steady_clock::now();
     
-    for (size_t i = 0; i < themes.size(); ++i) {
-        const auto& theme = themes[i];
-        
-        // 如果是 ID 搜索模式（T+ID）
-        if (isIdSearch && !theme.shortId.empty()) {
-            std::string shortIdLower = theme.shortId;
-            std::transform(shortIdLower.begin(), shortIdLower.end(), shortIdLower.begin(), ::tolower);
-            
-            // 完全匹配（例如 T1 只匹配 T1，不匹配 T123）
-            if (shortIdLower == searchId) {
-                FileLogger::GetInstance().LogInfo("[ApplySearch] Matched ID: %s (theme: %s)", 
-                                                  theme.shortId.c_str(), theme.name.c_str());
-                mFilteredIndices.push_back(i);
-                continue;
-            }
-        }
-        
-        // 普通搜索：名称
-        std::string nameLower = theme.name;
-        std::transform(nameLower.begin(), nameLower.end(), nameLower.begin(), ::tolower);
-        if (nameLower.find(searchLower) != std::string::npos) {
-            mFilteredIndices.push_back(i);
-            continue;
-        }
-        
-        // 搜索作者
-        std::string authorLower = theme.author;
-        std::transform(authorLower.begin(), authorLower.end(), authorLower.begin(), ::tolower);
-        if (authorLower.find(searchLower) != std::string::npos) {
-            mFilteredIndices.push_back(i);
+    FileLogger::GetInstance().LogInfo("[ApplySearch] Search '%s' (%zu tags) matched %zu themes [%lldus]", 
+                                      query.c_str(), tags.size(), mFilteredIndices.size(),
+                                      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+void DownloadScreen::RefreshCatalogView() {
+    mCatalogView.Rebuild(mThemeManager->GetThemes());
+    ApplySearch();
+    PrewarmThemeGlyphs();
+}
+
+void DownloadScreen::PrewarmThemeGlyphs() {
+    // 按当前显示顺序收集卡片上的文字 (名称 42 / 作者 32 / 描述首行 26), 靠前的主题先预热
+    const auto& themes = mThemeManager->GetThemes();
+    std::string names;
+    std::string authors;
+    std::string descs;
+    
+    for (size_t pos = 0; pos < GetDisplayCount(); pos++) {
+        size_t index = GetDisplayIndex(pos);
+        if (index >= themes.size()) {
             continue;
         }
-        
-        // 搜索标签
-        for (const auto& tag : theme.tags) {
-            std::string tagLower = tag;
-            std::transform(tagLower.begin(), tagLower.end(), tagLower.begin(), ::tolower);
-            if (tagLower.find(searchLower) != std::string::npos) {
-                mFilteredIndices.push_back(i);
-                break;
-            }
+        const Theme& theme = themes[index];
+        names += theme.name;
+        authors += theme.author;
+        descs.append(theme.description, 0, theme.description.find('\n'));
+    }
+    
+    Gfx::PrewarmGlyphs(names, {42});
+    Gfx::PrewarmGlyphs(authors, {32});
+    Gfx::PrewarmGlyphs(descs, {26});
+}
+
+void DownloadScreen::CycleSortOrder(int direction) {
+    // 取消旧选中项的高亮 (切换后同一显示位置对应的主题会变)
+    if (mSelectedTheme >= 0 && mSelectedTheme < (int)GetDisplayCount()) {
+        size_t realIndex = GetDisplayIndex(mSelectedTheme);
+        if (realIndex < mThemeAnims.size()) {
+            mThemeAnims[realIndex].scaleAnim.SetTarget(1.0f, 300);
+            mThemeAnims[realIndex].highlightAnim.SetTarget(0.0f, 300);
         }
     }
     
-    FileLogger::GetInstance().LogInfo("[ApplySearch] Search '%s' matched %zu themes", 
-                                      mSearchText.c_str(), mFilteredIndices.size());
+    int order = ((int)mCatalogView.GetSortOrder() + direction + ThemeCatalogView::SORT_COUNT) % ThemeCatalogView::SORT_COUNT;
+    mCatalogView.SetSortOrder((ThemeCatalogView::SortOrder)order);
+    ApplySearch();
+    
+    FileLogger::GetInstance().LogInfo("[CycleSortOrder] Sort order: %s (%zu themes)",
+                                      ThemeCatalogView::GetSortLabelKey(mCatalogView.GetSortOrder()), GetDisplayCount());
+    
+    // 回到列表顶部, 由 Update 高亮新的选中项
+    mSelectedTheme = 0;
+    mScrollOffset = 0;
+    mPrevSelectedTheme = -1;
+}
+
+size_t DownloadScreen::GetDisplayCount() const {
+    return mDisplayIndices ? mDisplayIndices->size() : mThemeManager->GetThemes().size();
+}
+
+size_t DownloadScreen::GetDisplayIndex(size_t pos) const {
+    return mDisplayIndices ? (*mDisplayIndices)[pos] : pos;
 }
 
 void DownloadScreen::SelectRandomTheme() {
@@ -1232,7 +1340,7 @@ void DownloadScreen::SelectRandomTheme() {
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
     
     // 从当前显示的主题中随机选择
-    size_t displayCount = mSearchActive ? mFilteredIndices.size() : themes.size();
+    size_t displayCount = GetDisplayCount();
     
     if (displayCount == 0) {
         FileLogger::GetInstance().LogInfo("[SelectRandomTheme] No themes to select from");
@@ -1271,10 +1379,9 @@ void DownloadScreen::SelectRandomTheme() {
         if (mScrollOffset > maxOffset) mScrollOffset = maxOffset;
         
         // 更新动画状态
-        size_t realPrevIndex = mSearchActive && prevSelected >= 0 && prevSelected < (int)mFilteredIndices.size() 
-                               ? mFilteredIndices[prevSelected] : prevSelected;
-        size_t realCurrentIndex = mSearchActive && mSelectedTheme >= 0 && mSelectedTheme < (int)mFilteredIndices.size()
-                                  ? mFilteredIndices[mSelectedTheme] : mSelectedTheme;
+        size_t realPrevIndex = prevSelected >= 0 && prevSelected < (int)displayCount 
+                               ? GetDisplayIndex(prevSelected) : prevSelected;
+        size_t realCurrentIndex = GetDisplayIndex(mSelectedTheme);
         
         if (realPrevIndex >= 0 && realPrevIndex < (int)mThemeAnims.size()) {
             mThemeAnims[realPrevIndex].scaleAnim.SetImmediate(1.0f);
@@ -1326,10 +1433,9 @@ void DownloadScreen::SelectRandomTheme() {
     if (mScrollOffset > maxOffset) mScrollOffset = maxOffset;
     
     // 更新最终动画
-    size_t realPrevIndex = mSearchActive && prevSelected >= 0 && prevSelected < (int)mFilteredIndices.size() 
-                           ? mFilteredIndices[prevSelected] : prevSelected;
-    size_t realCurrentIndex = mSearchActive && mSelectedTheme >= 0 && mSelectedTheme < (int)mFilteredIndices.size()
-                              ? mFilteredIndices[mSelectedTheme] : mSelectedTheme;
+    size_t realPrevIndex = prevSelected >= 0 && prevSelected < (int)displayCount 
+                           ? GetDisplayIndex(prevSelected) : prevSelected;
+    size_t realCurrentIndex = GetDisplayIndex(mSelectedTheme);
     
     if (realPrevIndex >= 0 && realPrevIndex < (int)mThemeAnims.size()) {
         mThemeAnims[realPrevIndex].scaleAnim.SetTarget(1.0f, 300);
@@ -1359,7 +1465,7 @@ void DownloadScreen::SelectRandomTheme() {
     }
     
     // 获取真实的主题索引
-    size_t realIndex = mSearchActive ? mFilteredIndices[finalRandomIndex] : finalRandomIndex;
+    size_t realIndex = GetDisplayIndex(finalRandomIndex);
     
     FileLogger::GetInstance().LogInfo("[SelectRandomTheme] Opening theme %zu (display index: %d, display count: %zu)", 
                                       realIndex, finalRandomIndex, displayCount);
@@ -2,10 +2,13 @@
 #include "Screen.hpp"
 #include "../utils/Animation.hpp"
 #include "../utils/ThemeManager.hpp"
+#include "../utils/ThemeCatalogView.hpp"
+#include "../utils/ImageLoader.hpp"
 #include <memory>
 #include <set>
 #include <string>
 #include <nn/swkbd.h>
+#include <coreinit/time.h>
 
 class DownloadScreen : public Screen {
 public:
@@ -56,9 +59,23 @@ private:
     std::vector<size_t> mFilteredIndices;  // 过滤后的主题索引
     bool mSearchActive = false;  // 是否正在使用搜索
     
+    // 排序/标签视图 (L/R 切换排序, 搜索框中输入 #标签 筛选)
+    ThemeCatalogView mCatalogView;
+    const std::vector<size_t>* mDisplayIndices = nullptr;  // 当前显示的主题下标, nullptr 表示原始顺序
+    
     // 详情屏幕
     class ThemeDetailScreen* mDetailScreen = nullptr;
     
+    // 可见卡片的缩略图, 固定在纹理缓存中
+    TexturePinSet mVisibleThumbs;
+    
+    // 图片加载回调持有 weak_ptr, 界面销毁后回调不再访问界面
+    std::shared_ptr<bool> mAlive = std::make_shared<bool>(true);
+    
+    // 列表打开耗时: 第一次绘制列表到可见卡片的缩略图全部显示, 写入日志
+    OSTime mListOpenStart = 0;
+    bool mListOpenLogged = false;
+    
     // 主题卡片动画
     struct ThemeCardAnim {
         Animation scaleAnim;
@@ -84,6 +101,11 @@ private:
     void DrawSearchBox();
     void ShowKeyboard();
     void ApplySearch();
+    void RefreshCatalogView();  // 主题列表变化后重建排序/标签视图
+    void PrewarmThemeGlyphs();  // 后台预先光栅化主题卡片上的字形
+    void CycleSortOrder(int direction);
+    size_t GetDisplayCount() const;
+    size_t GetDisplayIndex(size_t pos) const;  // 显示位置 -> 主题下标
     void SelectRandomTheme();  // 随机选择主题
     const std::vector<Theme>& GetDisplayThemes();
     
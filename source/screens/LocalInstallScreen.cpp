@@ -3,6 +3,7 @@
 #include "../utils/LanguageManager.hpp"
 #include "../utils/FileLogger.hpp"
 #include "../utils/ThemePatcher.hpp"
+#include "../utils/InstalledThemeIndex.hpp"
 #include "../utils/Utils.hpp"
 #include "../utils/minizip/unzip.h"
 #include <dirent.h>
@@ -897,6 +898,7 @@ void LocalInstallScreen::PerformInstall() {
         }
         
         FileLogger::GetInstance().LogInfo("Old theme version removed successfully");
+        InstalledThemeIndex::GetInstance().RemoveFolder(themeId);
     }
     
     // 创建主题目录
@@ -1020,6 +1022,9 @@ void LocalInstallScreen::PerformInstall() {
         FileLogger::GetInstance().LogWarning("Failed to create theme_info.json (non-critical)");
     }
     
+    // 记录到已安装主题索引; SD 卡 (FAT) 上 wiiu/themes 的修改时间不一定变化, 不能依赖校验发现新目录
+    InstalledThemeIndex::GetInstance().RefreshFolder(themeId);
+    
     mInstallProgress = 0.6f;
     
     // 现在安装解压后的主题(应用BPS补丁)
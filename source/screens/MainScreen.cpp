@@ -6,6 +6,7 @@
 #include "../utils/Config.hpp"
 #include "../utils/PluginDownloader.hpp"
 #include "../utils/FileLogger.hpp"
+#include "../utils/FrameDamage.hpp"
 #include <mocha/mocha.h>
 #include <utility>
 #include <cmath>
@@ -24,6 +25,9 @@ void MainScreen::DrawLoadingSpinner(int x, int y, int size, float progress) {
     const int numDots = 8;
     const float radius = size / 2.0f;
     
+    // 旋转动画, 下一帧也需要绘制
+    FrameDamage::Mark();
+    
     for (int i = 0; i < numDots; i++) {
         float angle = (progress * 2.0f * M_PI) + (i * 2.0f * M_PI / numDots);
         int dotX = x + (int)(cos(angle) * radius);
@@ -210,7 +214,8 @@ void MainScreen::Draw() {
                 Gfx::Print(cardX + cardW/2, cardY + 300, 28, Gfx::COLOR_ALT_TEXT, 
                           _("common.other_features_available"), Gfx::ALIGN_CENTER);
                           
-                // 显示继续提示
+                // 显示继续提示 (闪烁)
+                FrameDamage::Mark();
                 if ((mFrameCount / 30) % 2 == 0) {
                     Gfx::Print(cardX + cardW/2, cardY + 350, 32, Gfx::COLOR_ACCENT, 
                               _("common.press_a_continue"), Gfx::ALIGN_CENTER);
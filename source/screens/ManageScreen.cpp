@@ -8,14 +8,13 @@
 #include "../utils/FileLogger.hpp"
 #include "../utils/ImageLoader.hpp"
 #include "../utils/ThemePatcher.hpp"
+#include "../utils/InstalledThemeIndex.hpp"
 #include "../utils/Utils.hpp"
 #include "../utils/SwkbdManager.hpp"
-#include "rapidjson/document.h"
 #include "../input/CombinedInput.h"
 #include "../input/VPADInput.h"
 #include "../input/WPADInput.h"
 #include <SDL2/SDL_image.h>
-#include <dirent.h>
 #include <sys/stat.h>
 #include <chrono>
 #include <thread>
@@ -62,13 +61,8 @@ ManageScreen::~ManageScreen() {
         FileLogger::GetInstance().LogInfo("Warning: ManageScreen destroyed while still loading themes");
     }
     
-    // 释放纹理
-    for (auto& theme : mThemes) {
-        if (theme.collageThumbTexture) {
-            SDL_DestroyTexture(theme.collageThumbTexture);
-            theme.collageThumbTexture = nullptr;
-        }
-    }
+    // 缩略图纹理归 ImageLoader 缓存所有, 这里只解除固定
+    mVisibleThumbs.Clear();
     
     FileLogger::GetInstance().LogInfo("ManageScreen destructor completed");
 }
@@ -97,191 +91,52 @@ void ManageScreen::UpdateAnimations() {
 }
 
 void ManageScreen::ScanLocalThemes() {
+    auto t1 = std::chrono::steady_clock::now();
     mThemes.clear();
     
-    const char* themesPath = "fs:/vol/external01/wiiu/themes";
-    DIR* dir = opendir(themesPath);
-    if (!dir) {
-        FileLogger::GetInstance().LogError("Failed to open themes directory");
-        return;
-    }
+    // 从已安装主题索引读取, 目录未变化时不需要逐个打开主题目录
+    InstalledThemeIndex& index = InstalledThemeIndex::GetInstance();
+    index.Load();
     
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_type != DT_DIR) continue;
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
-        
-        LocalTheme theme;
-        theme.name = entry->d_name;
-        theme.path = std::string(themesPath) + "/" + entry->d_name;
-        
-        // 加载元数据
-        LoadThemeMetadata(theme);
-        
-        // 检查是否有修补完成的文件 (Men.pack 或 Men2.pack)
-        std::string patchedPath = theme.path + "/content/Common/Package";
-        struct stat st;
-        theme.hasPatched = false;
-        
-        FileLogger::GetInstance().LogInfo("Checking patched status for: %s", theme.name.c_str());
-        FileLogger::GetInstance().LogInfo("Patched path: %s", patchedPath.c_str());
-        
-        if (stat(patchedPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
-            std::string menPath = patchedPath + "/Men.pack";
-            std::string men2Path = patchedPath + "/Men2.pack";
-            
-            struct stat menSt, men2St;
-            bool hasMen = (stat(menPath.c_str(), &menSt) == 0);
-            bool hasMen2 = (stat(men2Path.c_str(), &men2St) == 0);
-            
-            FileLogger::GetInstance().LogInfo("Patch check - Men.pack: %d, Men2.pack: %d", hasMen ? 1 : 0, hasMen2 ? 1 : 0);
-            
-            theme.hasPatched = (hasMen || hasMen2);
-        } else {
-            FileLogger::GetInstance().LogInfo("Patched directory not found or not accessible");
-        }
-        
-        FileLogger::GetInstance().LogInfo("Theme %s hasPatched = %d", theme.name.c_str(), theme.hasPatched ? 1 : 0);
-        
-        // 统计 BPS 文件数量
-        theme.bpsCount = 0;
-        DIR* themeDir = opendir(theme.path.c_str());
-        if (themeDir) {
-            struct dirent* themeEntry;
-            while ((themeEntry = readdir(themeDir)) != nullptr) {
-                std::string filename = themeEntry->d_name;
-                if (filename.length() > 4 && filename.substr(filename.length() - 4) == ".bps") {
-                    theme.bpsCount++;
-                }
-            }
-            closedir(themeDir);
+    const std::string themesPath = "fs:/vol/external01/wiiu/themes";
+    for (const LocalThemeRecord& record : index.GetLocalThemes()) {
+        if (record.bpsCount <= 0) {
+            continue;
         }
         
-        if (theme.bpsCount > 0) {
-            mThemes.push_back(theme);
-            FileLogger::GetInstance().LogInfo("Found theme: %s (%d BPS files)", theme.name.c_str(), theme.bpsCount);
-        }
-    }
-    
-    closedir(dir);
-    FileLogger::GetInstance().LogInfo("Total local themes found: %d", (int)mThemes.size());
-}
-
-void ManageScreen::LoadThemeMetadata(LocalTheme& theme) {
-    std::string metadataPath = theme.path + "/theme_info.json";
-    FILE* fp = fopen(metadataPath.c_str(), "r");
-    if (!fp) {
-        // 如果没有元数据文件，使用默认值
-        FileLogger::GetInstance().LogInfo("No metadata file for theme: %s, using defaults", theme.name.c_str());
-        theme.author = "Unknown";
-        theme.description = "";
-        theme.downloads = 0;
-        theme.likes = 0;
-        theme.updatedAt = "";
-        return;
+        LocalTheme theme;
+        theme.name = record.folder;
+        theme.path = themesPath + "/" + record.folder;
+        theme.id = record.id;
+        theme.shortId = record.shortId;
+        theme.author = record.author;
+        theme.description = record.description;
+        theme.downloads = record.downloads;
+        theme.likes = record.likes;
+        theme.updatedAt = record.updatedAt;
+        theme.tags = record.tags;
+        theme.collageThumbPath = record.collageThumbPath;
+        theme.collageHdPath = record.collageHdPath;
+        theme.launcherThumbPath = record.launcherThumbPath;
+        theme.launcherHdPath = record.launcherHdPath;
+        theme.warawaraThumbPath = record.warawaraThumbPath;
+        theme.warawaraHdPath = record.warawaraHdPath;
+        theme.hasPatched = record.hasPatched;
+        theme.bpsCount = record.bpsCount;
+        mThemes.push_back(std::move(theme));
     }
     
-    // 读取文件内容
-    fseek(fp, 0, SEEK_END);
-    long fileSize = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
-    
-    char* buffer = (char*)malloc(fileSize + 1);
-    fread(buffer, 1, fileSize, fp);
-    buffer[fileSize] = '\0';
-    fclose(fp);
-    
-    FileLogger::GetInstance().LogInfo("Parsing metadata for: %s (size: %ld bytes)", theme.name.c_str(), fileSize);
+    auto t2 = std::chrono::steady_clock::now();
+    FileLogger::GetInstance().LogInfo("  [+%lldms] Total local themes found: %d",
+        std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(), (int)mThemes.size());
     
-    // 使用 rapidjson 解析
-    try {
-        rapidjson::Document root;
-        root.Parse(buffer);
-        
-        if (root.HasParseError()) {
-            FileLogger::GetInstance().LogError("JSON parsing failed for %s: parse error", theme.name.c_str());
-        } else {
-            if (root.HasMember("id") && root["id"].IsString()) {
-                theme.id = root["id"].GetString();
-                FileLogger::GetInstance().LogInfo("  ID: %s", theme.id.c_str());
-            }
-            if (root.HasMember("shortId") && root["shortId"].IsString()) {
-                theme.shortId = root["shortId"].GetString();
-                FileLogger::GetInstance().LogInfo("  Short ID: %s", theme.shortId.c_str());
-            }
-            if (root.HasMember("author") && root["author"].IsString()) {
-                theme.author = root["author"].GetString();
-                FileLogger::GetInstance().LogInfo("  Author: %s", theme.author.c_str());
-            } else {
-                theme.author = "Unknown";
-            }
-            if (root.HasMember("description") && root["description"].IsString()) 
-                theme.description = root["description"].GetString();
-            if (root.HasMember("downloads") && root["downloads"].IsInt()) 
-                theme.downloads = root["downloads"].GetInt();
-            if (root.HasMember("likes") && root["likes"].IsInt()) 
-                theme.likes = root["likes"].GetInt();
-            if (root.HasMember("updatedAt") && root["updatedAt"].IsString()) 
-                theme.updatedAt = root["updatedAt"].GetString();
-            
-            // 解析 tags 数组
-            if (root.HasMember("tags") && root["tags"].IsArray()) {
-                const auto& tags = root["tags"];
-                for (rapidjson::SizeType i = 0; i < tags.Size(); i++) {
-                    if (tags[i].IsString()) {
-                        theme.tags.push_back(tags[i].GetString());
-                    }
-                }
-            }
-        }
-    } catch (const std::exception& e) {
-        FileLogger::GetInstance().LogError("JSON parsing exception for %s: %s", theme.name.c_str(), e.what());
-    }
-    
-    free(buffer);
-    
-    // 设置图片路径 - 从 images/ 子目录加载(新格式),如果不存在则尝试旧格式
-    // 支持多种图片格式: .webp, .jpg, .jpeg, .png
-    std::string imagesDir = theme.path + "/images";
-    struct stat st;
-    bool hasImagesDir = (stat(imagesDir.c_str(), &st) == 0 && S_ISDIR(st.st_mode));
-    
-    // 辅助函数: 查找存在的图片文件(尝试多种扩展名)
-    auto findImage = [](const std::string& basePath) -> std::string {
-        const char* extensions[] = {".webp", ".jpg", ".jpeg", ".png"};
-        struct stat st;
-        for (const char* ext : extensions) {
-            std::string path = basePath + ext;
-            if (stat(path.c_str(), &st) == 0) {
-                FileLogger::GetInstance().LogInfo("Found image: %s", path.c_str());
-                return path;
-            }
-        }
-        FileLogger::GetInstance().LogWarning("No image found for: %s (tried .webp, .jpg, .jpeg, .png)", basePath.c_str());
-        return basePath + ".jpg"; // 默认返回 .jpg (兼容旧逻辑)
-    };
-    
-    if (hasImagesDir) {
-        // 新格式: images/ 子目录
-        theme.collageThumbPath = findImage(imagesDir + "/collage_thumb");
-        theme.collageHdPath = findImage(imagesDir + "/collage");
-        theme.launcherThumbPath = findImage(imagesDir + "/launcher_thumb");
-        theme.launcherHdPath = findImage(imagesDir + "/launcher");
-        theme.warawaraThumbPath = findImage(imagesDir + "/warawara_thumb");
-        theme.warawaraHdPath = findImage(imagesDir + "/warawara");
-        FileLogger::GetInstance().LogInfo("Loading images from /images subdirectory");
-    } else {
-        // 旧格式: 直接在主题根目录
-        theme.collageThumbPath = findImage(theme.path + "/collage_thumb");
-        theme.collageHdPath = findImage(theme.path + "/collage");
-        theme.launcherThumbPath = findImage(theme.path + "/launcher_thumb");
-        theme.launcherHdPath = findImage(theme.path + "/launcher");
-        theme.warawaraThumbPath = findImage(theme.path + "/warawara_thumb");
-        theme.warawaraHdPath = findImage(theme.path + "/warawara");
-        FileLogger::GetInstance().LogInfo("Loading images from theme root (legacy)");
+    // 重建搜索索引
+    mSearchIndex.Clear();
+    mSearchIndex.Reserve(mThemes.size());
+    for (size_t i = 0; i < mThemes.size(); i++) {
+        const LocalTheme& theme = mThemes[i];
+        mSearchIndex.SetDocument((uint32_t)i, theme.name, theme.author, theme.tags, theme.shortId);
     }
-    
-    FileLogger::GetInstance().LogInfo("Loaded metadata for theme: %s (by %s)", theme.name.c_str(), theme.author.c_str());
 }
 
 void ManageScreen::Draw() {
@@ -419,6 +274,13 @@ void ManageScreen::DrawThemeList() {
     int currentY = listY;
     int endIndex = std::min(mScrollOffset + visibleCount, (int)displayCount);
     
+    std::vector<std::string> visibleThumbs;
+    for (int i = mScrollOffset; i < endIndex; i++) {
+        size_t realIndex = mSearchActive ? mFilteredIndices[i] : i;
+        visibleThumbs.push_back(mThemes[realIndex].collageThumbPath);
+    }
+    mVisibleThumbs.Update(visibleThumbs);
+    
     for (int i = mScrollOffset; i < endIndex; i++) {
         bool selected = (i == mSelectedIndex);
         // 获取实际主题索引
@@ -445,6 +307,10 @@ void ManageScreen::DrawThemeCard(LocalTheme& theme, int x, int y, int w, int h,
         highlight = mThemeAnims[themeIndex].highlightAnim.GetValue();
     }
     
+    // 缩略图解码尺寸 (不随选中动画变化, 保证与 ThumbnailStore 中的缓存尺寸一致)
+    const int decodeH = h - 40;
+    const int decodeW = (int)(decodeH * 16.0f / 9.0f);
+    
     // 应用缩放
     int scaledW = (int)(w * scale);
     int scaledH = (int)(h * scale);
@@ -485,14 +351,20 @@ void ManageScreen::DrawThemeCard(LocalTheme& theme, int x, int y, int w, int h,
     const int thumbX = x + 20;
     const int thumbY = y + 20;
     
+    // 离开可见范围期间纹理可能已被缓存淘汰, 重新加载
+    if (theme.collageThumbTexture && !ImageLoader::IsCached(theme.collageThumbPath, theme.collageThumbTexture)) {
+        theme.collageThumbTexture = nullptr;
+        theme.collageThumbLoaded = false;
+    }
+    
     // 绘制缩略图 - 使用 ImageLoader 异步加载 webp
     if (theme.collageThumbTexture) {
         // 已加载,绘制纹理
         SDL_Rect dstRect = {thumbX, thumbY, thumbW, thumbH};
         
-        // 获取纹理尺寸
-        int texW, texH;
-        SDL_QueryTexture(theme.collageThumbTexture, nullptr, nullptr, &texW, &texH);
+        // 获取图片尺寸 (缩略图在图集中时只是其中一块)
+        SDL_Rect srcRect = ImageLoader::GetSourceRect(theme.collageThumbPath, theme.collageThumbTexture);
+        int texW = srcRect.w, texH = srcRect.h;
         
         // 计算缩放以保持纵横比
         float imgScale = std::min((float)thumbW / texW, (float)thumbH / texH);
@@ -509,7 +381,7 @@ void ManageScreen::DrawThemeCard(LocalTheme& theme, int x, int y, int w, int h,
         Gfx::DrawRectFilled(thumbX, thumbY, thumbW, thumbH, Gfx::COLOR_ALT_BACKGROUND);
         
         // 绘制纹理
-        SDL_RenderCopy(Gfx::GetRenderer(), theme.collageThumbTexture, nullptr, &dstRect);
+        SDL_RenderCopy(Gfx::GetRenderer(), theme.collageThumbTexture, &srcRect, &dstRect);
         
     } else if (!theme.collageThumbPath.empty() && !theme.collageThumbLoaded) {
         // 还未加载,显示占位符并异步加载
@@ -530,29 +402,42 @@ void ManageScreen::DrawThemeCard(LocalTheme& theme, int x, int y, int w, int h,
         ImageLoader::LoadRequest request;
         request.url = theme.collageThumbPath;  // 本地文件路径
         request.highPriority = selected;
-        request.callback = [this, themeIndex](SDL_Texture* texture) {
-            if (themeIndex >= 0 && themeIndex < (int)mThemes.size()) {
-                if (texture) {
-                    // 加载成功
-                    mThemes[themeIndex].collageThumbTexture = texture;
-                    FileLogger::GetInstance().LogInfo("Loaded webp image for theme %d: %s", 
-                        themeIndex, mThemes[themeIndex].name.c_str());
-                } else {
-                    // 加载失败,检查重试次数
-                    mThemes[themeIndex].collageThumbRetryCount++;
+        // 按未缩放卡片中的显示尺寸解码
+        request.targetWidth = decodeW;
+        request.targetHeight = decodeH;
+        request.thumbnail = true;
+        // 解码在工作线程完成, 回调可能在几帧之后才执行: 界面已销毁时忽略, 按路径查找主题 (列表可能已重新扫描)
+        request.callback = [this, alive = std::weak_ptr<bool>(mAlive), path = theme.collageThumbPath](SDL_Texture* texture) {
+            if (alive.expired() || mIsLoading) {
+                return;
+            }
+            auto it = std::find_if(mThemes.begin(), mThemes.end(), [&path](const LocalTheme& t) {
+                return t.collageThumbPath == path;
+            });
+            if (it == mThemes.end()) {
+                return;
+            }
+            int themeIndex = (int)(it - mThemes.begin());
+            if (texture) {
+                // 加载成功
+                it->collageThumbTexture = texture;
+                FileLogger::GetInstance().LogInfo("Loaded webp image for theme %d: %s", 
+                    themeIndex, it->name.c_str());
+            } else {
+                // 加载失败,检查重试次数
+                it->collageThumbRetryCount++;
+                
+                if (it->collageThumbRetryCount < 3) {
+                    // 重试 (最多3次)
+                    FileLogger::GetInstance().LogWarning("Failed to load webp image for theme %d, retry %d/3", 
+                        themeIndex, it->collageThumbRetryCount);
                     
-                    if (mThemes[themeIndex].collageThumbRetryCount < 3) {
-                        // 重试 (最多3次)
-                        FileLogger::GetInstance().LogWarning("Failed to load webp image for theme %d, retry %d/3", 
-                            themeIndex, mThemes[themeIndex].collageThumbRetryCount);
-                        
-                        // 重置加载标志以触发重新加载
-                        mThemes[themeIndex].collageThumbLoaded = false;
-                    } else {
-                        // 重试次数已用尽,停止加载
-                        FileLogger::GetInstance().LogError("Failed to load webp image for theme %d after 3 retries, giving up", 
-                            themeIndex);
-                    }
+                    // 重置加载标志以触发重新加载
+                    it->collageThumbLoaded = false;
+                } else {
+                    // 重试次数已用尽,停止加载
+                    FileLogger::GetInstance().LogError("Failed to load webp image for theme %d after 3 retries, giving up", 
+                        themeIndex);
                 }
             }
         };
@@ -1201,66 +1086,14 @@ void ManageScreen::ApplySearch() {
     
     mSearchActive = true;
     
-    // 转换搜索文本为小写
-    std::string searchLower = mSearchText;
-    std::transform(searchLower.begin(), searchLower.end(), searchLower.begin(), ::tolower);
-    
-    // 检查是否是 T+ID 格式搜索
-    bool isIdSearch = false;
-    std::string searchId;
-    if (searchLower.length() >= 2 && searchLower[0] == 't') {
-        // 提取 T 后面的内容作为 ID
-        searchId = searchLower.substr(1);
-        isIdSearch = true;
-        FileLogger::GetInstance().LogInfo("[ManageScreen::ApplySearch] ID search mode: T%s", searchId.c_str());
-    }
-    
-    for (size_t i = 0; i < mThemes.size(); ++i) {
-        const auto& theme = mThemes[i];
-        
-        // 如果是 ID 搜索模式（T+ID）
-        if (isIdSearch && !theme.shortId.empty()) {
-            std::string shortIdLower = theme.shortId;
-            std::transform(shortIdLower.begin(), shortIdLower.end(), shortIdLower.begin(), ::tolower);
-            
-            // 完全匹配（例如 T1 只匹配 T1，不匹配 T123）
-            if (shortIdLower == searchId) {
-                FileLogger::GetInstance().LogInfo("[ManageScreen::ApplySearch] Matched ID: %s (theme: %s)", 
-                                                  theme.shortId.c_str(), theme.name.c_str());
-                mFilteredIndices.push_back(i);
-                continue;
-            }
-        }
-        
-        // 搜索主题名称
-        std::string nameLower = theme.name;
-        std::transform(nameLower.begin(), nameLower.end(), nameLower.begin(), ::tolower);
-        if (nameLower.find(searchLower) != std::string::npos) {
-            mFilteredIndices.push_back(i);
-            continue;
-        }
-        
-        // 搜索作者
-        std::string authorLower = theme.author;
-        std::transform(authorLower.begin(), authorLower.end(), authorLower.begin(), ::tolower);
-        if (authorLower.find(searchLower) != std::string::npos) {
-            mFilteredIndices.push_back(i);
-            continue;
-        }
-        
-        // 搜索标签
-        for (const auto& tag : theme.tags) {
-            std::string tagLower = tag;
-            std::transform(tagLower.begin(), tagLower.end(), tagLower.begin(), ::tolower);
-            if (tagLower.find(searchLower) != std::string::npos) {
-                mFilteredIndices.push_back(i);
-                break;
-            }
-        }
-    }
+    // 通过索引做容错排序搜索 (名称/作者/标签 + T<ID>), 结果按相关度排列, 索引在扫描本地主题时建立
+    auto t1 = std::chrono::steady_clock::now();
+    mFilteredIndices = mSearchIndex.SearchRanked(mSearchText, mSearchIndex.GetDocumentCount());
+    auto t2 = std::chrono::steady_clock::now();
     
-    FileLogger::GetInstance().LogInfo("[ManageScreen::ApplySearch] Search '%s' matched %zu themes", 
-                                      mSearchText.c_str(), mFilteredIndices.size());
+    FileLogger::GetInstance().LogInfo("[ManageScreen::ApplySearch] Search '%s' matched %zu themes [%lldus]", 
+                                      mSearchText.c_str(), mFilteredIndices.size(),
+                                      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
 }
 
 bool ManageScreen::IsTouchInRect(int touchX, int touchY, int rectX, int rectY, int rectW, int rectH) {
@@ -3,8 +3,11 @@
 #include "../utils/Animation.hpp"
 #include "../utils/ThemeManager.hpp"
 #include "../utils/BgmNotification.hpp"
+#include "../utils/ThemeSearchIndex.hpp"
+#include "../utils/ImageLoader.hpp"
 #include <string>
 #include <vector>
+#include <memory>
 #include <thread>
 #include <atomic>
 
@@ -29,7 +32,7 @@ struct LocalTheme {
     std::string warawaraThumbPath;
     std::string warawaraHdPath;
     
-    // 图片纹理（异步加载）
+    // 图片纹理（异步加载, 归 ImageLoader 缓存所有）
     SDL_Texture* collageThumbTexture = nullptr;
     bool collageThumbLoaded = false;  // 标记是否已请求加载
     int collageThumbRetryCount = 0;   // 加载重试计数（最多3次）
@@ -61,6 +64,12 @@ private:
     int mScrollOffset = 0;
     bool mIsLoading = true;
     
+    // 可见卡片的缩略图, 固定在纹理缓存中
+    TexturePinSet mVisibleThumbs;
+    
+    // 图片加载回调持有 weak_ptr, 界面销毁后回调不再访问界面
+    std::shared_ptr<bool> mAlive = std::make_shared<bool>(true);
+    
     // 当前激活的主题名称（来自 StyleMiiU 配置）
     std::string mCurrentThemeName;
     
@@ -73,6 +82,7 @@ private:
     std::string mSearchText;
     bool mSearchActive = false;
     std::vector<size_t> mFilteredIndices;  // 搜索结果的索引列表
+    ThemeSearchIndex mSearchIndex;         // 本地主题搜索索引
     
     // 动画系统 - 每个主题卡片的动画
     struct ThemeAnimation {
@@ -90,7 +100,6 @@ private:
     static constexpr int VISIBLE_COUNT = 3;
     
     void ScanLocalThemes();
-    void LoadThemeMetadata(LocalTheme& theme);
     void InitAnimations();
     void UpdateAnimations();
     void DrawThemeList();
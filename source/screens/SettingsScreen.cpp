@@ -3,6 +3,7 @@
 #include "../utils/LanguageManager.hpp"
 #include "../utils/FileLogger.hpp"
 #include "../utils/Config.hpp"
+#include "../utils/FrameProfiler.hpp"
 #include <dirent.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -81,10 +82,10 @@ void SettingsScreen::Draw() {
     
     // 设置项列表
     const int topBarHeight = 120;
-    const int itemHeight = 120;
-    const int itemSpacing = 20;
+    const int itemHeight = ITEM_HEIGHT;
+    const int itemSpacing = 10;
     const int listX = 200;
-    const int listY = topBarHeight + 60;
+    const int listY = topBarHeight + 30;
     const int listW = Gfx::SCREEN_WIDTH - 400;
     
     // 获取当前语言名称
@@ -155,6 +156,17 @@ void SettingsScreen::Draw() {
                    0xf0ae);  // fa-tasks
     currentY += itemHeight + itemSpacing;
     
+    // 性能分析叠加层 - 图表图标
+    mSettingItemBounds[SETTINGS_PROFILER] = {listX, currentY, listW, itemHeight};
+    DrawSettingItem(listX, currentY, listW, 
+                   _("settings.profiler"), 
+                   _("settings.profiler_desc"), 
+                   FrameProfiler::GetInstance().IsOverlayVisible() ? _("common.yes") : _("common.no"),
+                   mSelectedItem == SETTINGS_PROFILER,
+                   mItemAnimProgress[SETTINGS_PROFILER],
+                   0xf201);  // fa-chart-line
+    currentY += itemHeight + itemSpacing;
+    
     // 清除缓存设置 - 垃圾桶图标
     mSettingItemBounds[SETTINGS_CLEAR_CACHE] = {listX, currentY, listW, itemHeight};
     DrawSettingItem(listX, currentY, listW, 
@@ -174,7 +186,7 @@ void SettingsScreen::Draw() {
 void SettingsScreen::DrawSettingItem(int x, int y, int w, const std::string& title, 
                                      const std::string& description, const std::string& value, 
                                      bool selected, float animProgress, uint16_t icon) {
-    const int itemH = 120; // 匹配Draw()中的itemHeight
+    const int itemH = ITEM_HEIGHT;
     
     // 使用动画进度计算缩放效果
     float scale = 1.0f + (animProgress * 0.03f); // 选中时放大3%
@@ -484,6 +496,9 @@ bool SettingsScreen::Update(Input &input) {
                                 FileLogger::GetInstance().SetVerbose(newState);
                             }
                             break;
+                        case SETTINGS_PROFILER:
+                            FrameProfiler::GetInstance().SetOverlayVisible(!FrameProfiler::GetInstance().IsOverlayVisible());
+                            break;
                         case SETTINGS_CLEAR_CACHE:
                             ClearCache();
                             break;
@@ -578,6 +593,10 @@ bool SettingsScreen::Update(Input &input) {
                     FileLogger::GetInstance().SetVerbose(newState);
                 }
                 break;
+            case SETTINGS_PROFILER:
+                // 切换性能分析叠加层
+                FrameProfiler::GetInstance().SetOverlayVisible(!FrameProfiler::GetInstance().IsOverlayVisible());
+                break;
             case SETTINGS_CLEAR_CACHE:
                 // 清除缓存
                 {
@@ -587,6 +606,16 @@ bool SettingsScreen::Update(Input &input) {
         }
     }
     
+    // X键导出性能分析数据
+    if (mSelectedItem == SETTINGS_PROFILER && (input.data.buttons_d & Input::BUTTON_X)) {
+        std::string path = FrameProfiler::GetInstance().ExportCsv();
+        if (!path.empty()) {
+            Screen::GetBgmNotification().ShowInfo(path, 5000, _("settings.profiler_exported"));
+        } else {
+            Screen::GetBgmNotification().ShowError(_("settings.profiler_export_failed"));
+        }
+    }
+    
     return true;
 }
 
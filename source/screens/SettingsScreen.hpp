@@ -18,11 +18,14 @@ private:
         SETTINGS_BGM_ENABLED,
         SETTINGS_LOGGING_ENABLED,
         SETTINGS_LOGGING_VERBOSE,
+        SETTINGS_PROFILER,
         SETTINGS_CLEAR_CACHE,
         
         SETTINGS_COUNT
     };
     
+    static constexpr int ITEM_HEIGHT = 110;
+    
     int mFrameCount = 0;
     int mSelectedItem = SETTINGS_LANGUAGE;
     bool mLanguageDialogOpen = false;
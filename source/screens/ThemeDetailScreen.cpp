@@ -5,6 +5,7 @@
 #include "../utils/ImageLoader.hpp"
 #include "../utils/ThemeDownloader.hpp"
 #include "../utils/ThemePatcher.hpp"
+#include "../utils/InstalledThemeIndex.hpp"
 #include "../utils/Utils.hpp"
 #include "../utils/logger.h"
 #include "../utils/FileLogger.hpp"
@@ -107,12 +108,10 @@ ThemeDetailScreen::ThemeDetailScreen(const Theme* theme, ThemeManager* themeMana
         mIsLocalMode = true;
         FileLogger::GetInstance().LogInfo("Theme '%s' is local (from ManageScreen)", theme->name.c_str());
     } else if (!theme->id.empty()) {
-        // 检查 installed 目录中是否存在该主题的 .json 文件
-        std::string installedJsonPath = "fs:/vol/external01/UTheme/installed/" + theme->id + ".json";
-        struct stat st;
-        mIsLocalMode = (stat(installedJsonPath.c_str(), &st) == 0);
-        FileLogger::GetInstance().LogInfo("Theme '%s' local mode: %d (json: %s)", 
-            theme->name.c_str(), mIsLocalMode, installedJsonPath.c_str());
+        // 检查已安装主题索引中是否有该主题的安装记录
+        mIsLocalMode = InstalledThemeIndex::GetInstance().IsInstalled(theme->id);
+        FileLogger::GetInstance().LogInfo("Theme '%s' local mode: %d (id: %s)", 
+            theme->name.c_str(), mIsLocalMode, theme->id.c_str());
     }
     
     // 查找主题索引
@@ -134,113 +133,10 @@ ThemeDetailScreen::ThemeDetailScreen(const Theme* theme, ThemeManager* themeMana
         theme->launcherScreenshot.hdUrl.c_str(),
         theme->waraWaraScreenshot.hdUrl.c_str());
     
-    // 异步加载高清预览图
-    // 网络模式: 更新 ThemeManager 中的主题数据
-    if (themeIndex >= 0 && themeManager) {
-        auto& themes = themeManager->GetThemes();
-        
-        // 加载 collagePreview 高清图
-        if (!theme->collagePreview.hdUrl.empty() && !theme->collagePreview.hdLoaded) {
-            themes[themeIndex].collagePreview.hdLoaded = true;
-            ImageLoader::LoadRequest request;
-            request.url = theme->collagePreview.hdUrl;
-            request.highPriority = true;
-            request.callback = [themeManager, themeIndex](SDL_Texture* texture) {
-                if (themeManager) {
-                    auto& themes = themeManager->GetThemes();
-                    if (themeIndex >= 0 && themeIndex < (int)themes.size()) {
-                        themes[themeIndex].collagePreview.hdTexture = texture;
-                        FileLogger::GetInstance().LogInfo("Loaded HD collagePreview for theme %d: %p", themeIndex, texture);
-                    }
-                }
-            };
-            ImageLoader::LoadAsync(request);
-        }
-        
-        // 加载 launcherScreenshot 高清图
-        if (!theme->launcherScreenshot.hdUrl.empty() && !theme->launcherScreenshot.hdLoaded) {
-            themes[themeIndex].launcherScreenshot.hdLoaded = true;
-            ImageLoader::LoadRequest request;
-            request.url = theme->launcherScreenshot.hdUrl;
-            request.highPriority = true;
-            request.callback = [themeManager, themeIndex](SDL_Texture* texture) {
-                if (themeManager) {
-                    auto& themes = themeManager->GetThemes();
-                    if (themeIndex >= 0 && themeIndex < (int)themes.size()) {
-                        themes[themeIndex].launcherScreenshot.hdTexture = texture;
-                        FileLogger::GetInstance().LogInfo("Loaded HD launcherScreenshot for theme %d: %p", themeIndex, texture);
-                    }
-                }
-            };
-            ImageLoader::LoadAsync(request);
-        }
-        
-        // 加载 waraWaraScreenshot 高清图
-        if (!theme->waraWaraScreenshot.hdUrl.empty() && !theme->waraWaraScreenshot.hdLoaded) {
-            themes[themeIndex].waraWaraScreenshot.hdLoaded = true;
-            ImageLoader::LoadRequest request;
-            request.url = theme->waraWaraScreenshot.hdUrl;
-            request.highPriority = true;
-            request.callback = [themeManager, themeIndex](SDL_Texture* texture) {
-                if (themeManager) {
-                    auto& themes = themeManager->GetThemes();
-                    if (themeIndex >= 0 && themeIndex < (int)themes.size()) {
-                        themes[themeIndex].waraWaraScreenshot.hdTexture = texture;
-                        FileLogger::GetInstance().LogInfo("Loaded HD waraWaraScreenshot for theme %d: %p", themeIndex, texture);
-                    }
-                }
-            };
-            ImageLoader::LoadAsync(request);
-        }
-    }
-    // 本地模式: 直接加载本地文件
-    else if (!themeManager) {
-        FileLogger::GetInstance().LogInfo("Local mode: Loading local images directly");
-        
-        // 加载 collagePreview 高清图
-        if (!theme->collagePreview.hdUrl.empty()) {
-            ImageLoader::LoadRequest request;
-            request.url = theme->collagePreview.hdUrl;
-            request.highPriority = true;
-            request.callback = [this](SDL_Texture* texture) {
-                if (mTheme) {
-                    const_cast<Theme*>(mTheme)->collagePreview.hdTexture = texture;
-                    const_cast<Theme*>(mTheme)->collagePreview.hdLoaded = true;
-                    FileLogger::GetInstance().LogInfo("Loaded local HD collagePreview: %p", texture);
-                }
-            };
-            ImageLoader::LoadAsync(request);
-        }
-        
-        // 加载 launcherScreenshot 高清图
-        if (!theme->launcherScreenshot.hdUrl.empty()) {
-            ImageLoader::LoadRequest request;
-            request.url = theme->launcherScreenshot.hdUrl;
-            request.highPriority = true;
-            request.callback = [this](SDL_Texture* texture) {
-                if (mTheme) {
-                    const_cast<Theme*>(mTheme)->launcherScreenshot.hdTexture = texture;
-                    const_cast<Theme*>(mTheme)->launcherScreenshot.hdLoaded = true;
-                    FileLogger::GetInstance().LogInfo("Loaded local HD launcherScreenshot: %p", texture);
-                }
-            };
-            ImageLoader::LoadAsync(request);
-        }
-        
-        // 加载 waraWaraScreenshot 高清图
-        if (!theme->waraWaraScreenshot.hdUrl.empty()) {
-            ImageLoader::LoadRequest request;
-            request.url = theme->waraWaraScreenshot.hdUrl;
-            request.highPriority = true;
-            request.callback = [this](SDL_Texture* texture) {
-                if (mTheme) {
-                    const_cast<Theme*>(mTheme)->waraWaraScreenshot.hdTexture = texture;
-                    const_cast<Theme*>(mTheme)->waraWaraScreenshot.hdLoaded = true;
-                    FileLogger::GetInstance().LogInfo("Loaded local HD waraWaraScreenshot: %p", texture);
-                }
-            };
-            ImageLoader::LoadAsync(request);
-        }
+    // 预览图先显示已缓存的缩略图, 同时以高优先级加载高清图; 网络图片边下载边显示
+    const ThemeImage* images[] = {&theme->collagePreview, &theme->launcherScreenshot, &theme->waraWaraScreenshot};
+    for (int i = 0; i < 3; i++) {
+        mPreviews[i].Load(images[i]->thumbUrl, images[i]->hdUrl, themeManager != nullptr);
     }
 }
 
@@ -333,24 +229,9 @@ void ThemeDetailScreen::DrawPreviewSection(int yOffset) {
     SDL_Rect clipRect = {previewX, previewY, previewW, previewH};
     SDL_RenderSetClipRect(Gfx::GetRenderer(), &clipRect);
     
-    // 获取预览图纹理（第一张使用高清图，其他使用缩略图 ?
-    auto getPreviewTexture = [this](int index) -> SDL_Texture* {
-        switch (index) {
-            case 0: 
-                // collagePreview 优先使用高清图，如果没有则使用缩略图
-                return mTheme->collagePreview.hdTexture ? 
-                       mTheme->collagePreview.hdTexture : 
-                       mTheme->collagePreview.thumbTexture;
-            case 1: 
-                return mTheme->launcherScreenshot.hdTexture ? 
-                       mTheme->launcherScreenshot.hdTexture : 
-                       mTheme->launcherScreenshot.thumbTexture;
-            case 2: 
-                return mTheme->waraWaraScreenshot.hdTexture ? 
-                       mTheme->waraWaraScreenshot.hdTexture : 
-                       mTheme->waraWaraScreenshot.thumbTexture;
-            default: return nullptr;
-        }
+    // 获取预览图 (高清图就绪前显示放大的缩略图)
+    auto getPreviewTexture = [this](int index) -> TieredImage* {
+        return (index >= 0 && index < 3) ? &mPreviews[index] : nullptr;
     };
     
     // 滑动动画：绘制当前和前一个预览图
@@ -382,10 +263,9 @@ void ThemeDetailScreen::DrawPreviewSection(int yOffset) {
             }
         }
         
-        SDL_Texture* prevTexture = getPreviewTexture(prevIndex);
-        if (prevTexture) {
-            int texW, texH;
-            SDL_QueryTexture(prevTexture, nullptr, nullptr, &texW, &texH);
+        TieredImage* prevImage = getPreviewTexture(prevIndex);
+        int texW = 0, texH = 0;
+        if (prevImage && prevImage->GetSize(texW, texH)) {
             
             // 适应区域（保持比例，不裁剪）
             float scaleW = (float)previewW / texW;
@@ -412,15 +292,14 @@ void ThemeDetailScreen::DrawPreviewSection(int yOffset) {
             dstRect.w = scaledW;
             dstRect.h = scaledH;
             
-            SDL_RenderCopy(Gfx::GetRenderer(), prevTexture, nullptr, &dstRect);
+            prevImage->Draw(dstRect);
         }
     }
     
     // 绘制当前预览图（滑入 ?
-    SDL_Texture* currentTexture = getPreviewTexture(mCurrentPreview);
-    if (currentTexture) {
-        int texW, texH;
-        SDL_QueryTexture(currentTexture, nullptr, nullptr, &texW, &texH);
+    TieredImage* currentImage = getPreviewTexture(mCurrentPreview);
+    int texW = 0, texH = 0;
+    if (currentImage && currentImage->GetSize(texW, texH)) {
         
         // 适应区域（保持比例，不裁剪）
         float scaleW = (float)previewW / texW;
@@ -444,7 +323,7 @@ void ThemeDetailScreen::DrawPreviewSection(int yOffset) {
         dstRect.w = scaledW;
         dstRect.h = scaledH;
         
-        SDL_RenderCopy(Gfx::GetRenderer(), currentTexture, nullptr, &dstRect);
+        currentImage->Draw(dstRect);
     } else {
         // 加载 ?- 显示在黑色背景上
         SDL_Color loadingBg = {20, 20, 20, 255};
@@ -1017,6 +896,9 @@ bool ThemeDetailScreen::UninstallTheme() {
             FileLogger::GetInstance().LogWarning("[UNINSTALL] Failed to delete installed JSON (errno=%d): %s", 
                 errno, installedJsonPath.c_str());
         }
+        
+        InstalledThemeIndex::GetInstance().RemoveFolder(InstalledThemeIndex::FolderFromPath(themePath));
+        InstalledThemeIndex::GetInstance().RecordUninstall(mTheme->id);
     } else {
         FileLogger::GetInstance().LogError("[UNINSTALL] Failed to uninstall theme: %s", mTheme->name.c_str());
     }
@@ -1713,31 +1595,14 @@ void ThemeDetailScreen::DrawFullscreenPreview() {
     Gfx::DrawRectFilled(0, 0, Gfx::SCREEN_WIDTH, Gfx::SCREEN_HEIGHT, {0, 0, 0, 255});
     
     // 辅助函数:根据索引获取预览图纹理
-    auto getPreviewTexture = [this](int index) -> SDL_Texture* {
-        switch (index) {
-            case 0:
-                return mTheme->collagePreview.hdTexture ? 
-                       mTheme->collagePreview.hdTexture : 
-                       mTheme->collagePreview.thumbTexture;
-            case 1:
-                return mTheme->launcherScreenshot.hdTexture ? 
-                       mTheme->launcherScreenshot.hdTexture : 
-                       mTheme->launcherScreenshot.thumbTexture;
-            case 2:
-                return mTheme->waraWaraScreenshot.hdTexture ? 
-                       mTheme->waraWaraScreenshot.hdTexture : 
-                       mTheme->waraWaraScreenshot.thumbTexture;
-            default:
-                return nullptr;
-        }
+    auto getPreviewTexture = [this](int index) -> TieredImage* {
+        return (index >= 0 && index < 3) ? &mPreviews[index] : nullptr;
     };
     
     // 辅助函数:绘制纹理到指定位置(保持比例,居中)
-    auto drawTexture = [](SDL_Texture* texture, int offsetX, int alpha) {
-        if (!texture) return;
-        
-        int texW, texH;
-        SDL_QueryTexture(texture, nullptr, nullptr, &texW, &texH);
+    auto drawTexture = [](TieredImage* image, int offsetX, int alpha) {
+        int texW = 0, texH = 0;
+        if (!image || !image->GetSize(texW, texH)) return;
         
         // 适应整个屏幕(保持比例)
         float scaleW = (float)Gfx::SCREEN_WIDTH / texW;
@@ -1754,10 +1619,7 @@ void ThemeDetailScreen::DrawFullscreenPreview() {
         dstRect.w = scaledW;
         dstRect.h = scaledH;
         
-        // 设置透明度
-        SDL_SetTextureAlphaMod(texture, alpha);
-        SDL_RenderCopy(Gfx::GetRenderer(), texture, nullptr, &dstRect);
-        SDL_SetTextureAlphaMod(texture, 255); // 恢复
+        image->Draw(dstRect, (Uint8)alpha);
     };
     
     // 获取动画进度
@@ -1769,19 +1631,18 @@ void ThemeDetailScreen::DrawFullscreenPreview() {
         int slideOffset = (int)(Gfx::SCREEN_WIDTH * slideProgress * mFullscreenSlideDir);
         
         // 绘制上一张图片(滑出)
-        SDL_Texture* prevTexture = getPreviewTexture(mFullscreenPrevPreview);
+        TieredImage* prevImage = getPreviewTexture(mFullscreenPrevPreview);
         int prevAlpha = (int)(255 * (1.0f - slideProgress)); // 淡出
-        drawTexture(prevTexture, slideOffset, prevAlpha);
+        drawTexture(prevImage, slideOffset, prevAlpha);
         
         // 绘制当前图片(滑入)
-        SDL_Texture* currTexture = getPreviewTexture(mCurrentPreview);
+        TieredImage* currImage = getPreviewTexture(mCurrentPreview);
         int currOffset = slideOffset - (Gfx::SCREEN_WIDTH * mFullscreenSlideDir);
         int currAlpha = (int)(255 * slideProgress); // 淡入
-        drawTexture(currTexture, currOffset, currAlpha);
+        drawTexture(currImage, currOffset, currAlpha);
     } else {
         // 没有动画,直接绘制当前图片
-        SDL_Texture* texture = getPreviewTexture(mCurrentPreview);
-        drawTexture(texture, 0, 255);
+        drawTexture(getPreviewTexture(mCurrentPreview), 0, 255);
     }
     
     // 底部提示文字(半透明背景)
@@ -1795,7 +1656,7 @@ void ThemeDetailScreen::DrawFullscreenPreview() {
         "theme_detail.preview_launcher", 
         "theme_detail.preview_wara_wara"
     };
-    std::string previewName = _(previewKeys[mCurrentPreview]);
+    std::string previewName = _(LangKey(previewKeys[mCurrentPreview]));
     
     // 获取操作提示(多语言)
     std::string hintSwitch = _("theme_detail.fullscreen_hint_switch");
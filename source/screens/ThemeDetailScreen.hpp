@@ -2,6 +2,7 @@
 #include "Screen.hpp"
 #include "../utils/Animation.hpp"
 #include "../utils/ThemeManager.hpp"
+#include "../utils/TieredImage.hpp"
 #include <SDL2/SDL.h>
 #include <memory>
 #include <thread>
@@ -19,6 +20,7 @@ private:
     const Theme* mTheme;
     ThemeManager* mThemeManager;
     bool mIsLocalMode = false; // 是否为本地模式(已下载的主题)
+    TieredImage mPreviews[3]; // 预览图 (拼贴图 / 启动器 / WaraWara), 离开界面时释放高清图
     
     // 当前激活的主题名称（来自 StyleMiiU 配置）
     std::string mCurrentThemeName;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FrameDamage.hpp"
 #include <cmath>
 #include <coreinit/time.h>
 
@@ -14,6 +15,7 @@ public:
         mDuration = durationMs;
         mStartTime = OSTicksToMilliseconds(OSGetSystemTime());
         mIsAnimating = true;
+        FrameDamage::Mark();
     }
 
     void SetTarget(float target, float durationMs) {
@@ -24,11 +26,15 @@ public:
             mTargetValue = target;
             mDuration = durationMs;
             mStartTime = OSTicksToMilliseconds(OSGetSystemTime());
+            FrameDamage::Mark();
         }
     }
 
     void Update() {
         if (!mIsAnimating) return;
+        
+        // 动画进行中, 下一帧也需要绘制
+        FrameDamage::Mark();
 
         uint64_t currentTime = OSTicksToMilliseconds(OSGetSystemTime());
         float elapsed = (float)(currentTime - mStartTime);
@@ -57,6 +63,9 @@ public:
     bool IsAnimating() const { return mIsAnimating; }
     float GetTarget() const { return mTargetValue; }
     void SetImmediate(float value) {
+        if (value != mCurrentValue || mIsAnimating) {
+            FrameDamage::Mark();
+        }
         mCurrentValue = value;
         mTargetValue = value;
         mIsAnimating = false;
@@ -1,6 +1,7 @@
 #include "BgmNotification.hpp"
 #include "../Gfx.hpp"
 #include "../utils/LanguageManager.hpp"
+#include "../utils/FrameDamage.hpp"
 #include <coreinit/time.h>
 
 BgmNotification::BgmNotification() {
@@ -96,6 +97,7 @@ void BgmNotification::Update() {
         // 如果完全淡出,移除通知
         if (it->fadeAnim.GetValue() <= 0.0f && it->fadeAnim.GetTarget() <= 0.0f) {
             it = mNotifications.erase(it);
+            FrameDamage::Mark();
         } else {
             ++it;
         }
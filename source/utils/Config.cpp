@@ -2,6 +2,7 @@
 #include <fstream>
 #include <cstdio>
 #include <cstring>
+#include <cstdlib>
 #include <sys/stat.h>
 
 Config::Config() 
@@ -12,6 +13,9 @@ Config::Config()
     , mAutoInstall(true)
     , mBgmEnabled(true)   // 默认开启背景音乐
     , mBgmUrl("https://raw.githubusercontent.com/xziip/utheme/main/data/BGM.mp3")  // 默认BGM下载地址
+    , mTextureCacheMB(64)
+    , mImageCacheMB(256)
+    , mCompactThumbnails(false)
     , mHasShownTouchHint(false)  // 默认未显示触摸提示
     , mHasShownLanguageSwitchHint(false)  // 默认未显示语言切换提示
     , mThemeChanged(false)  // 默认主题未更改（运行时标志）
@@ -77,6 +81,27 @@ void Config::SetBgmUrl(const std::string& url) {
     }
 }
 
+void Config::SetTextureCacheMB(int mb) {
+    if (mTextureCacheMB != mb) {
+        mTextureCacheMB = mb;
+        Save();
+    }
+}
+
+void Config::SetImageCacheMB(int mb) {
+    if (mImageCacheMB != mb) {
+        mImageCacheMB = mb;
+        Save();
+    }
+}
+
+void Config::SetCompactThumbnails(bool enabled) {
+    if (mCompactThumbnails != enabled) {
+        mCompactThumbnails = enabled;
+        Save();
+    }
+}
+
 void Config::SetTouchHintShown(bool shown) {
     if (mHasShownTouchHint != shown) {
         mHasShownTouchHint = shown;
@@ -120,6 +145,18 @@ bool Config::Load() {
             mBgmEnabled = (line[4] == '1');
         } else if (strncmp(line, "bgmurl=", 7) == 0) {
             mBgmUrl = &line[7];
+        } else if (strncmp(line, "texturecachemb=", 15) == 0) {
+            int mb = atoi(&line[15]);
+            if (mb >= 8) {
+                mTextureCacheMB = mb;
+            }
+        } else if (strncmp(line, "imagecachemb=", 13) == 0) {
+            int mb = atoi(&line[13]);
+            if (mb >= 16) {
+                mImageCacheMB = mb;
+            }
+        } else if (strncmp(line, "compactthumbs=", 14) == 0) {
+            mCompactThumbnails = (line[14] == '1');
         } else if (strncmp(line, "touchhint=", 10) == 0) {
             mHasShownTouchHint = (line[10] == '1');
         } else if (strncmp(line, "languageswitchhint=", 19) == 0) {
@@ -169,6 +206,18 @@ bool Config::Save() {
     fprintf(file, "bgmurl=%s\n", mBgmUrl.c_str());
     fprintf(file, "\n");
     
+    fprintf(file, "# Image texture cache limit (MB)\n");
+    fprintf(file, "texturecachemb=%d\n", mTextureCacheMB);
+    fprintf(file, "\n");
+    
+    fprintf(file, "# Downloaded image cache limit on SD card (MB)\n");
+    fprintf(file, "imagecachemb=%d\n", mImageCacheMB);
+    fprintf(file, "\n");
+    
+    fprintf(file, "# 16-bit list thumbnails (RGB565 / RGBA4444, half the texture memory)\n");
+    fprintf(file, "compactthumbs=%d\n", mCompactThumbnails ? 1 : 0);
+    fprintf(file, "\n");
+    
     fprintf(file, "# Touch hint shown\n");
     fprintf(file, "touchhint=%d\n", mHasShownTouchHint ? 1 : 0);
     fprintf(file, "\n");
@@ -31,6 +31,18 @@ public:
     std::string GetBgmUrl() const { return mBgmUrl; }
     void SetBgmUrl(const std::string& url);
     
+    // 图片纹理缓存上限 (MB)
+    int GetTextureCacheMB() const { return mTextureCacheMB; }
+    void SetTextureCacheMB(int mb);
+    
+    // SD 卡图片缓存上限 (MB)
+    int GetImageCacheMB() const { return mImageCacheMB; }
+    void SetImageCacheMB(int mb);
+    
+    // 列表缩略图使用 16 位纹理 (RGB565 / RGBA4444), 显存占用减半
+    bool GetCompactThumbnails() const { return mCompactThumbnails; }
+    void SetCompactThumbnails(bool enabled);
+    
     // 触摸提示设置
     bool HasShownTouchHint() const { return mHasShownTouchHint; }
     void SetTouchHintShown(bool shown);
@@ -60,6 +72,9 @@ private:
     bool mAutoInstall;              // 下载后自动安装
     bool mBgmEnabled;               // 背景音乐开关
     std::string mBgmUrl;            // BGM下载地址
+    int mTextureCacheMB;            // 图片纹理缓存上限 (MB)
+    int mImageCacheMB;              // SD 卡图片缓存上限 (MB)
+    bool mCompactThumbnails;        // 列表缩略图使用 16 位纹理
     bool mHasShownTouchHint;        // 是否已显示触摸提示
     bool mHasShownLanguageSwitchHint; // 是否已显示语言切换提示
     bool mThemeChanged;             // 主题是否被更改（运行时标志）
@@ -0,0 +1,30 @@
+#include "FrameDamage.hpp"
+#include "FileLogger.hpp"
+
+std::atomic<bool> FrameDamage::sDirty{true};
+int FrameDamage::sCleanFrames = 0;
+int FrameDamage::sFrames = 0;
+int FrameDamage::sDrawnFrames = 0;
+
+bool FrameDamage::BeginFrame() {
+    bool draw;
+    if (sDirty.exchange(false, std::memory_order_relaxed)) {
+        sCleanFrames = 0;
+        draw = true;
+    } else {
+        sCleanFrames++;
+        draw = sCleanFrames < GRACE_FRAMES || sCleanFrames % REFRESH_FRAMES == 0;
+    }
+    
+    if (draw) {
+        sDrawnFrames++;
+    }
+    if (++sFrames >= STATS_INTERVAL_FRAMES) {
+        if (FileLogger::GetInstance().IsVerbose()) {
+            FileLogger::GetInstance().LogInfo("[Idle] %d frames: %d drawn, %d skipped", sFrames, sDrawnFrames, sFrames - sDrawnFrames);
+        }
+        sFrames = 0;
+        sDrawnFrames = 0;
+    }
+    return draw;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <atomic>
+
+// 重绘标记: 画面没有任何变化时主循环跳过绘制和 Render (不再 present), 只处理输入、下载队列和音频
+// - 动画 (Animation)、图片加载完成 (ImageLoader)、输入、BGM 通知等在变化时调用 Mark()
+// - 标记后继续绘制 GRACE_FRAMES 帧, 让依赖已绘制帧数的逻辑 (输入冷却等) 正常推进
+// - 空闲时仍每 REFRESH_FRAMES 帧重绘一次, 兜底没有标记的后台状态变化
+class FrameDamage {
+public:
+    // 可在任意线程调用
+    static void Mark() { sDirty.store(true, std::memory_order_relaxed); }
+    
+    // 主循环每帧调用一次, 返回本帧是否需要绘制
+    static bool BeginFrame();
+
+private:
+    static constexpr int GRACE_FRAMES = 30;
+    static constexpr int REFRESH_FRAMES = 60;
+    static constexpr int STATS_INTERVAL_FRAMES = 600;
+    
+    static std::atomic<bool> sDirty;
+    static int sCleanFrames;
+    static int sFrames;
+    static int sDrawnFrames;
+};
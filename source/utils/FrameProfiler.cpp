@@ -0,0 +1,212 @@
+#include "FrameProfiler.hpp"
+#include "FileLogger.hpp"
+#include "FrameDamage.hpp"
+#include "../Gfx.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <sys/stat.h>
+
+namespace {
+    const char* const STAGE_NAMES[FrameProfiler::STAGE_COUNT] = {
+        "input",
+        "update",
+        "download_queue",
+        "image_upload",
+        "bgm_downloader",
+        "music",
+        "draw",
+        "render",
+        "print",
+        "rounded_rect",
+        "image_decode",
+    };
+    
+    const SDL_Color STAGE_COLORS[FrameProfiler::STAGE_COUNT] = {
+        {0x4e, 0xcc, 0x7e, 0xff},  // input
+        {0x8b, 0x5c, 0xf6, 0xff},  // update
+        {0x00, 0x95, 0xc7, 0xff},  // download_queue
+        {0xe8, 0x6a, 0xd6, 0xff},  // image_upload
+        {0x3a, 0xd0, 0xd0, 0xff},  // bgm_downloader
+        {0xff, 0x8c, 0x42, 0xff},  // music
+        {0xff, 0xcc, 0x00, 0xff},  // draw
+        {0xff, 0x44, 0x55, 0xff},  // render
+        {0xa0, 0xa8, 0xb8, 0xff},  // print
+        {0xa0, 0xa8, 0xb8, 0xff},  // rounded_rect
+        {0xa0, 0xa8, 0xb8, 0xff},  // image_decode
+    };
+    
+    uint32_t TicksToUs(OSTime ticks) {
+        return (uint32_t)OSTicksToMicroseconds(ticks);
+    }
+}
+
+FrameProfiler& FrameProfiler::GetInstance() {
+    static FrameProfiler instance;
+    return instance;
+}
+
+void FrameProfiler::BeginFrame() {
+    OSTime now = OSGetSystemTime();
+    if (!mMainThread) {
+        mMainThread = OSGetCurrentThread();
+    } else {
+        mCurrent.frameUs = TicksToUs(now - mFrameStart);
+        mHistory[mHead] = mCurrent;
+        mHead = (mHead + 1) % HISTORY_FRAMES;
+        mCount = std::min(mCount + 1, HISTORY_FRAMES);
+        mStatsAge++;
+    }
+    
+    mCurrent = {};
+    mFrameStart = now;
+}
+
+void FrameProfiler::Add(Stage stage, OSTime ticks) {
+    if (mSuspended || OSGetCurrentThread() != mMainThread) {
+        return;
+    }
+    mCurrent.stageUs[stage] += TicksToUs(ticks);
+}
+
+const FrameProfiler::FrameSample& FrameProfiler::GetSample(int age) const {
+    return mHistory[(mHead - 1 - age + HISTORY_FRAMES) % HISTORY_FRAMES];
+}
+
+void FrameProfiler::UpdateStats() {
+    mStatsAge = 0;
+    if (mCount == 0) {
+        return;
+    }
+    
+    std::vector<uint32_t> values(mCount);
+    auto percentile = [&values](int p) {
+        auto it = values.begin() + (values.size() - 1) * p / 100;
+        std::nth_element(values.begin(), it, values.end());
+        return *it;
+    };
+    
+    for (int stage = 0; stage <= STAGE_COUNT; stage++) {
+        for (int i = 0; i < mCount; i++) {
+            values[i] = stage < STAGE_COUNT ? mHistory[i].stageUs[stage] : mHistory[i].frameUs;
+        }
+        mStats[stage].p50 = percentile(50);
+        mStats[stage].p95 = percentile(95);
+        mStats[stage].p99 = percentile(99);
+    }
+}
+
+void FrameProfiler::DrawOverlay() {
+    if (!mOverlayVisible) {
+        return;
+    }
+    
+    mSuspended = true;
+    // 曲线每帧都在变化
+    FrameDamage::Mark();
+    
+    if (mStatsAge >= STATS_INTERVAL_FRAMES) {
+        UpdateStats();
+    }
+    
+    const int barW = 2;
+    const int graphW = GRAPH_FRAMES * barW;
+    const int graphH = 180;
+    const float usPerPixel = 33333.0f / graphH;  // 图高对应两帧 (33.3ms)
+    const int rowH = 26;
+    const int textSize = 22;
+    const int panelW = graphW + 40;
+    const int panelH = 20 + graphH + 20 + rowH * (STAGE_COUNT + 2) + 10;
+    const int panelX = Gfx::SCREEN_WIDTH - panelW - 20;
+    const int panelY = 140;
+    
+    Gfx::DrawRectFilled(panelX, panelY, panelW, panelH, SDL_Color{0x00, 0x00, 0x00, 0xc0});
+    
+    // 堆叠耗时图, 最新的帧在右侧
+    const int graphX = panelX + 20;
+    const int graphY = panelY + 20;
+    Gfx::DrawRectFilled(graphX, graphY, graphW, graphH, SDL_Color{0x20, 0x20, 0x30, 0xff});
+    
+    const int frames = std::min(mCount, GRAPH_FRAMES);
+    for (int age = 0; age < frames; age++) {
+        const FrameSample& sample = GetSample(age);
+        int x = graphX + graphW - (age + 1) * barW;
+        int bottom = graphY + graphH;
+        for (int stage = 0; stage < STAGE_MAIN_COUNT && bottom > graphY; stage++) {
+            int h = std::min((int)(sample.stageUs[stage] / usPerPixel), bottom - graphY);
+            if (h > 0) {
+                Gfx::DrawRectFilled(x, bottom - h, barW, h, STAGE_COLORS[stage]);
+                bottom -= h;
+            }
+        }
+    }
+    
+    // 16.7ms 参考线
+    Gfx::DrawRectFilled(graphX, graphY + graphH / 2, graphW, 1, SDL_Color{0xff, 0xff, 0xff, 0x80});
+    
+    // 百分位表 (ms)
+    char line[128];
+    int y = graphY + graphH + 20;
+    snprintf(line, sizeof(line), "%-16s %6s %6s %6s", "stage (ms)", "p50", "p95", "p99");
+    Gfx::Print(graphX, y, textSize, Gfx::COLOR_ALT_TEXT, line, Gfx::ALIGN_LEFT | Gfx::ALIGN_TOP, true);
+    y += rowH;
+    
+    for (int stage = 0; stage <= STAGE_COUNT; stage++) {
+        const StageStats& stats = mStats[stage];
+        const char* name = stage < STAGE_COUNT ? STAGE_NAMES[stage] : "frame";
+        // 热点函数嵌套在阶段内, 缩进显示
+        snprintf(line, sizeof(line), "%s%-*s %6.2f %6.2f %6.2f", stage >= STAGE_MAIN_COUNT && stage < STAGE_COUNT ? "  " : "",
+                 stage >= STAGE_MAIN_COUNT && stage < STAGE_COUNT ? 14 : 16, name,
+                 stats.p50 / 1000.0f, stats.p95 / 1000.0f, stats.p99 / 1000.0f);
+        
+        SDL_Color color = stage < STAGE_COUNT ? STAGE_COLORS[stage] : Gfx::COLOR_WHITE;
+        Gfx::Print(graphX, y, textSize, color, line, Gfx::ALIGN_LEFT | Gfx::ALIGN_TOP, true);
+        y += rowH;
+    }
+    
+    mSuspended = false;
+}
+
+std::string FrameProfiler::ExportCsv() const {
+    const char* dir = "fs:/vol/external01/UTheme";
+    mkdir(dir, 0777);
+    
+    OSCalendarTime now;
+    OSTicksToCalendarTime(OSGetTime(), &now);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/profile_%04d%02d%02d_%02d%02d%02d.csv", dir,
+             now.tm_year, now.tm_mon + 1, now.tm_mday, now.tm_hour, now.tm_min, now.tm_sec);
+    
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        FileLogger::GetInstance().LogError("[Profiler] Failed to open %s", path);
+        return "";
+    }
+    
+    fprintf(file, "frame,drawn,frame_us");
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        fprintf(file, ",%s_us", STAGE_NAMES[stage]);
+    }
+    fprintf(file, "\n");
+    
+    // 从最旧的一帧开始
+    for (int i = 0; i < mCount; i++) {
+        const FrameSample& sample = GetSample(mCount - 1 - i);
+        fprintf(file, "%d,%d,%u", i, sample.drawn ? 1 : 0, sample.frameUs);
+        for (int stage = 0; stage < STAGE_COUNT; stage++) {
+            fprintf(file, ",%u", sample.stageUs[stage]);
+        }
+        fprintf(file, "\n");
+    }
+    
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    if (!ok) {
+        FileLogger::GetInstance().LogError("[Profiler] Failed to write %s", path);
+        return "";
+    }
+    
+    FileLogger::GetInstance().LogInfo("[Profiler] Exported %d frames to %s", mCount, path);
+    return path;
+}
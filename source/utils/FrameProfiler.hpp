@@ -0,0 +1,102 @@
+#pragma once
+
+#include <coreinit/time.h>
+#include <coreinit/thread.h>
+#include <cstdint>
+#include <string>
+
+// 每帧 CPU 耗时分析
+// - 主循环各阶段和几个热点函数用 ProfileScope 计时, 写入最近 HISTORY_FRAMES 帧的环形缓冲
+// - 热点函数 (Print / DrawRectRounded / 同步 LoadFromMemory) 嵌套在 Update / Draw 等阶段内部, 单独列出, 不计入阶段合计
+// - 叠加层显示最近帧的堆叠耗时图和各阶段 p50/p95/p99, 设置界面可切换显示并导出 CSV 到 SD 卡
+// - 只统计主线程, 其他线程中的计时会被忽略
+class FrameProfiler {
+public:
+    enum Stage {
+        // 主循环阶段
+        STAGE_INPUT,
+        STAGE_UPDATE,
+        STAGE_DOWNLOAD_QUEUE,
+        STAGE_IMAGE_UPLOAD,
+        STAGE_BGM_DOWNLOADER,
+        STAGE_MUSIC,
+        STAGE_DRAW,
+        STAGE_RENDER,        // 包含等待 vsync
+        STAGE_MAIN_COUNT,
+        
+        // 热点函数
+        STAGE_PRINT = STAGE_MAIN_COUNT,
+        STAGE_ROUNDED_RECT,
+        STAGE_IMAGE_DECODE,
+        
+        STAGE_COUNT
+    };
+    
+    static FrameProfiler& GetInstance();
+    
+    // 主循环每帧开始时调用, 结束上一帧的记录
+    void BeginFrame();
+    
+    // 上一次 BeginFrame 之后这一帧是否绘制了画面
+    void SetFrameDrawn() { mCurrent.drawn = true; }
+    
+    void Add(Stage stage, OSTime ticks);
+    
+    void SetOverlayVisible(bool visible) { mOverlayVisible = visible; }
+    bool IsOverlayVisible() const { return mOverlayVisible; }
+    
+    // 在 Render 之前调用
+    void DrawOverlay();
+    
+    // 导出到 fs:/vol/external01/UTheme/profile_<时间>.csv, 成功时返回文件路径, 失败返回空字符串
+    std::string ExportCsv() const;
+
+private:
+    FrameProfiler() = default;
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+    
+    static constexpr int HISTORY_FRAMES = 600;
+    static constexpr int GRAPH_FRAMES = 240;
+    static constexpr int STATS_INTERVAL_FRAMES = 30;
+    
+    struct FrameSample {
+        uint32_t stageUs[STAGE_COUNT];
+        uint32_t frameUs;  // 整帧耗时 (两次 BeginFrame 的间隔)
+        bool drawn;
+    };
+    
+    struct StageStats {
+        uint32_t p50, p95, p99;
+    };
+    
+    FrameSample mHistory[HISTORY_FRAMES] = {};
+    int mHead = 0;   // 下一个写入位置
+    int mCount = 0;
+    FrameSample mCurrent = {};
+    OSTime mFrameStart = 0;
+    OSThread* mMainThread = nullptr;
+    
+    bool mOverlayVisible = false;
+    bool mSuspended = false;  // 绘制叠加层时不计时
+    
+    StageStats mStats[STAGE_COUNT + 1] = {};  // 最后一项为整帧
+    int mStatsAge = STATS_INTERVAL_FRAMES;
+    
+    const FrameSample& GetSample(int age) const;  // age = 0 为最近一帧
+    void UpdateStats();
+};
+
+// 作用域计时, 析构时累加到当前帧
+class ProfileScope {
+public:
+    explicit ProfileScope(FrameProfiler::Stage stage) : mStage(stage), mStart(OSGetSystemTime()) {}
+    ~ProfileScope() { FrameProfiler::GetInstance().Add(mStage, OSGetSystemTime() - mStart); }
+    
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    FrameProfiler::Stage mStage;
+    OSTime mStart;
+};
@@ -0,0 +1,184 @@
+#include "GeometryBatch.hpp"
+#include "FileLogger.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void GeometryBatch::SetTexture(SDL_Renderer* renderer, SDL_Texture* texture, SDL_FPoint solidUV) {
+    if (texture != mTexture) {
+        Flush(renderer);
+    }
+    mTexture = texture;
+    mSolidUV = solidUV;
+}
+
+int GeometryBatch::AddVertex(float x, float y, SDL_Color color) {
+    return AddVertex(x, y, color, mSolidUV.x, mSolidUV.y);
+}
+
+int GeometryBatch::AddVertex(float x, float y, SDL_Color color, float u, float v) {
+    SDL_Vertex vertex;
+    vertex.position.x = x;
+    vertex.position.y = y;
+    vertex.color = color;
+    vertex.tex_coord.x = u;
+    vertex.tex_coord.y = v;
+    mVertices.push_back(vertex);
+    return (int)mVertices.size() - 1;
+}
+
+void GeometryBatch::AddQuad(int a, int b, int c, int d) {
+    mIndices.insert(mIndices.end(), {a, b, c, a, c, d});
+}
+
+void GeometryBatch::AddRect(float x, float y, float w, float h, SDL_Color color) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    
+    int a = AddVertex(x, y, color);
+    int b = AddVertex(x + w, y, color);
+    int c = AddVertex(x + w, y + h, color);
+    int d = AddVertex(x, y + h, color);
+    AddQuad(a, b, c, d);
+    
+    mLegacyCalls += 1;
+}
+
+void GeometryBatch::AddRoundedRect(float x, float y, float w, float h, float radius, SDL_Color color) {
+    radius = std::min(radius, std::min(w, h) / 2.0f);
+    if (radius < 1.0f) {
+        AddRect(x, y, w, h, color);
+        return;
+    }
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    
+    // 以前是中间 3 个矩形 + 每个圆角每行一个矩形
+    mLegacyCalls += 3 + 4 * (uint32_t)radius;
+    
+    // 每个圆角的分段数随半径增加, 弦高误差保持在 0.1 像素左右
+    const int segments = std::clamp((int)(radius + 1) / 2, 2, MAX_CORNER_SEGMENTS);
+    const float cornerX[4] = {x + w - radius, x + w - radius, x + radius, x + radius};
+    const float cornerY[4] = {y + radius, y + h - radius, y + h - radius, y + radius};
+    
+    // 中心点 + 凸多边形扇形三角化
+    const int center = AddVertex(x + w / 2.0f, y + h / 2.0f, color);
+    const int first = (int)mVertices.size();
+    for (int corner = 0; corner < 4; corner++) {
+        // 从右上角 (-90°) 开始顺时针
+        const float start = (corner - 1) * (float)M_PI / 2.0f;
+        for (int i = 0; i <= segments; i++) {
+            const float angle = start + (float)M_PI / 2.0f * i / segments;
+            AddVertex(cornerX[corner] + cosf(angle) * radius, cornerY[corner] + sinf(angle) * radius, color);
+        }
+    }
+    const int last = (int)mVertices.size() - 1;
+    
+    for (int i = first; i < last; i++) {
+        mIndices.insert(mIndices.end(), {center, i, i + 1});
+    }
+    mIndices.insert(mIndices.end(), {center, last, first});
+}
+
+void GeometryBatch::AddNineSlice(float x, float y, float w, float h, const SDL_Rect& src, int corner, int textureSize, SDL_Color color) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    
+    mLegacyCalls += 3 + 4 * (uint32_t)corner;
+    
+    // 4x4 顶点网格, 9 个四边形
+    const float px[4] = {x, x + corner, x + w - corner, x + w};
+    const float py[4] = {y, y + corner, y + h - corner, y + h};
+    const float scale = 1.0f / textureSize;
+    const float u[4] = {src.x * scale, (src.x + corner) * scale, (src.x + src.w - corner) * scale, (src.x + src.w) * scale};
+    const float v[4] = {src.y * scale, (src.y + corner) * scale, (src.y + src.h - corner) * scale, (src.y + src.h) * scale};
+    
+    const int first = (int)mVertices.size();
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) {
+            AddVertex(px[col], py[row], color, u[col], v[row]);
+        }
+    }
+    
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            int a = first + row * 4 + col;
+            AddQuad(a, a + 1, a + 5, a + 4);
+        }
+    }
+}
+
+void GeometryBatch::AddGradientV(float x, float y, float w, float h, SDL_Color top, SDL_Color bottom) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    
+    int a = AddVertex(x, y, top);
+    int b = AddVertex(x + w, y, top);
+    int c = AddVertex(x + w, y + h, bottom);
+    int d = AddVertex(x, y + h, bottom);
+    AddQuad(a, b, c, d);
+    
+    // 以前每行一条线
+    mLegacyCalls += (uint32_t)h;
+}
+
+void GeometryBatch::AddShadowFrame(float x, float y, float w, float h, float size, SDL_Color color) {
+    if (size <= 0 || w <= 0 || h <= 0) {
+        return;
+    }
+    
+    SDL_Color outer = color;
+    outer.a = 0;
+    
+    // 内圈 (矩形边缘) 4 个顶点, 外圈 4 个顶点, 四条边各一个梯形
+    const int inner0 = AddVertex(x, y, color);
+    AddVertex(x + w, y, color);
+    AddVertex(x + w, y + h, color);
+    AddVertex(x, y + h, color);
+    const int outer0 = AddVertex(x - size, y - size, outer);
+    AddVertex(x + w + size, y - size, outer);
+    AddVertex(x + w + size, y + h + size, outer);
+    AddVertex(x - size, y + h + size, outer);
+    
+    for (int side = 0; side < 4; side++) {
+        int next = (side + 1) % 4;
+        AddQuad(outer0 + side, outer0 + next, inner0 + next, inner0 + side);
+    }
+    
+    // 以前每个像素宽度画一圈矩形边框
+    mLegacyCalls += (uint32_t)size;
+}
+
+void GeometryBatch::Flush(SDL_Renderer* renderer) {
+    if (mIndices.empty()) {
+        return;
+    }
+    
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(renderer, mTexture, mVertices.data(), (int)mVertices.size(), mIndices.data(), (int)mIndices.size());
+    
+    mDrawCalls++;
+    mVertexCount += mVertices.size();
+    mVertices.clear();
+    mIndices.clear();
+}
+
+void GeometryBatch::OnFrame() {
+    if (++mFrames < STATS_INTERVAL_FRAMES) {
+        return;
+    }
+    
+    if (FileLogger::GetInstance().IsVerbose()) {
+        FileLogger::GetInstance().LogInfo("[Geometry] %d frames: %.1f draw calls/frame (%.1f before batching), %.0f vertices/frame",
+            mFrames, (float)mDrawCalls / mFrames, (float)mLegacyCalls / mFrames, (float)mVertexCount / mFrames);
+    }
+    
+    mFrames = 0;
+    mDrawCalls = 0;
+    mLegacyCalls = 0;
+    mVertexCount = 0;
+}
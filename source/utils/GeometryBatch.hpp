@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+#include <cstdint>
+
+// 界面图元的批量绘制 (矩形、圆角矩形、九宫格、阴影、竖直渐变)
+// - 图元被细分为三角形写入同一个顶点缓冲, Flush() 时一次 SDL_RenderGeometry 提交
+// - 只使用一张纹理 (九宫格图集), 纯色图元从其中的白色像素取样; 没有设置纹理时按无纹理提交
+// - 其他纹理绘制 (文字、图标、图片) 之前必须先 Flush, 保证绘制顺序不变; 由 Gfx 负责
+// - 同时统计改用批量绘制前相同图元需要的绘制调用数, 详细日志模式下定期输出对比
+class GeometryBatch {
+public:
+    // solidUV 为纹理中白色像素的坐标, 纹理变化前会先提交已有顶点
+    void SetTexture(SDL_Renderer* renderer, SDL_Texture* texture, SDL_FPoint solidUV);
+    
+    void AddRect(float x, float y, float w, float h, SDL_Color color);
+    void AddRoundedRect(float x, float y, float w, float h, float radius, SDL_Color color);
+    
+    // src 为纹理中的九宫格 (四角各 corner 像素), 拉伸到 w x h
+    void AddNineSlice(float x, float y, float w, float h, const SDL_Rect& src, int corner, int textureSize, SDL_Color color);
+    
+    // 上下两端颜色线性插值
+    void AddGradientV(float x, float y, float w, float h, SDL_Color top, SDL_Color bottom);
+    
+    // 矩形外侧宽 size 的一圈, 透明度从 color.a 渐变到 0, 矩形内部不绘制
+    void AddShadowFrame(float x, float y, float w, float h, float size, SDL_Color color);
+    
+    void Flush(SDL_Renderer* renderer);
+    
+    // 每帧调用一次, 详细日志模式下定期输出绘制调用统计
+    void OnFrame();
+
+private:
+    static constexpr int STATS_INTERVAL_FRAMES = 600;
+    static constexpr int MAX_CORNER_SEGMENTS = 16;
+    
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+    SDL_Texture* mTexture = nullptr;
+    SDL_FPoint mSolidUV = {0.0f, 0.0f};
+    
+    uint32_t mDrawCalls = 0;     // 实际提交的 SDL_RenderGeometry 次数
+    uint32_t mLegacyCalls = 0;   // 逐行填充方式下相同图元需要的调用次数
+    uint32_t mVertexCount = 0;
+    int mFrames = 0;
+    
+    int AddVertex(float x, float y, SDL_Color color);
+    int AddVertex(float x, float y, SDL_Color color, float u, float v);
+    void AddQuad(int a, int b, int c, int d);
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+
+// 构建时烘焙的界面字形图集, 由 tools/glyphbake.cpp 从编译后的语言包 (.lang) 和图标字体生成
+// 所有整数为 Wii U 字节序 (大端), 运行时直接使用嵌入的数据
+//
+//   GlyphAtlasHeader
+//   GlyphAtlasFace[faceCount]
+//   GlyphAtlasGlyph[glyphCount]    按字号分组, 组内按码位升序
+//   uint8_t pixels[dataSize]       zlib 压缩的 8 位覆盖率, 解压后为 width * height 字节
+//
+// 每个字形单元与 SDL_ttf 单独渲染该字符 (TTF_RenderUTF8_Blended / TTF_RenderGlyph_Blended)
+// 得到的 surface 大小和位置一致: 宽度即前进宽度, 高度为字体高度, 可以直接作为 FC 字形数据使用
+
+constexpr uint32_t GLYPHATLAS_MAGIC = 0x55474154;  // "UGAT"
+constexpr uint32_t GLYPHATLAS_VERSION = 1;
+
+enum GlyphAtlasFlags : uint32_t {
+    GLYPHATLAS_FLAG_CJK = 1 << 0,  // 文本字形来自 CJK 字体 (与 LANGPACK_FLAG_CJK 相同)
+};
+
+enum GlyphAtlasFaceKind : uint32_t {
+    GLYPHATLAS_FACE_TEXT = 0,  // 界面字体
+    GLYPHATLAS_FACE_ICON = 1,  // 图标字体 (fa-solid-900)
+};
+
+struct GlyphAtlasHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t width;
+    uint32_t height;
+    uint32_t faceCount;
+    uint32_t glyphCount;
+    uint32_t dataSize;  // 压缩后的像素数据大小
+};
+
+struct GlyphAtlasFace {
+    uint32_t kind;
+    uint32_t size;        // 字号 (与 TTF_OpenFont 的 ptsize 相同)
+    uint32_t height;      // 字体高度 (TTF_FontHeight), 运行时据此校验
+    uint32_t firstGlyph;
+    uint32_t glyphCount;
+};
+
+struct GlyphAtlasGlyph {
+    uint32_t codepoint;
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+};
+
+static_assert(sizeof(GlyphAtlasHeader) == 32, "GlyphAtlasHeader layout");
+static_assert(sizeof(GlyphAtlasFace) == 20, "GlyphAtlasFace layout");
+static_assert(sizeof(GlyphAtlasGlyph) == 12, "GlyphAtlasGlyph layout");
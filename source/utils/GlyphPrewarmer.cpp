@@ -0,0 +1,179 @@
+#include "GlyphPrewarmer.hpp"
+#include "FileLogger.hpp"
+
+GlyphPrewarmer::~GlyphPrewarmer() {
+    Shutdown();
+}
+
+TTF_Font* GlyphPrewarmer::GetTTFFont(const void* fontData, uint32_t fontDataSize, int ptSize) {
+    auto key = std::make_pair(fontData, ptSize);
+    auto it = mTTFFonts.find(key);
+    if (it != mTTFFonts.end()) {
+        return it->second;
+    }
+    
+    // 与 FC_Font 使用同一份字体数据但是独立的 FreeType face, 工作线程独占使用
+    // (打开/关闭 face 只在主线程进行)
+    TTF_Font* ttf = TTF_OpenFontRW(SDL_RWFromConstMem(fontData, (int)fontDataSize), 1, ptSize);
+    if (!ttf) {
+        FileLogger::GetInstance().LogError("[GlyphPrewarm] Failed to open font at %dpt", ptSize);
+        return nullptr;
+    }
+    
+    mTTFFonts[key] = ttf;
+    return ttf;
+}
+
+void GlyphPrewarmer::Request(FC_Font* font, const void* fontData, uint32_t fontDataSize, int ptSize, std::string_view text) {
+    if (!font || !fontData || text.empty()) {
+        return;
+    }
+    
+    Job job;
+    job.font = font;
+    job.ttf = nullptr;
+    
+    // 解码 UTF-8, 只保留尚未缓存、也没有排队的码位
+    for (size_t i = 0; i < text.size();) {
+        uint8_t c = (uint8_t)text[i];
+        uint32_t cp;
+        int len;
+        if (c < 0x80)      { cp = c;        len = 1; }
+        else if (c < 0xE0) { cp = c & 0x1F; len = 2; }
+        else if (c < 0xF0) { cp = c & 0x0F; len = 3; }
+        else               { cp = c & 0x07; len = 4; }
+        for (int k = 1; k < len && i + k < text.size(); k++) {
+            cp = (cp << 6) | ((uint8_t)text[i + k] & 0x3F);
+        }
+        i += len;
+        
+        if (cp <= ' ' || FC_HasGlyph(font, cp)) {
+            continue;
+        }
+        if (mPending.insert(std::make_pair(font, cp)).second) {
+            job.codepoints.push_back(cp);
+        }
+    }
+    
+    if (job.codepoints.empty()) {
+        return;
+    }
+    
+    job.ttf = GetTTFFont(fontData, fontDataSize, ptSize);
+    if (!job.ttf) {
+        for (uint32_t cp : job.codepoints) {
+            mPending.erase(std::make_pair(font, cp));
+        }
+        return;
+    }
+    
+    mRequested += job.codepoints.size();
+    
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(std::move(job));
+    }
+    
+    if (!mThread.joinable()) {
+        mStop = false;
+        mThread = std::thread(&GlyphPrewarmer::WorkerLoop, this);
+    }
+    mCondition.notify_all();
+}
+
+void GlyphPrewarmer::WorkerLoop() {
+    // 与 FC_GetGlyphData 的渲染方式相同: 单个字符, 白色, Blended
+    const SDL_Color white = {255, 255, 255, 255};
+    
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mStop || !mJobs.empty(); });
+            if (mStop) {
+                return;
+            }
+            job = std::move(mJobs.front());
+            mJobs.pop_front();
+        }
+        
+        for (uint32_t cp : job.codepoints) {
+            char buff[5];
+            FC_GetUTF8FromCodepoint(buff, cp);
+            SDL_Surface* surface = TTF_RenderUTF8_Blended(job.ttf, buff, white);
+            
+            // 渲染失败也要交给主线程, 以便清除排队标记
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mStop || mStaged.size() < MAX_STAGED_GLYPHS; });
+            if (mStop) {
+                if (surface) {
+                    SDL_FreeSurface(surface);
+                }
+                return;
+            }
+            mStaged.push_back({job.font, cp, surface});
+        }
+    }
+}
+
+void GlyphPrewarmer::UploadBatch() {
+    if (mPending.empty()) {
+        return;
+    }
+    
+    int uploaded = 0;
+    while (uploaded < UPLOAD_GLYPHS_PER_FRAME) {
+        StagedGlyph glyph;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mStaged.empty()) {
+                break;
+            }
+            glyph = mStaged.front();
+            mStaged.pop_front();
+        }
+        mCondition.notify_all();
+        
+        // 等待期间可能已经被正常绘制路径加载, FC_CacheGlyphSurface 会跳过
+        if (glyph.surface) {
+            FC_CacheGlyphSurface(glyph.font, glyph.codepoint, glyph.surface);
+            SDL_FreeSurface(glyph.surface);
+            uploaded++;
+        }
+        mPending.erase(std::make_pair(glyph.font, glyph.codepoint));
+    }
+    
+    mUploaded += uploaded;
+    
+    if (mPending.empty()) {
+        FileLogger::GetInstance().LogInfo("[GlyphPrewarm] %u/%u glyphs uploaded", mUploaded, mRequested);
+        mUploaded = 0;
+        mRequested = 0;
+    }
+}
+
+void GlyphPrewarmer::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+    
+    for (auto& glyph : mStaged) {
+        if (glyph.surface) {
+            SDL_FreeSurface(glyph.surface);
+        }
+    }
+    mStaged.clear();
+    mJobs.clear();
+    mPending.clear();
+    
+    for (auto& [key, ttf] : mTTFFonts) {
+        TTF_CloseFont(ttf);
+    }
+    mTTFFonts.clear();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "SDL_FontCache.h"
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// 字形预热: 提前把即将用到的字形 (界面文本、主题名称等, 主要是 CJK) 放入 FC_Font 字形缓存
+// - 主线程收集尚未缓存的码位, 工作线程用独立的 TTF_Font (FreeType) 渲染到暂存 surface
+// - 主线程每帧少量上传到 FC 字形缓存纹理, 避免首次绘制时集中光栅化造成卡顿
+// 由 Gfx 持有, 通过 Gfx::PrewarmGlyphs() 使用
+class GlyphPrewarmer {
+public:
+    ~GlyphPrewarmer();
+    
+    // fontData 为 FC_Font 加载时使用的同一份字体数据, 保证渲染结果一致
+    void Request(FC_Font* font, const void* fontData, uint32_t fontDataSize, int ptSize, std::string_view text);
+    
+    // 主线程每帧调用, 上传已渲染好的字形
+    void UploadBatch();
+    
+    // 停止工作线程并释放暂存字形, 必须在释放 FC_Font 之前调用
+    void Shutdown();
+
+private:
+    static constexpr int UPLOAD_GLYPHS_PER_FRAME = 8;
+    static constexpr size_t MAX_STAGED_GLYPHS = 256;  // 暂存上限, 约 2MB (48px CJK)
+    
+    struct Job {
+        FC_Font* font;
+        TTF_Font* ttf;
+        std::vector<uint32_t> codepoints;
+    };
+    
+    struct StagedGlyph {
+        FC_Font* font;
+        uint32_t codepoint;
+        SDL_Surface* surface;
+    };
+    
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStop = false;
+    
+    std::deque<Job> mJobs;
+    std::deque<StagedGlyph> mStaged;
+    
+    // 以下仅主线程访问
+    std::map<std::pair<const void*, int>, TTF_Font*> mTTFFonts;  // (字体数据, 字号) -> 工作线程专用字体
+    std::set<std::pair<FC_Font*, uint32_t>> mPending;            // 已排队但未上传的字形
+    uint32_t mUploaded = 0;
+    uint32_t mRequested = 0;
+    
+    TTF_Font* GetTTFFont(const void* fontData, uint32_t fontDataSize, int ptSize);
+    void WorkerLoop();
+};
@@ -0,0 +1,570 @@
+#include "ImageDecodePool.hpp"
+#include "ImageLoader.hpp"
+#include "FileLogger.hpp"
+#include "ThumbnailStore.hpp"
+#include <SDL2/SDL_image.h>
+#include <coreinit/time.h>
+#include <cstdio>
+#include <cstring>
+#include <csetjmp>
+#include <algorithm>
+#include <jpeglib.h>
+
+// libwebp 解码器
+#include "src/webp/decode.h"
+
+ImageDecodePool::~ImageDecodePool() {
+    Stop();
+}
+
+void ImageDecodePool::Start(SDL_Renderer* renderer) {
+    if (!mThreads.empty()) {
+        return;
+    }
+    
+    // 使用渲染器的首选格式, 上传时无需再转换
+    SDL_RendererInfo info;
+    if (renderer && SDL_GetRendererInfo(renderer, &info) == 0 && info.num_texture_formats > 0) {
+        mFormat = info.texture_formats[0];
+    }
+    
+    mStop = false;
+    for (int i = 0; i < WORKER_COUNT; i++) {
+        mThreads.emplace_back(&ImageDecodePool::WorkerLoop, this);
+    }
+    FileLogger::GetInstance().LogInfo("[ImageDecode] %d workers started, format %s", WORKER_COUNT, SDL_GetPixelFormatName(mFormat));
+}
+
+void ImageDecodePool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    
+    for (auto& thread : mThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    mThreads.clear();
+    
+    for (auto& decoded : mDecoded) {
+        if (decoded.surface) {
+            SDL_FreeSurface(decoded.surface);
+        }
+    }
+    mDecoded.clear();
+    mJobs.clear();
+    mStagedBytes = 0;
+    mBusyWorkers = 0;
+}
+
+void ImageDecodePool::Submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (job.highPriority) {
+            mJobs.push_front(std::move(job));
+        } else {
+            mJobs.push_back(std::move(job));
+        }
+    }
+    mCondition.notify_all();
+}
+
+size_t ImageDecodePool::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mJobs.size() + mBusyWorkers + mDecoded.size();
+}
+
+bool ImageDecodePool::FitSize(int width, int height, int targetWidth, int targetHeight, int& outWidth, int& outHeight) {
+    outWidth = width;
+    outHeight = height;
+    if (width <= 0 || height <= 0 || (targetWidth <= 0 && targetHeight <= 0)) {
+        return false;
+    }
+    
+    float scale = 1.0f;
+    if (targetWidth > 0) {
+        scale = std::min(scale, (float)targetWidth / width);
+    }
+    if (targetHeight > 0) {
+        scale = std::min(scale, (float)targetHeight / height);
+    }
+    if (scale >= 1.0f) {
+        return false;
+    }
+    
+    outWidth = std::max(1, (int)(width * scale + 0.5f));
+    outHeight = std::max(1, (int)(height * scale + 0.5f));
+    return outWidth < width || outHeight < height;
+}
+
+namespace {
+    // 与 SDL 像素格式字节顺序一致的 libwebp 输出格式, 解码结果无需再转换
+    bool WebPModeForFormat(Uint32 format, WEBP_CSP_MODE& mode) {
+        switch (format) {
+            case SDL_PIXELFORMAT_RGBA32:
+                mode = MODE_RGBA;
+                return true;
+            case SDL_PIXELFORMAT_BGRA32:
+                mode = MODE_BGRA;
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
+bool ImageDecodePool::IsWebP(const uint8_t* data, size_t size) {
+    return data && size >= 12 && memcmp(data, "RIFF", 4) == 0 && memcmp(data + 8, "WEBP", 4) == 0;
+}
+
+bool ImageDecodePool::PrepareWebP(const uint8_t* data, size_t size, int targetWidth, int targetHeight,
+                                  WebPDecoderConfig& config, int& width, int& height) {
+    if (!WebPInitDecoderConfig(&config)) {
+        return false;
+    }
+    if (WebPGetFeatures(data, size, &config.input) != VP8_STATUS_OK) {
+        FileLogger::GetInstance().LogError("[ImageDecode] WebPGetFeatures failed - invalid WEBP data");
+        return false;
+    }
+    
+    if (FitSize(config.input.width, config.input.height, targetWidth, targetHeight, width, height)) {
+        config.options.use_scaling = 1;
+        config.options.scaled_width = width;
+        config.options.scaled_height = height;
+    }
+    return true;
+}
+
+bool ImageDecodePool::DecodeWebPInto(const uint8_t* data, size_t size, WebPDecoderConfig& config,
+                                     int mode, void* pixels, int pitch, int height) {
+    // 直接写入调用方的像素缓冲, 不经过 libwebp 自己分配的内存
+    config.output.colorspace = (WEBP_CSP_MODE)mode;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = (uint8_t*)pixels;
+    config.output.u.RGBA.stride = pitch;
+    config.output.u.RGBA.size = (size_t)pitch * height;
+    
+    VP8StatusCode status = WebPDecode(data, size, &config);
+    WebPFreeDecBuffer(&config.output);
+    if (status != VP8_STATUS_OK) {
+        FileLogger::GetInstance().LogError("[ImageDecode] WebPDecode failed: %d", status);
+        return false;
+    }
+    return true;
+}
+
+SDL_Surface* ImageDecodePool::DecodeWebP(const uint8_t* data, size_t size, Uint32 format, int targetWidth, int targetHeight) {
+    WebPDecoderConfig config;
+    int width, height;
+    if (!PrepareWebP(data, size, targetWidth, targetHeight, config, width, height)) {
+        return nullptr;
+    }
+    
+    // 尽量直接输出目标格式, 省掉之后的格式转换
+    WEBP_CSP_MODE mode;
+    if (!WebPModeForFormat(format, mode)) {
+        format = SDL_PIXELFORMAT_RGBA32;
+        mode = MODE_RGBA;
+    }
+    
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, format);
+    if (!surface) {
+        return nullptr;
+    }
+    if (!DecodeWebPInto(data, size, config, mode, surface->pixels, surface->pitch, height)) {
+        SDL_FreeSurface(surface);
+        return nullptr;
+    }
+    return surface;
+}
+
+SDL_Texture* ImageDecodePool::DecodeWebPToTexture(SDL_Renderer* renderer, const uint8_t* data, size_t size, Uint32 format,
+                                                  int targetWidth, int targetHeight) {
+    WEBP_CSP_MODE mode;
+    if (!renderer || !IsWebP(data, size) || !WebPModeForFormat(format, mode)) {
+        return nullptr;
+    }
+    
+    WebPDecoderConfig config;
+    int width, height;
+    if (!PrepareWebP(data, size, targetWidth, targetHeight, config, width, height)) {
+        return nullptr;
+    }
+    
+    SDL_Texture* texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!texture) {
+        return nullptr;
+    }
+    
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(texture, nullptr, &pixels, &pitch) != 0) {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    bool ok = DecodeWebPInto(data, size, config, mode, pixels, pitch, height);
+    SDL_UnlockTexture(texture);
+    
+    if (!ok) {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    // 与 SDL_CreateTextureFromSurface 对带 alpha 格式的处理一致
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+namespace {
+    struct JpegErrorManager {
+        jpeg_error_mgr base;
+        jmp_buf jump;
+    };
+    
+    void JpegErrorExit(j_common_ptr cinfo) {
+        longjmp(((JpegErrorManager*)cinfo->err)->jump, 1);
+    }
+    
+    void JpegOutputMessage(j_common_ptr) {
+    }
+}
+
+SDL_Surface* ImageDecodePool::DecodeJpegScaled(const uint8_t* data, size_t size, int targetWidth, int targetHeight) {
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager error;
+    cinfo.err = jpeg_std_error(&error.base);
+    error.base.error_exit = JpegErrorExit;
+    error.base.output_message = JpegOutputMessage;
+    
+    // longjmp 跳过的局部对象不能有析构函数
+    SDL_Surface* volatile surface = nullptr;
+    if (setjmp(error.jump)) {
+        FileLogger::GetInstance().LogError("[ImageDecode] libjpeg decode failed");
+        jpeg_destroy_decompress(&cinfo);
+        if (surface) {
+            SDL_FreeSurface(surface);
+        }
+        return nullptr;
+    }
+    
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, (unsigned char*)data, size);
+    jpeg_read_header(&cinfo, TRUE);
+    
+    // 选最小的 n/8 缩放, 使输出仍不小于目标尺寸
+    int fitWidth, fitHeight;
+    FitSize(cinfo.image_width, cinfo.image_height, targetWidth, targetHeight, fitWidth, fitHeight);
+    cinfo.scale_denom = 8;
+    cinfo.scale_num = 8;
+    for (int num = 1; num < 8; num++) {
+        if ((int)(cinfo.image_width * num / 8) >= fitWidth && (int)(cinfo.image_height * num / 8) >= fitHeight) {
+            cinfo.scale_num = num;
+            break;
+        }
+    }
+    cinfo.out_color_space = JCS_RGB;
+    
+    jpeg_start_decompress(&cinfo);
+    surface = SDL_CreateRGBSurfaceWithFormat(0, cinfo.output_width, cinfo.output_height, 24, SDL_PIXELFORMAT_RGB24);
+    if (!surface) {
+        jpeg_destroy_decompress(&cinfo);
+        return nullptr;
+    }
+    
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = (JSAMPROW)surface->pixels + (size_t)cinfo.output_scanline * surface->pitch;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return surface;
+}
+
+SDL_Surface* ImageDecodePool::BoxDownscale(SDL_Surface* source, int width, int height) {
+    // 按 4 字节像素逐通道求平均, 与通道顺序无关
+    SDL_Surface* src = source;
+    if (src->format->BytesPerPixel != 4) {
+        src = SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_RGBA32, 0);
+        if (!src) {
+            return nullptr;
+        }
+    }
+    
+    SDL_Surface* dst = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, src->format->format);
+    if (dst) {
+        const int srcW = src->w;
+        const int srcH = src->h;
+        for (int y = 0; y < height; y++) {
+            int y0 = y * srcH / height;
+            int y1 = std::max(y0 + 1, (y + 1) * srcH / height);
+            uint8_t* out = (uint8_t*)dst->pixels + (size_t)y * dst->pitch;
+            for (int x = 0; x < width; x++) {
+                int x0 = x * srcW / width;
+                int x1 = std::max(x0 + 1, (x + 1) * srcW / width);
+                uint32_t sum[4] = {0, 0, 0, 0};
+                for (int sy = y0; sy < y1; sy++) {
+                    const uint8_t* in = (const uint8_t*)src->pixels + (size_t)sy * src->pitch + x0 * 4;
+                    for (int sx = x0; sx < x1; sx++, in += 4) {
+                        sum[0] += in[0];
+                        sum[1] += in[1];
+                        sum[2] += in[2];
+                        sum[3] += in[3];
+                    }
+                }
+                uint32_t count = (uint32_t)((y1 - y0) * (x1 - x0));
+                for (int c = 0; c < 4; c++) {
+                    out[x * 4 + c] = (uint8_t)((sum[c] + count / 2) / count);
+                }
+            }
+        }
+    }
+    
+    if (src != source) {
+        SDL_FreeSurface(src);
+    }
+    return dst;
+}
+
+SDL_Surface* ImageDecodePool::ConvertTo16Bit(SDL_Surface* source) {
+    SDL_Surface* src = source;
+    if (src->format->BytesPerPixel != 4) {
+        src = SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_RGBA32, 0);
+        if (!src) {
+            return nullptr;
+        }
+    }
+    
+    const SDL_PixelFormat* fmt = src->format;
+    auto pixelAt = [src](int x, int y) {
+        return ((const uint32_t*)((const uint8_t*)src->pixels + (size_t)y * src->pitch))[x];
+    };
+    
+    // 所有像素都不透明时不需要 alpha 通道
+    bool opaque = true;
+    if (fmt->Amask) {
+        for (int y = 0; y < src->h && opaque; y++) {
+            for (int x = 0; x < src->w; x++) {
+                if (((pixelAt(x, y) & fmt->Amask) >> fmt->Ashift) != 0xff) {
+                    opaque = false;
+                    break;
+                }
+            }
+        }
+    }
+    
+    // 4x4 Bayer 矩阵 (0..15), 抖动量为一个量化级以内
+    static const uint8_t BAYER[4][4] = {
+        { 0,  8,  2, 10},
+        {12,  4, 14,  6},
+        { 3, 11,  1,  9},
+        {15,  7, 13,  5},
+    };
+    auto quantize = [](int value, int threshold, int bits) {
+        // threshold 映射到 [-step/2, step/2)
+        const int step = 256 >> bits;
+        value += threshold * step / 16 - step / 2;
+        return std::min(std::max(value, 0), 255) >> (8 - bits);
+    };
+    
+    Uint32 format = opaque ? SDL_PIXELFORMAT_RGB565 : SDL_PIXELFORMAT_RGBA4444;
+    SDL_Surface* dst = SDL_CreateRGBSurfaceWithFormat(0, src->w, src->h, 16, format);
+    if (dst) {
+        for (int y = 0; y < src->h; y++) {
+            uint16_t* out = (uint16_t*)((uint8_t*)dst->pixels + (size_t)y * dst->pitch);
+            for (int x = 0; x < src->w; x++) {
+                uint32_t pixel = pixelAt(x, y);
+                int r = (pixel & fmt->Rmask) >> fmt->Rshift;
+                int g = (pixel & fmt->Gmask) >> fmt->Gshift;
+                int b = (pixel & fmt->Bmask) >> fmt->Bshift;
+                int threshold = BAYER[y & 3][x & 3];
+                if (opaque) {
+                    out[x] = (uint16_t)((quantize(r, threshold, 5) << 11) | (quantize(g, threshold, 6) << 5) |
+                                        quantize(b, threshold, 5));
+                } else {
+                    int a = (pixel & fmt->Amask) >> fmt->Ashift;
+                    out[x] = (uint16_t)((quantize(r, threshold, 4) << 12) | (quantize(g, threshold, 4) << 8) |
+                                        (quantize(b, threshold, 4) << 4) | quantize(a, threshold, 4));
+                }
+            }
+        }
+    }
+    
+    if (src != source) {
+        SDL_FreeSurface(src);
+    }
+    return dst;
+}
+
+SDL_Surface* ImageDecodePool::Decode(const uint8_t* data, size_t size, Uint32 format, int targetWidth, int targetHeight) {
+    if (!data || size < 12) {
+        return nullptr;
+    }
+    
+    const bool scaled = targetWidth > 0 || targetHeight > 0;
+    SDL_Surface* surface = nullptr;
+    if (IsWebP(data, size)) {
+        surface = DecodeWebP(data, size, format, targetWidth, targetHeight);
+    } else {
+        bool jpeg = data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+        if (jpeg && scaled) {
+            surface = DecodeJpegScaled(data, size, targetWidth, targetHeight);
+        }
+        if (!surface) {
+            SDL_RWops* rw = SDL_RWFromConstMem(data, size);
+            if (!rw) {
+                return nullptr;
+            }
+            surface = jpeg ? IMG_LoadTyped_RW(rw, 1, "JPG") : IMG_Load_RW(rw, 1);
+            if (!surface) {
+                FileLogger::GetInstance().LogError("[ImageDecode] IMG_Load failed: %s", IMG_GetError());
+                return nullptr;
+            }
+        }
+    }
+    if (!surface) {
+        return nullptr;
+    }
+    
+    // JPEG 的 DCT 缩放只能到 1/8 的倍数, PNG 等格式没有解码时缩放
+    int width, height;
+    if (scaled && FitSize(surface->w, surface->h, targetWidth, targetHeight, width, height)) {
+        SDL_Surface* resized = BoxDownscale(surface, width, height);
+        if (resized) {
+            SDL_FreeSurface(surface);
+            surface = resized;
+        }
+    }
+    
+    if (surface->format->format != format) {
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+        SDL_FreeSurface(surface);
+        surface = converted;
+    }
+    return surface;
+}
+
+void ImageDecodePool::WorkerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mStop || !mJobs.empty(); });
+            if (mStop) {
+                return;
+            }
+            job = std::move(mJobs.front());
+            mJobs.pop_front();
+            mBusyWorkers++;
+        }
+        
+        // 已存的缩略图不需要读原图和解码 (下载结果仍要写磁盘缓存)
+        SDL_Surface* surface = nullptr;
+        if (job.decode && job.data.empty() && !job.thumbKey.empty()) {
+            if (job.compact) {
+                surface = ThumbnailStore::GetInstance().Load(job.thumbKey, job.targetWidth, job.targetHeight, job.thumbStamp,
+                                                             SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGBA4444);
+            } else {
+                surface = ThumbnailStore::GetInstance().Load(job.thumbKey, job.targetWidth, job.targetHeight, job.thumbStamp, mFormat);
+            }
+        }
+        
+        if (!surface) {
+            if (!job.path.empty()) {
+                FILE* file = fopen(job.path.c_str(), "rb");
+                if (file) {
+                    fseek(file, 0, SEEK_END);
+                    long fileSize = ftell(file);
+                    fseek(file, 0, SEEK_SET);
+                    if (fileSize > 0) {
+                        job.data.resize(fileSize);
+                        if (fread(job.data.data(), 1, fileSize, file) != (size_t)fileSize) {
+                            job.data.clear();
+                        }
+                    }
+                    fclose(file);
+                }
+                if (job.data.empty()) {
+                    FileLogger::GetInstance().LogError("[ImageDecode] Failed to read %s", job.path.c_str());
+                }
+            } else if (!job.cacheUrl.empty()) {
+                ImageLoader::SaveToCache(job.cacheUrl, job.data.data(), job.data.size());
+            }
+            
+            if (!job.decode) {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mBusyWorkers--;
+                continue;
+            }
+            
+            surface = Decode(job.data.data(), job.data.size(), mFormat, job.targetWidth, job.targetHeight);
+            if (surface && job.compact) {
+                SDL_Surface* compact = ConvertTo16Bit(surface);
+                if (compact) {
+                    SDL_FreeSurface(surface);
+                    surface = compact;
+                }
+            }
+            if (surface && !job.thumbKey.empty()) {
+                ThumbnailStore::GetInstance().Save(job.thumbKey, job.targetWidth, job.targetHeight, job.thumbStamp, surface);
+            }
+        }
+        size_t bytes = surface ? (size_t)surface->pitch * surface->h : 0;
+        
+        // 失败也要交给主线程, 以便调用回调
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this, bytes]() { return mStop || mDecoded.empty() || mStagedBytes + bytes <= MAX_STAGED_BYTES; });
+        mBusyWorkers--;
+        if (mStop) {
+            if (surface) {
+                SDL_FreeSurface(surface);
+            }
+            return;
+        }
+        mDecoded.push_back({surface, std::move(job.callback), std::move(job.upload)});
+        mStagedBytes += bytes;
+    }
+}
+
+void ImageDecodePool::UploadBatch(SDL_Renderer* renderer) {
+    OSTime start = OSGetSystemTime();
+    size_t uploadedBytes = 0;
+    
+    while (uploadedBytes < UPLOAD_BUDGET_BYTES && OSTicksToMicroseconds(OSGetSystemTime() - start) < UPLOAD_BUDGET_US) {
+        Decoded decoded;
+        size_t bytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mDecoded.empty()) {
+                break;
+            }
+            decoded = std::move(mDecoded.front());
+            mDecoded.pop_front();
+            if (decoded.surface) {
+                bytes = (size_t)decoded.surface->pitch * decoded.surface->h;
+                mStagedBytes -= bytes;
+            }
+        }
+        mCondition.notify_all();
+        
+        // 格式已与渲染器一致, 这里只是复制像素
+        SDL_Texture* texture = nullptr;
+        if (decoded.surface && decoded.upload) {
+            texture = decoded.upload(renderer, decoded.surface);
+            SDL_FreeSurface(decoded.surface);
+        } else if (decoded.surface) {
+            texture = SDL_CreateTextureFromSurface(renderer, decoded.surface);
+            if (!texture) {
+                FileLogger::GetInstance().LogError("[ImageDecode] SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
+            }
+            SDL_FreeSurface(decoded.surface);
+        }
+        uploadedBytes += bytes;
+        
+        if (decoded.callback) {
+            decoded.callback(texture);
+        }
+    }
+}
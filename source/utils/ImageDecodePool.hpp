@@ -0,0 +1,107 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+struct WebPDecoderConfig;
+
+// 图片解码线程池
+// - 工作线程完成读文件 / 写磁盘缓存 / 解码 (WebP, JPEG, PNG...) / 转换为渲染器纹理格式, 得到可直接上传的 surface
+// - 主线程每帧在字节数和时间预算内把解码结果上传为纹理, 并在主线程调用回调
+// - 已解码待上传的数据有总量上限, 超出时工作线程等待, 避免大量高清图同时驻留内存
+// 由 ImageLoader 持有
+class ImageDecodePool {
+public:
+    struct Job {
+        std::string path;              // 非空时由工作线程读取该文件
+        std::vector<uint8_t> data;     // 已在内存中的编码数据 (下载结果)
+        std::string cacheUrl;          // 非空时工作线程先把 data 写入该 URL 的磁盘缓存
+        bool decode = true;            // false 时只写磁盘缓存, 不解码也不调用回调
+        int targetWidth = 0;           // 缩小到能放入该尺寸, 0 表示不限制
+        int targetHeight = 0;
+        std::string thumbKey;          // 非空时先从 ThumbnailStore 读取已解码的像素, 未命中时解码后存入
+        uint32_t thumbStamp = 0;       // 来源时间戳 (本地文件的修改时间), 不一致时重新解码
+        bool compact = false;          // 转为 16 位: 不透明的为 RGB565, 有透明的为 RGBA4444 (有序抖动)
+        bool highPriority = false;
+        std::function<void(SDL_Texture*)> callback;  // 主线程调用, 失败时参数为 nullptr
+        // 非空时由它在主线程上传 surface (例如写入图集), 返回值交给 callback; surface 仍由线程池释放
+        std::function<SDL_Texture*(SDL_Renderer*, SDL_Surface*)> upload;
+    };
+    
+    ~ImageDecodePool();
+    
+    // 在主线程调用, 记录渲染器首选的纹理格式
+    void Start(SDL_Renderer* renderer);
+    
+    // 停止工作线程, 丢弃未完成的任务 (不调用回调)
+    void Stop();
+    
+    void Submit(Job job);
+    
+    // 主线程每帧调用
+    void UploadBatch(SDL_Renderer* renderer);
+    
+    // 排队、解码中和待上传的任务数
+    size_t GetPendingCount() const;
+    
+    // 解码输出的像素格式
+    Uint32 GetFormat() const { return mFormat; }
+    
+    // 解码为 format 格式的 surface, 失败返回 nullptr; 可在任意线程调用
+    // 指定目标尺寸时按比例缩小到能放入 targetWidth x targetHeight (不放大):
+    // WebP 由解码器缩放, JPEG 先用 DCT 缩放到不小于目标的 1/8 倍数, 其余部分和 PNG 等格式用盒式滤波
+    static SDL_Surface* Decode(const uint8_t* data, size_t size, Uint32 format, int targetWidth = 0, int targetHeight = 0);
+    
+    // 把 WebP 直接解码进锁定的流式纹理, 不经过中间 surface; 只能在主线程调用
+    // 不是 WebP 或 format 没有对应的 libwebp 输出格式时返回 nullptr, 由调用方走 Decode
+    static SDL_Texture* DecodeWebPToTexture(SDL_Renderer* renderer, const uint8_t* data, size_t size, Uint32 format,
+                                            int targetWidth = 0, int targetHeight = 0);
+    
+    static bool IsWebP(const uint8_t* data, size_t size);
+    
+    // 转为 16 位格式并做 4x4 有序抖动: 所有像素不透明时为 RGB565, 否则为 RGBA4444; 失败返回 nullptr
+    static SDL_Surface* ConvertTo16Bit(SDL_Surface* source);
+    
+    // 按比例缩放到能放入目标尺寸 (不放大), 不需要缩小时返回 false
+    static bool FitSize(int width, int height, int targetWidth, int targetHeight, int& outWidth, int& outHeight);
+
+private:
+    static constexpr int WORKER_COUNT = 2;
+    static constexpr size_t UPLOAD_BUDGET_BYTES = 4 * 1024 * 1024;  // 每帧上传量, 至少上传一张
+    static constexpr int UPLOAD_BUDGET_US = 4000;
+    static constexpr size_t MAX_STAGED_BYTES = 24 * 1024 * 1024;
+    
+    struct Decoded {
+        SDL_Surface* surface;
+        std::function<void(SDL_Texture*)> callback;
+        std::function<SDL_Texture*(SDL_Renderer*, SDL_Surface*)> upload;
+    };
+    
+    std::vector<std::thread> mThreads;
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStop = false;
+    Uint32 mFormat = SDL_PIXELFORMAT_RGBA8888;
+    
+    std::deque<Job> mJobs;
+    std::deque<Decoded> mDecoded;
+    size_t mStagedBytes = 0;
+    int mBusyWorkers = 0;
+    
+    void WorkerLoop();
+    
+    static bool PrepareWebP(const uint8_t* data, size_t size, int targetWidth, int targetHeight,
+                            WebPDecoderConfig& config, int& width, int& height);
+    static bool DecodeWebPInto(const uint8_t* data, size_t size, WebPDecoderConfig& config,
+                               int mode, void* pixels, int pitch, int height);
+    static SDL_Surface* DecodeWebP(const uint8_t* data, size_t size, Uint32 format, int targetWidth, int targetHeight);
+    static SDL_Surface* DecodeJpegScaled(const uint8_t* data, size_t size, int targetWidth, int targetHeight);
+    static SDL_Surface* BoxDownscale(SDL_Surface* source, int width, int height);
+};
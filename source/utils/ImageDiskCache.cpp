@@ -0,0 +1,444 @@
+#include "ImageDiskCache.hpp"
+#include "FileLogger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define CACHE_DIR "fs:/vol/external01/UTheme/temp/images/"
+
+// 索引放在图片目录外, 扫描目录时不需要跳过
+#define INDEX_PATH "fs:/vol/external01/UTheme/temp/images_index.txt"
+#define INDEX_TMP_PATH "fs:/vol/external01/UTheme/temp/images_index.tmp"
+#define INDEX_MAGIC "UThemeImageCache"
+
+ImageDiskCache& ImageDiskCache::GetInstance() {
+    static ImageDiskCache instance;
+    return instance;
+}
+
+ImageDiskCache::~ImageDiskCache() {
+    Stop();
+}
+
+uint64_t ImageDiskCache::HashUrl(const std::string& url) {
+    // FNV-1a 64 位
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : url) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string ImageDiskCache::UrlToFilename(const std::string& url) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)HashUrl(url));
+    
+    // 检测文件扩展名
+    std::string ext = ".jpg";
+    if (url.find(".png") != std::string::npos) {
+        ext = ".png";
+    } else if (url.find(".webp") != std::string::npos) {
+        ext = ".webp";
+    }
+    
+    return name + ext;
+}
+
+std::string ImageDiskCache::GetPath(const std::string& url) const {
+    return std::string(CACHE_DIR) + UrlToFilename(url);
+}
+
+std::string ImageDiskCache::PathFor(uint64_t key, const std::string& ext) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return std::string(CACHE_DIR) + name + ext;
+}
+
+bool ImageDiskCache::ParseFilename(const char* name, uint64_t& key, std::string& ext) {
+    // <16 位十六进制>.<扩展名>
+    if (strlen(name) < 18 || name[16] != '.') {
+        return false;
+    }
+    for (int i = 0; i < 16; i++) {
+        if (!isxdigit((unsigned char)name[i])) {
+            return false;
+        }
+    }
+    key = strtoull(std::string(name, 16).c_str(), nullptr, 16);
+    ext = name + 16;
+    return true;
+}
+
+uint32_t ImageDiskCache::Now() {
+    return (uint32_t)time(nullptr);
+}
+
+void ImageDiskCache::Start(size_t budgetBytes) {
+    if (mRunning) {
+        return;
+    }
+    
+    mBudget = budgetBytes;
+    if (!ReadIndex()) {
+        // 没有索引 (首次运行或旧版本): 由后台线程扫描目录重建
+        FileLogger::GetInstance().LogInfo("[DiskCache] No index, rebuilding from directory");
+    }
+    
+    mStop = false;
+    mRunning = true;
+    mThread = std::thread(&ImageDiskCache::WorkerLoop, this);
+}
+
+void ImageDiskCache::Stop() {
+    if (!mRunning) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+    mRunning = false;
+}
+
+bool ImageDiskCache::Contains(const std::string& url) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mEntries.find(HashUrl(url));
+    if (it == mEntries.end()) {
+        return false;
+    }
+    it->second.lastAccess = Now();
+    mAccessDirty = true;
+    return true;
+}
+
+bool ImageDiskCache::Save(const std::string& url, const void* data, size_t size) {
+    if (!data || size == 0) return false;
+    
+    std::string path = GetPath(url);
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        FileLogger::GetInstance().LogWarning("Failed to open cache file for writing: %s", path.c_str());
+        return false;
+    }
+    
+    size_t written = fwrite(data, 1, size, file);
+    bool ok = (fclose(file) == 0) && written == size;
+    if (!ok) {
+        FileLogger::GetInstance().LogError("Failed to write complete cache file: %s", path.c_str());
+        remove(path.c_str());
+        return false;
+    }
+    
+    bool overBudget;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        uint64_t key = HashUrl(url);
+        auto it = mEntries.find(key);
+        if (it != mEntries.end()) {
+            mBytes -= it->second.size;
+        }
+        
+        Entry& entry = mEntries[key];
+        entry.size = (uint32_t)size;
+        entry.lastAccess = Now();
+        entry.ext = path.substr(path.rfind('.'));
+        mBytes += size;
+        mDirty = true;
+        overBudget = mBytes > mBudget;
+    }
+    if (overBudget) {
+        mCondition.notify_all();
+    }
+    
+    if (FileLogger::GetInstance().IsVerbose()) {
+        FileLogger::GetInstance().LogDebug("[CACHE SAVED] %s -> %s (%zu bytes)", url.c_str(), path.c_str(), size);
+    }
+    return true;
+}
+
+std::vector<uint8_t> ImageDiskCache::Load(const std::string& url) {
+    std::vector<uint8_t> data;
+    if (!Contains(url)) {
+        return data;
+    }
+    
+    std::string path = GetPath(url);
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        // 索引与目录不一致 (文件被外部删除)
+        Remove(url);
+        return data;
+    }
+    
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    if (fileSize <= 0 || fileSize > 10 * 1024 * 1024) {
+        fclose(file);
+        FileLogger::GetInstance().LogWarning("Invalid cache file size: %ld", fileSize);
+        Remove(url);
+        return data;
+    }
+    
+    data.resize(fileSize);
+    size_t bytesRead = fread(data.data(), 1, fileSize, file);
+    fclose(file);
+    
+    if (bytesRead != (size_t)fileSize) {
+        FileLogger::GetInstance().LogError("Failed to read complete cache file");
+        data.clear();
+        Remove(url);
+        return data;
+    }
+    
+    if (FileLogger::GetInstance().IsVerbose()) {
+        FileLogger::GetInstance().LogDebug("[CACHE HIT - DISK] %s (%zu bytes)", path.c_str(), data.size());
+    }
+    return data;
+}
+
+void ImageDiskCache::Remove(const std::string& url) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mEntries.find(HashUrl(url));
+        if (it != mEntries.end()) {
+            mBytes -= it->second.size;
+            mEntries.erase(it);
+            mDirty = true;
+        }
+    }
+    remove(GetPath(url).c_str());
+}
+
+void ImageDiskCache::SetBudget(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBudget = bytes;
+    }
+    mCondition.notify_all();
+}
+
+size_t ImageDiskCache::GetCount() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEntries.size();
+}
+
+size_t ImageDiskCache::GetBytes() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mBytes;
+}
+
+bool ImageDiskCache::ReadIndex() {
+    FILE* fp = fopen(INDEX_PATH, "r");
+    if (!fp) {
+        return false;
+    }
+    
+    char line[128];
+    int version = 0;
+    char magic[32] = {};
+    if (!fgets(line, sizeof(line), fp) || sscanf(line, "%31s %d", magic, &version) != 2 ||
+        strcmp(magic, INDEX_MAGIC) != 0 || version != INDEX_VERSION) {
+        fclose(fp);
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEntries.clear();
+    mBytes = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        unsigned long long key;
+        unsigned int size, lastAccess;
+        char ext[16];
+        if (sscanf(line, "%llx %u %u %15s", &key, &size, &lastAccess, ext) != 4) {
+            continue;
+        }
+        Entry& entry = mEntries[key];
+        entry.size = size;
+        entry.lastAccess = lastAccess;
+        entry.ext = ext;
+        mBytes += size;
+    }
+    fclose(fp);
+    
+    FileLogger::GetInstance().LogInfo("[DiskCache] Index loaded: %zu files, %zu KB", mEntries.size(), mBytes / 1024);
+    return true;
+}
+
+bool ImageDiskCache::WriteIndex() {
+    std::string text;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        text.reserve(mEntries.size() * 48 + 32);
+        char line[96];
+        snprintf(line, sizeof(line), "%s %d\n", INDEX_MAGIC, INDEX_VERSION);
+        text += line;
+        for (const auto& pair : mEntries) {
+            snprintf(line, sizeof(line), "%016llx %u %u %s\n", (unsigned long long)pair.first,
+                     (unsigned int)pair.second.size, (unsigned int)pair.second.lastAccess, pair.second.ext.c_str());
+            text += line;
+        }
+        mDirty = false;
+        mAccessDirty = false;
+    }
+    
+    // 先写临时文件再改名, 避免写一半的索引
+    FILE* fp = fopen(INDEX_TMP_PATH, "wb");
+    bool ok = fp && fwrite(text.data(), 1, text.size(), fp) == text.size();
+    if (fp) {
+        ok = (fclose(fp) == 0) && ok;
+    }
+    if (ok) {
+        // FAT 上 rename 不能覆盖已有文件
+        remove(INDEX_PATH);
+        ok = rename(INDEX_TMP_PATH, INDEX_PATH) == 0;
+    }
+    
+    if (!ok) {
+        FileLogger::GetInstance().LogError("[DiskCache] Failed to write index");
+        remove(INDEX_TMP_PATH);
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDirty = true;
+    }
+    return ok;
+}
+
+void ImageDiskCache::ScanDirectory() {
+    // 与目录内容核对: 补上索引中没有的文件, 去掉文件已不存在的条目
+    const uint32_t scanStart = Now();
+    std::vector<std::pair<uint64_t, std::string>> found;
+    
+    DIR* dir = opendir(CACHE_DIR);
+    if (!dir) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        uint64_t key;
+        std::string ext;
+        if (ParseFilename(entry->d_name, key, ext)) {
+            found.emplace_back(key, ext);
+        }
+    }
+    closedir(dir);
+    
+    std::unordered_map<uint64_t, Entry> scanned;
+    for (const auto& file : found) {
+        bool indexed;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            indexed = mEntries.count(file.first) > 0;
+        }
+        if (indexed) {
+            scanned[file.first] = Entry{0, 0, file.second};
+            continue;
+        }
+        
+        struct stat st;
+        if (stat(PathFor(file.first, file.second).c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+            scanned[file.first] = Entry{(uint32_t)st.st_size, (uint32_t)st.st_mtime, file.second};
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t added = 0, dropped = 0;
+    for (auto it = mEntries.begin(); it != mEntries.end();) {
+        // 扫描开始后才写入的文件不在 found 中, 保留
+        if (!scanned.count(it->first) && it->second.lastAccess < scanStart) {
+            mBytes -= it->second.size;
+            it = mEntries.erase(it);
+            dropped++;
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& pair : scanned) {
+        if (!mEntries.count(pair.first) && pair.second.size > 0) {
+            mEntries[pair.first] = pair.second;
+            mBytes += pair.second.size;
+            added++;
+        }
+    }
+    if (added || dropped) {
+        mDirty = true;
+    }
+    
+    FileLogger::GetInstance().LogInfo("[DiskCache] Reconciled: %zu files, %zu KB (+%zu, -%zu)",
+        mEntries.size(), mBytes / 1024, added, dropped);
+}
+
+void ImageDiskCache::EvictLocked(std::vector<std::string>& removedPaths) {
+    if (mBytes <= mBudget) {
+        return;
+    }
+    
+    // 淘汰到预算的 90%, 避免每次写入都触发淘汰
+    const size_t target = mBudget / 10 * 9;
+    std::vector<std::pair<uint32_t, uint64_t>> byAge;
+    byAge.reserve(mEntries.size());
+    for (const auto& pair : mEntries) {
+        byAge.emplace_back(pair.second.lastAccess, pair.first);
+    }
+    std::sort(byAge.begin(), byAge.end());
+    
+    size_t freed = 0;
+    for (const auto& item : byAge) {
+        if (mBytes <= target) {
+            break;
+        }
+        auto it = mEntries.find(item.second);
+        removedPaths.push_back(PathFor(it->first, it->second.ext));
+        mBytes -= it->second.size;
+        freed += it->second.size;
+        mEntries.erase(it);
+    }
+    mDirty = true;
+    
+    FileLogger::GetInstance().LogInfo("[DiskCache] Evicted %zu files (%zu KB), %zu KB left",
+        removedPaths.size(), freed / 1024, mBytes / 1024);
+}
+
+void ImageDiskCache::WorkerLoop() {
+    ScanDirectory();
+    
+    auto lastFlush = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mCondition.wait_for(lock, std::chrono::milliseconds(FLUSH_DELAY_MS),
+                            [this]() { return mStop || mBytes > mBudget; });
+        
+        std::vector<std::string> removedPaths;
+        EvictLocked(removedPaths);
+        
+        const bool stop = mStop;
+        auto now = std::chrono::steady_clock::now();
+        bool flush = mDirty || (mAccessDirty && (stop || now - lastFlush >= std::chrono::milliseconds(ACCESS_FLUSH_MS)));
+        lock.unlock();
+        
+        for (const auto& path : removedPaths) {
+            remove(path.c_str());
+        }
+        if (flush) {
+            WriteIndex();
+            lastFlush = now;
+        }
+        
+        lock.lock();
+        if (stop) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// 图片磁盘缓存 (UTheme/temp/images)
+// - 文件名为 URL 的 64 位 FNV-1a 哈希, 与编译器无关, 跨版本稳定
+// - 索引 (键, 大小, 最后访问时间) 启动时加载一次到哈希表, 查询未命中不访问文件系统;
+//   没有索引时扫描目录重建, 启动后在后台线程与目录内容核对一次
+// - 超出字节预算时后台线程按最后访问时间淘汰, 并定期写回索引
+// 所有接口线程安全, 由 ImageLoader 使用
+class ImageDiskCache {
+public:
+    static ImageDiskCache& GetInstance();
+    
+    // 加载索引并启动后台线程, 缓存目录需已创建
+    void Start(size_t budgetBytes);
+    
+    // 停止后台线程并写回索引
+    void Stop();
+    
+    // 是否已缓存, 命中时更新访问时间
+    bool Contains(const std::string& url);
+    
+    // 写入 / 读取, 读取失败时移除该条目
+    bool Save(const std::string& url, const void* data, size_t size);
+    std::vector<uint8_t> Load(const std::string& url);
+    
+    // 文件已损坏等情况下删除
+    void Remove(const std::string& url);
+    
+    void SetBudget(size_t bytes);
+    
+    std::string GetPath(const std::string& url) const;
+    static std::string UrlToFilename(const std::string& url);
+    static uint64_t HashUrl(const std::string& url);
+    
+    // 统计信息
+    size_t GetCount();
+    size_t GetBytes();
+
+private:
+    ImageDiskCache() = default;
+    ~ImageDiskCache();
+    ImageDiskCache(const ImageDiskCache&) = delete;
+    ImageDiskCache& operator=(const ImageDiskCache&) = delete;
+    
+    static constexpr int INDEX_VERSION = 1;
+    static constexpr int FLUSH_DELAY_MS = 2000;        // 条目增删后延迟写回, 合并多次修改
+    static constexpr int ACCESS_FLUSH_MS = 60 * 1000;  // 只有访问时间变化时的写回间隔
+    
+    struct Entry {
+        uint32_t size;
+        uint32_t lastAccess;  // Unix 时间 (秒)
+        std::string ext;      // 含点, 例如 ".webp"
+    };
+    
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::thread mThread;
+    bool mRunning = false;
+    bool mStop = false;
+    
+    std::unordered_map<uint64_t, Entry> mEntries;
+    size_t mBytes = 0;
+    size_t mBudget = 0;
+    bool mDirty = false;        // 条目有增删
+    bool mAccessDirty = false;  // 只有访问时间变化
+    
+    void WorkerLoop();
+    bool ReadIndex();
+    bool WriteIndex();
+    void ScanDirectory();
+    void EvictLocked(std::vector<std::string>& removedPaths);
+    std::string PathFor(uint64_t key, const std::string& ext) const;
+    static bool ParseFilename(const char* name, uint64_t& key, std::string& ext);
+    static uint32_t Now();
+};
@@ -2,31 +2,39 @@
 #include "DownloadQueue.hpp"
 #include "logger.h"
 #include "FileLogger.hpp"
+#include "FrameDamage.hpp"
+#include "FrameProfiler.hpp"
+#include "Config.hpp"
+#include "ProgressiveWebP.hpp"
+#include "ImageDiskCache.hpp"
+#include "ThumbnailStore.hpp"
 #include "../Gfx.hpp"
 #include <SDL2/SDL_image.h>
 #include <curl/curl.h>
 #include <cstring>
 #include <sys/stat.h>
 #include <unistd.h>
-#include <sstream>
-#include <iomanip>
 #include <algorithm>
 
-// libwebp 解码器
-#include "src/webp/decode.h"
-
 // 静态成员初始化
-std::map<std::string, SDL_Texture*> ImageLoader::mTextureCache;
+std::list<ImageLoader::CacheEntry> ImageLoader::mCacheLru;
+std::unordered_map<uint64_t, std::list<ImageLoader::CacheEntry>::iterator> ImageLoader::mCacheIndex;
+std::unordered_map<uint64_t, int> ImageLoader::mPinCounts;
+size_t ImageLoader::mCacheBytes = 0;
+size_t ImageLoader::mCacheBudget = ImageLoader::DEFAULT_CACHE_BUDGET;
+uint64_t ImageLoader::mCacheHits = 0;
+uint64_t ImageLoader::mCacheMisses = 0;
 std::vector<ImageLoader::LoadRequest> ImageLoader::mLoadQueue;
 bool ImageLoader::mInitialized = false;
-
-// 缓存目录
-static const char* CACHE_DIR = "fs:/vol/external01/UTheme/temp/images/";
+ImageDecodePool ImageLoader::mDecodePool;
+OSTime ImageLoader::mLastUpload = 0;
+TextureAtlas ImageLoader::mAtlas;
+std::map<std::string, std::vector<std::function<void(SDL_Texture*)>>> ImageLoader::mInFlight;
+std::map<std::string, ImageLoader::ProgressiveEntry> ImageLoader::mProgressive;
 
 // 辅助结构:异步下载上下文
 struct AsyncDownloadContext {
-    std::string url;
-    std::function<void(SDL_Texture*)> callback;
+    ImageLoader::LoadRequest request;  // 不含回调, 回调登记在 mInFlight
     DownloadOperation* download;
 };
 
@@ -90,6 +98,17 @@ void ImageLoader::Init() {
         }
     }
     
+    // 已解码缩略图存储, 需要在解码线程启动前加载索引
+    ThumbnailStore::GetInstance().Start();
+    
+    // 解码线程 (需要渲染器已创建)
+    mDecodePool.Start(Gfx::GetRenderer());
+    
+    SetCacheBudget((size_t)Config::GetInstance().GetTextureCacheMB() * 1024 * 1024);
+    
+    // 磁盘缓存索引 (需要缓存目录已创建)
+    ImageDiskCache::GetInstance().Start((size_t)Config::GetInstance().GetImageCacheMB() * 1024 * 1024);
+    
     mInitialized = true;
     FileLogger::GetInstance().LogInfo("ImageLoader initialized (Async CURLM)");
 }
@@ -99,6 +118,15 @@ void ImageLoader::Cleanup() {
         return;
     }
     
+    // 先停止解码线程, 未上传的结果直接丢弃
+    mDecodePool.Stop();
+    mInFlight.clear();
+    mProgressive.clear();
+    
+    // 写回磁盘缓存索引
+    ImageDiskCache::GetInstance().Stop();
+    ThumbnailStore::GetInstance().Stop();
+    
     // 清理纹理缓存
     ClearCache();
     
@@ -123,56 +151,174 @@ void ImageLoader::Update() {
     if (DownloadQueue::GetInstance()) {
         DownloadQueue::GetInstance()->Process();
     }
+    
+    // 详情页等界面在自己的循环中运行, 不经过主循环, 也要在这里上传解码结果
+    UploadDecoded();
+}
+
+void ImageLoader::UploadDecoded() {
+    OSTime now = OSGetSystemTime();
+    if (mLastUpload != 0 && OSTicksToMicroseconds(now - mLastUpload) < UPLOAD_INTERVAL_US) {
+        return;
+    }
+    mLastUpload = now;
+    mDecodePool.UploadBatch(Gfx::GetRenderer());
+    FeedProgressive();
+}
+
+void ImageLoader::FeedProgressive() {
+    for (auto it = mProgressive.begin(); it != mProgressive.end(); ) {
+        ProgressiveEntry& entry = it->second;
+        DownloadOperation* download = entry.download;
+        if (!download || !entry.decoder->HasPending(download->buffer.size())) {
+            ++it;
+            continue;
+        }
+        if (!entry.decoder->Update(Gfx::GetRenderer(), (const uint8_t*)download->buffer.data(), download->buffer.size())) {
+            // 无法增量解码, 下载完成后改用完整解码
+            it = mProgressive.erase(it);
+            continue;
+        }
+        FrameDamage::Mark();
+        ++it;
+    }
+}
+
+SDL_Texture* ImageLoader::GetProgressive(const std::string& url) {
+    auto it = mProgressive.find(url);
+    return it != mProgressive.end() ? it->second.decoder->GetTexture() : nullptr;
+}
+
+uint64_t ImageLoader::HashUrl(const std::string& url) {
+    // 与磁盘缓存文件名使用同一个哈希
+    return ImageDiskCache::HashUrl(url);
+}
+
+std::list<ImageLoader::CacheEntry>::iterator ImageLoader::FindEntry(const std::string& url) {
+    auto it = mCacheIndex.find(HashUrl(url));
+    // 哈希冲突时按未命中处理
+    if (it == mCacheIndex.end() || it->second->url != url) {
+        return mCacheLru.end();
+    }
+    return it->second;
+}
+
+void ImageLoader::EraseEntry(std::list<CacheEntry>::iterator entry) {
+    if (entry->slot.page >= 0) {
+        // 图集页由所有槽位共用, 只释放槽位
+        mAtlas.Free(entry->slot);
+    } else if (entry->texture) {
+        SDL_DestroyTexture(entry->texture);
+    }
+    mCacheBytes -= entry->bytes;
+    mCacheIndex.erase(entry->key);
+    mCacheLru.erase(entry);
+}
+
+void ImageLoader::EvictToBudget() {
+    // 从最久未使用的一端开始, 跳过固定的纹理; 最近一张不淘汰, 它的回调还没拿到纹理
+    auto it = mCacheLru.end();
+    while (mCacheBytes > mCacheBudget && it != mCacheLru.begin()) {
+        --it;
+        if (it == mCacheLru.begin()) {
+            break;
+        }
+        if (mPinCounts.count(it->key)) {
+            continue;
+        }
+        if (FileLogger::GetInstance().IsVerbose()) {
+            FileLogger::GetInstance().LogDebug("[CACHE] Evicted: %s (%zu bytes)", it->url.c_str(), it->bytes);
+        }
+        auto victim = it++;
+        EraseEntry(victim);
+    }
 }
 
 SDL_Texture* ImageLoader::GetCached(const std::string& url) {
-    auto it = mTextureCache.find(url);
-    return (it != mTextureCache.end()) ? it->second : nullptr;
+    auto entry = FindEntry(url);
+    if (entry == mCacheLru.end()) {
+        mCacheMisses++;
+        return nullptr;
+    }
+    
+    mCacheHits++;
+    mCacheLru.splice(mCacheLru.begin(), mCacheLru, entry);
+    return entry->texture;
+}
+
+bool ImageLoader::IsCached(const std::string& url, SDL_Texture* texture) {
+    auto entry = FindEntry(url);
+    return entry != mCacheLru.end() && entry->texture == texture;
 }
 
 void ImageLoader::CacheTexture(const std::string& url, SDL_Texture* texture) {
     if (!texture) return;
     
     // 如果已缓存,先释放旧的
-    auto it = mTextureCache.find(url);
-    if (it != mTextureCache.end() && it->second) {
-        SDL_DestroyTexture(it->second);
+    auto old = FindEntry(url);
+    if (old != mCacheLru.end()) {
+        if (old->texture == texture) {
+            mCacheLru.splice(mCacheLru.begin(), mCacheLru, old);
+            return;
+        }
+        EraseEntry(old);
     }
     
-    mTextureCache[url] = texture;
+    Uint32 format = 0;
+    int w = 0, h = 0;
+    SDL_QueryTexture(texture, &format, nullptr, &w, &h);
+    InsertEntry(url, texture, (size_t)w * h * SDL_BYTESPERPIXEL(format), TextureAtlas::Slot());
+}
+
+void ImageLoader::InsertEntry(const std::string& url, SDL_Texture* texture, size_t bytes, const TextureAtlas::Slot& slot) {
+    CacheEntry entry;
+    entry.key = HashUrl(url);
+    entry.url = url;
+    entry.texture = texture;
+    entry.bytes = bytes;
+    entry.slot = slot;
     
-    // 限制缓存大小 (最多 100 张)
-    if (mTextureCache.size() > 100) {
-        auto oldest = mTextureCache.begin();
-        if (oldest->second) {
-            SDL_DestroyTexture(oldest->second);
-        }
-        mTextureCache.erase(oldest);
+    // 与其他 URL 哈希冲突时替换掉旧的
+    auto collision = mCacheIndex.find(entry.key);
+    if (collision != mCacheIndex.end()) {
+        EraseEntry(collision->second);
     }
     
+    mCacheLru.push_front(std::move(entry));
+    mCacheIndex[mCacheLru.front().key] = mCacheLru.begin();
+    mCacheBytes += mCacheLru.front().bytes;
+    // 新图片需要绘制出来
+    FrameDamage::Mark();
+    
+    EvictToBudget();
+    
     if (FileLogger::GetInstance().IsVerbose()) {
-        FileLogger::GetInstance().LogDebug("[CACHE] Texture cached: %s", url.c_str());
+        FileLogger::GetInstance().LogDebug("[CACHE] Texture cached: %s (%zu KB%s, %zu/%zu KB, hits %llu, misses %llu)",
+            url.c_str(), bytes / 1024, slot.page >= 0 ? ", atlas" : "", mCacheBytes / 1024, mCacheBudget / 1024,
+            (unsigned long long)mCacheHits, (unsigned long long)mCacheMisses);
     }
 }
 
 void ImageLoader::ClearCache() {
-    for (auto& pair : mTextureCache) {
-        if (pair.second) {
-            SDL_DestroyTexture(pair.second);
+    // 固定计数由界面管理, 不清除
+    for (auto& entry : mCacheLru) {
+        if (entry.texture && entry.slot.page < 0) {
+            SDL_DestroyTexture(entry.texture);
         }
     }
-    mTextureCache.clear();
+    mAtlas.Clear();
+    mCacheLru.clear();
+    mCacheIndex.clear();
+    mCacheBytes = 0;
     DEBUG_FUNCTION_LINE("Image cache cleared");
-    FileLogger::GetInstance().LogInfo("Texture cache cleared");
+    FileLogger::GetInstance().LogInfo("Texture cache cleared (hits %llu, misses %llu)",
+        (unsigned long long)mCacheHits, (unsigned long long)mCacheMisses);
 }
 
 void ImageLoader::RemoveFromCache(const std::string& url) {
-    auto it = mTextureCache.find(url);
-    if (it != mTextureCache.end()) {
-        if (it->second) {
-            SDL_DestroyTexture(it->second);
-        }
-        mTextureCache.erase(it);
+    auto entry = FindEntry(url);
+    if (entry != mCacheLru.end()) {
+        EraseEntry(entry);
         
         if (FileLogger::GetInstance().IsVerbose()) {
             FileLogger::GetInstance().LogDebug("[CACHE] Removed: %s", url.c_str());
@@ -180,259 +326,171 @@ void ImageLoader::RemoveFromCache(const std::string& url) {
     }
 }
 
-std::string ImageLoader::UrlToFilename(const std::string& url) {
-    // URL -> 文件名: 使用简单的哈希
-    std::hash<std::string> hasher;
-    size_t hash = hasher(url);
-    
-    std::ostringstream oss;
-    oss << std::hex << std::setw(16) << std::setfill('0') << hash;
-    
-    // 检测文件扩展名
-    std::string ext = ".jpg";
-    if (url.find(".png") != std::string::npos) {
-        ext = ".png";
-    } else if (url.find(".webp") != std::string::npos) {
-        ext = ".webp";
+SDL_Rect ImageLoader::GetSourceRect(const std::string& url, SDL_Texture* texture) {
+    auto entry = FindEntry(url);
+    if (entry != mCacheLru.end() && entry->texture == texture && entry->slot.page >= 0) {
+        return entry->slot.rect;
     }
     
-    return oss.str() + ext;
+    SDL_Rect rect = {0, 0, 0, 0};
+    if (texture) {
+        SDL_QueryTexture(texture, nullptr, nullptr, &rect.w, &rect.h);
+    }
+    return rect;
 }
 
-std::string ImageLoader::GetCachePath(const std::string& url) {
-    return std::string(CACHE_DIR) + UrlToFilename(url);
+void ImageLoader::PrepareThumbnailJob(ImageDecodePool::Job& job, const std::string& url) {
+    job.thumbKey = url;
+    job.compact = Config::GetInstance().GetCompactThumbnails();
+    job.upload = [url](SDL_Renderer* renderer, SDL_Surface* surface) {
+        return UploadToAtlas(url, renderer, surface);
+    };
 }
 
-bool ImageLoader::SaveToCache(const std::string& url, const void* data, size_t size) {
-    if (!data || size == 0) return false;
-    
-    std::string path = GetCachePath(url);
-    FILE* file = fopen(path.c_str(), "wb");
-    if (!file) {
-        FileLogger::GetInstance().LogWarning("Failed to open cache file for writing: %s", path.c_str());
-        return false;
+SDL_Texture* ImageLoader::UploadToAtlas(const std::string& url, SDL_Renderer* renderer, SDL_Surface* surface) {
+    // 本地文件不查内存缓存, 重新加载时先释放旧的
+    auto old = FindEntry(url);
+    if (old != mCacheLru.end()) {
+        EraseEntry(old);
+    }
+    
+    TextureAtlas::Slot slot;
+    bool allocated = TextureAtlas::Fits(surface->w, surface->h);
+    while (allocated && !mAtlas.Allocate(renderer, surface->w, surface->h, surface->format->format, slot)) {
+        // 图集已满: 淘汰最久未使用且未固定的一张图集缩略图后重试
+        auto victim = mCacheLru.end();
+        for (auto it = mCacheLru.rbegin(); it != mCacheLru.rend(); ++it) {
+            // 只有同一格式的页才能腾出空间
+            if (it->slot.page >= 0 && !mPinCounts.count(it->key) &&
+                mAtlas.GetPageFormat(it->slot.page) == surface->format->format) {
+                victim = std::next(it).base();
+                break;
+            }
+        }
+        if (victim == mCacheLru.end()) {
+            allocated = false;
+            break;
+        }
+        EraseEntry(victim);
     }
     
-    size_t written = fwrite(data, 1, size, file);
-    fclose(file);
-    
-    if (written != size) {
-        FileLogger::GetInstance().LogError("Failed to write complete cache file: %s", path.c_str());
-        return false;
+    SDL_Texture* page = allocated ? mAtlas.GetTexture(slot.page) : nullptr;
+    if (page && SDL_UpdateTexture(page, &slot.rect, surface->pixels, surface->pitch) != 0) {
+        FileLogger::GetInstance().LogError("[Atlas] SDL_UpdateTexture failed: %s", SDL_GetError());
+        mAtlas.Free(slot);
+        page = nullptr;
     }
     
-    if (FileLogger::GetInstance().IsVerbose()) {
-        FileLogger::GetInstance().LogDebug("[CACHE SAVED] %s -> %s (%zu bytes)", url.c_str(), path.c_str(), size);
+    if (!page) {
+        // 放不进图集时使用单独的纹理, 由 FinishLoad 加入缓存
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (!texture) {
+            FileLogger::GetInstance().LogError("[ImageDecode] SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
+        }
+        return texture;
     }
     
-    return true;
+    InsertEntry(url, page, (size_t)slot.rect.w * slot.rect.h * surface->format->BytesPerPixel, slot);
+    return page;
 }
 
-std::vector<uint8_t> ImageLoader::LoadFromCache(const std::string& url) {
-    std::vector<uint8_t> data;
-    std::string path = GetCachePath(url);
-    
-    FILE* file = fopen(path.c_str(), "rb");
-    if (!file) {
-        return data;
-    }
-    
-    fseek(file, 0, SEEK_END);
-    long fileSize = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    if (fileSize <= 0 || fileSize > 10 * 1024 * 1024) {
-        fclose(file);
-        FileLogger::GetInstance().LogWarning("Invalid cache file size: %ld", fileSize);
-        return data;
-    }
-    
-    data.resize(fileSize);
-    size_t bytesRead = fread(data.data(), 1, fileSize, file);
-    fclose(file);
-    
-    if (bytesRead != (size_t)fileSize) {
-        FileLogger::GetInstance().LogError("Failed to read complete cache file");
-        data.clear();
-        return data;
+void ImageLoader::Pin(const std::string& url) {
+    if (url.empty()) return;
+    mPinCounts[HashUrl(url)]++;
+}
+
+void ImageLoader::Unpin(const std::string& url) {
+    if (url.empty()) return;
+    auto it = mPinCounts.find(HashUrl(url));
+    if (it == mPinCounts.end()) {
+        return;
     }
-    
-    if (FileLogger::GetInstance().IsVerbose()) {
-        FileLogger::GetInstance().LogDebug("[CACHE HIT - DISK] %s (%zu bytes)", path.c_str(), data.size());
+    if (--it->second <= 0) {
+        mPinCounts.erase(it);
+        // 固定期间可能超出了预算
+        EvictToBudget();
     }
-    
-    return data;
 }
 
-SDL_Texture* ImageLoader::LoadFromMemory(const void* data, size_t size) {
-    if (!data || size == 0) {
-        FileLogger::GetInstance().LogError("[LoadFromMemory] Invalid data: data=%p, size=%zu", data, size);
-        return nullptr;
-    }
-    
-    FileLogger::GetInstance().LogInfo("[LoadFromMemory] Attempting to load %zu bytes", size);
-    
-    // 检测图片格式
-    const unsigned char* bytes = (const unsigned char*)data;
-    std::string format = "unknown";
-    
-    if (size >= 4) {
-        if (bytes[0] == 0xFF && bytes[1] == 0xD8 && bytes[2] == 0xFF) {
-            format = "JPEG";
-        } else if (bytes[0] == 0x89 && bytes[1] == 0x50 && bytes[2] == 0x4E && bytes[3] == 0x47) {
-            format = "PNG";
-        } else if (bytes[0] == 'R' && bytes[1] == 'I' && bytes[2] == 'F' && bytes[3] == 'F') {
-            // 检查是否是 WEBP (RIFF....WEBP)
-            if (size >= 12 && bytes[8] == 'W' && bytes[9] == 'E' && bytes[10] == 'B' && bytes[11] == 'P') {
-                format = "WEBP";
-            }
-        } else if (bytes[0] == 'G' && bytes[1] == 'I' && bytes[2] == 'F') {
-            format = "GIF";
+void ImageLoader::SetCacheBudget(size_t bytes) {
+    mCacheBudget = bytes;
+    EvictToBudget();
+    FileLogger::GetInstance().LogInfo("[CACHE] Texture budget: %zu MB", bytes / (1024 * 1024));
+}
+
+void TexturePinSet::Update(const std::vector<std::string>& urls) {
+    std::set<std::string> next;
+    for (const auto& url : urls) {
+        if (!url.empty()) {
+            next.insert(url);
         }
     }
-    FileLogger::GetInstance().LogInfo("[LoadFromMemory] Image format: %s (header: %02X %02X %02X %02X)", 
-        format.c_str(), bytes[0], bytes[1], bytes[2], bytes[3]);
     
-    // 如果是 WEBP 格式，使用 libwebp 解码
-    if (format == "WEBP") {
-        FileLogger::GetInstance().LogInfo("[LoadFromMemory] Using libwebp decoder for WEBP image");
-        
-        // 获取图片尺寸
-        int width = 0, height = 0;
-        if (!WebPGetInfo(bytes, size, &width, &height)) {
-            FileLogger::GetInstance().LogError("[LoadFromMemory] WebPGetInfo failed - invalid WEBP data");
-            return nullptr;
-        }
-        
-        FileLogger::GetInstance().LogInfo("[LoadFromMemory] WEBP dimensions: %dx%d", width, height);
-        
-        // 解码为 RGBA
-        uint8_t* rgba_data = WebPDecodeRGBA(bytes, size, &width, &height);
-        if (!rgba_data) {
-            FileLogger::GetInstance().LogError("[LoadFromMemory] WebPDecodeRGBA failed");
-            return nullptr;
-        }
-        
-        FileLogger::GetInstance().LogInfo("[LoadFromMemory] WEBP decoded successfully to RGBA buffer");
-        
-        // 创建临时 SDL Surface 使用 RGBA 格式
-        // 注意：WebPDecodeRGBA 返回的是 R,G,B,A 字节顺序（与字节序无关）
-        SDL_Surface* temp_surface = SDL_CreateRGBSurfaceFrom(
-            rgba_data,
-            width, height,
-            32,                    // 32 bits per pixel
-            width * 4,             // pitch (bytes per row)
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            0xFF000000,            // R mask (大端序)
-            0x00FF0000,            // G mask
-            0x0000FF00,            // B mask
-            0x000000FF             // A mask
-#else
-            0x000000FF,            // R mask (小端序)
-            0x0000FF00,            // G mask
-            0x00FF0000,            // B mask
-            0xFF000000             // A mask
-#endif
-        );
-        
-        if (!temp_surface) {
-            FileLogger::GetInstance().LogError("[LoadFromMemory] SDL_CreateRGBSurfaceFrom failed: %s", SDL_GetError());
-            WebPFree(rgba_data);
-            return nullptr;
-        }
-        
-        FileLogger::GetInstance().LogInfo("[LoadFromMemory] Temp surface created: format=%s", 
-            SDL_GetPixelFormatName(temp_surface->format->format));
-        
-        // 获取渲染器
-        SDL_Renderer* renderer = Gfx::GetRenderer();
-        if (!renderer) {
-            FileLogger::GetInstance().LogError("[LoadFromMemory] Renderer is null!");
-            SDL_FreeSurface(temp_surface);
-            WebPFree(rgba_data);
-            return nullptr;
-        }
-        
-        // 转换为渲染器原生格式以获得最佳性能和正确颜色
-        Uint32 renderer_format = SDL_PIXELFORMAT_RGBA8888; // 默认格式
-        SDL_RendererInfo renderer_info;
-        if (SDL_GetRendererInfo(renderer, &renderer_info) == 0) {
-            if (renderer_info.num_texture_formats > 0) {
-                renderer_format = renderer_info.texture_formats[0];
-                FileLogger::GetInstance().LogInfo("[LoadFromMemory] Using renderer format: %s", 
-                    SDL_GetPixelFormatName(renderer_format));
-            }
-        }
-        
-        // 转换 surface 到渲染器格式
-        SDL_Surface* converted_surface = SDL_ConvertSurfaceFormat(temp_surface, renderer_format, 0);
-        SDL_FreeSurface(temp_surface);
-        WebPFree(rgba_data);
-        
-        if (!converted_surface) {
-            FileLogger::GetInstance().LogError("[LoadFromMemory] SDL_ConvertSurfaceFormat failed: %s", SDL_GetError());
-            return nullptr;
+    for (const auto& url : next) {
+        if (!mUrls.count(url)) {
+            ImageLoader::Pin(url);
         }
-        
-        FileLogger::GetInstance().LogInfo("[LoadFromMemory] Surface converted to: %s", 
-            SDL_GetPixelFormatName(converted_surface->format->format));
-        
-        // 创建纹理
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, converted_surface);
-        SDL_FreeSurface(converted_surface);
-        
-        if (!texture) {
-            FileLogger::GetInstance().LogError("[LoadFromMemory] SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
-            return nullptr;
+    }
+    for (const auto& url : mUrls) {
+        if (!next.count(url)) {
+            ImageLoader::Unpin(url);
         }
-        
-        FileLogger::GetInstance().LogInfo("[LoadFromMemory] [SUCCESS] WEBP texture created successfully");
-        return texture;
     }
+    mUrls = std::move(next);
+}
+
+void TexturePinSet::Clear() {
+    for (const auto& url : mUrls) {
+        ImageLoader::Unpin(url);
+    }
+    mUrls.clear();
+}
+
+std::string ImageLoader::UrlToFilename(const std::string& url) {
+    return ImageDiskCache::UrlToFilename(url);
+}
+
+std::string ImageLoader::GetCachePath(const std::string& url) {
+    return ImageDiskCache::GetInstance().GetPath(url);
+}
+
+bool ImageLoader::SaveToCache(const std::string& url, const void* data, size_t size) {
+    return ImageDiskCache::GetInstance().Save(url, data, size);
+}
+
+std::vector<uint8_t> ImageLoader::LoadFromCache(const std::string& url) {
+    return ImageDiskCache::GetInstance().Load(url);
+}
+
+SDL_Texture* ImageLoader::LoadFromMemory(const void* data, size_t size, int targetWidth, int targetHeight) {
+    ProfileScope scope(FrameProfiler::STAGE_IMAGE_DECODE);
     
-    // 对于其他格式，使用 SDL_image
-    SDL_RWops* rw = SDL_RWFromConstMem(data, size);
-    if (!rw) {
-        FileLogger::GetInstance().LogError("[LoadFromMemory] Failed to create RWops: %s", SDL_GetError());
+    if (!data || size == 0) {
+        FileLogger::GetInstance().LogError("[LoadFromMemory] Invalid data: data=%p, size=%zu", data, size);
         return nullptr;
     }
     
-    SDL_Surface* surface = nullptr;
-    if (format == "JPEG") {
-        FileLogger::GetInstance().LogInfo("[LoadFromMemory] Trying IMG_LoadTyped_RW with 'JPG' hint");
-        surface = IMG_LoadTyped_RW(rw, 1, "JPG");
-        if (!surface) {
-            FileLogger::GetInstance().LogError("[LoadFromMemory] IMG_LoadTyped_RW('JPG') failed: %s", IMG_GetError());
-            return nullptr;
-        }
-    } else {
-        surface = IMG_Load_RW(rw, 1);
+    // WebP 直接解码进纹理内存
+    SDL_Texture* direct = ImageDecodePool::DecodeWebPToTexture(Gfx::GetRenderer(), (const uint8_t*)data, size,
+                                                              mDecodePool.GetFormat(), targetWidth, targetHeight);
+    if (direct) {
+        return direct;
     }
     
+    // 与异步加载使用同一解码路径, 只是在当前线程执行
+    SDL_Surface* surface = ImageDecodePool::Decode((const uint8_t*)data, size, mDecodePool.GetFormat(), targetWidth, targetHeight);
     if (!surface) {
-        FileLogger::GetInstance().LogError("[LoadFromMemory] All decoders failed");
-        return nullptr;
-    }
-    
-    FileLogger::GetInstance().LogInfo("[LoadFromMemory] Surface created: %dx%d, format=%d", 
-        surface->w, surface->h, surface->format->format);
-    
-    SDL_Renderer* renderer = Gfx::GetRenderer();
-    if (!renderer) {
-        FileLogger::GetInstance().LogError("[LoadFromMemory] Renderer is null!");
-        SDL_FreeSurface(surface);
+        FileLogger::GetInstance().LogError("[LoadFromMemory] Failed to decode %zu bytes", size);
         return nullptr;
     }
     
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(Gfx::GetRenderer(), surface);
     SDL_FreeSurface(surface);
     
     if (!texture) {
         FileLogger::GetInstance().LogError("[LoadFromMemory] SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
         return nullptr;
     }
-    
-    FileLogger::GetInstance().LogInfo("[LoadFromMemory] [SUCCESS] Texture created successfully (%s format)", format.c_str());
     return texture;
 }
 
@@ -457,6 +515,7 @@ SDL_Texture* ImageLoader::LoadFromUrl(const std::string& url) {
             return texture;
         } else {
             FileLogger::GetInstance().LogWarning("[CACHE CORRUPT] Failed to load texture from cache: %s", GetCachePath(url).c_str());
+            ImageDiskCache::GetInstance().Remove(url);
         }
     } else {
         FileLogger::GetInstance().LogInfo("[CACHE MISS] Not found in disk cache: %s", url.c_str());
@@ -545,242 +604,170 @@ void ImageLoader::LoadAsync(const LoadRequest& request) {
     
     // 检查是否是本地文件 (以 fs:/ 开头的路径)
     bool isLocalFile = (request.url.find("fs:/") == 0);
-    std::string localPath;
-    
-    FileLogger::GetInstance().LogInfo("[LoadAsync] URL: %s, isLocal: %d", request.url.c_str(), isLocalFile);
     
-    if (isLocalFile) {
-        // 直接使用本地文件路径
-        localPath = request.url;
-        FileLogger::GetInstance().LogInfo("[LOCAL FILE] Loading: %s", localPath.c_str());
-        
-        // 检查文件是否存在
-        struct stat st;
-        int statResult = stat(localPath.c_str(), &st);
-        int statErrno = errno;
-        FileLogger::GetInstance().LogInfo("[STAT CALL] path='%s', result=%d, errno=%d", localPath.c_str(), statResult, statErrno);
-        
-        if (statResult != 0) {
-            FileLogger::GetInstance().LogError("[LOCAL FILE NOT FOUND] %s (errno: %d)", localPath.c_str(), statErrno);
-            if (request.callback) {
-                request.callback(nullptr);
+    if (!isLocalFile) {
+        SDL_Texture* cached = GetCached(request.url);
+        if (cached) {
+            if (FileLogger::GetInstance().IsVerbose()) {
+                FileLogger::GetInstance().LogDebug("[CACHE HIT - MEMORY] Async: %s", request.url.c_str());
             }
-            return;
-        }
-        
-        FileLogger::GetInstance().LogInfo("[LOCAL FILE EXISTS] Size: %lld bytes, mode: 0x%x", (long long)st.st_size, st.st_mode);
-        
-        // 检查是否真的是文件
-        if (S_ISDIR(st.st_mode)) {
-            FileLogger::GetInstance().LogError("[ERROR] Path is a directory, not a file: %s", localPath.c_str());
             if (request.callback) {
-                request.callback(nullptr);
+                request.callback(cached);
             }
             return;
         }
+    }
+    
+    // 同一 URL 正在加载时只追加回调, 避免重复解码后缓存替换掉仍在使用的纹理
+    auto pending = mInFlight.find(request.url);
+    if (pending != mInFlight.end()) {
+        pending->second.push_back(request.callback);
+        return;
+    }
+    mInFlight[request.url].push_back(request.callback);
+    
+    const std::string url = request.url;
+    
+    if (isLocalFile) {
+        FileLogger::GetInstance().LogInfo("[LOCAL FILE] Loading: %s", url.c_str());
         
-        if (!S_ISREG(st.st_mode)) {
-            FileLogger::GetInstance().LogWarning("[WARNING] Path is not a regular file (mode: 0x%x): %s", st.st_mode, localPath.c_str());
+        struct stat st;
+        if (stat(url.c_str(), &st) != 0 || S_ISDIR(st.st_mode)) {
+            FileLogger::GetInstance().LogError("[LOCAL FILE NOT FOUND] %s (errno: %d)", url.c_str(), errno);
+            FinishLoad(url, nullptr);
+            return;
         }
         
-        // 检查文件大小 - 即使显示0字节也尝试加载(可能是stat的问题)
-        if (st.st_size == 0) {
-            FileLogger::GetInstance().LogWarning("[WARNING] File appears empty (0 bytes), but will try to load anyway: %s", localPath.c_str());
+        ImageDecodePool::Job job;
+        job.path = url;
+        job.targetWidth = request.targetWidth;
+        job.targetHeight = request.targetHeight;
+        job.highPriority = request.highPriority;
+        if (request.thumbnail) {
+            // 文件被替换 (主题重新安装) 后修改时间变化, 重新解码
+            PrepareThumbnailJob(job, url);
+            job.thumbStamp = (uint32_t)st.st_mtime;
         }
-        
-        // 尝试加载本地文件 - 先用 IMG_Load 让它自动检测格式
-        SDL_Surface* surface = IMG_Load(localPath.c_str());
-        
-        // 如果失败,尝试强制作为 WEBP 加载
-        if (!surface) {
-            FileLogger::GetInstance().LogWarning("[IMG_Load FAILED] %s, trying as WEBP...", IMG_GetError());
-            
-            SDL_RWops* rwops = SDL_RWFromFile(localPath.c_str(), "rb");
-            if (rwops) {
-                FileLogger::GetInstance().LogInfo("[SDL_RWFromFile OK] Trying IMG_LoadTyped_RW with WEBP");
-                surface = IMG_LoadTyped_RW(rwops, 1, "WEBP");
-                if (!surface) {
-                    FileLogger::GetInstance().LogError("[WEBP Load FAILED via SDL_image] %s", IMG_GetError());
-                }
-            } else {
-                FileLogger::GetInstance().LogError("[SDL_RWFromFile FAILED] %s", SDL_GetError());
-            }
-        } else {
-            FileLogger::GetInstance().LogInfo("[IMG_Load SUCCESS] Surface created directly");
-        }
-        
-        // 如果 SDL_image 失败,尝试直接使用 libwebp 解码
-        if (!surface) {
-            FileLogger::GetInstance().LogInfo("[Trying libwebp directly]");
-            
-            FILE* fp = fopen(localPath.c_str(), "rb");
-            if (fp) {
-                fseek(fp, 0, SEEK_END);
-                long fileSize = ftell(fp);
-                fseek(fp, 0, SEEK_SET);
-                
-                uint8_t* fileData = (uint8_t*)malloc(fileSize);
-                if (fileData) {
-                    size_t readSize = fread(fileData, 1, fileSize, fp);
-                    fclose(fp);
-                    
-                    if (readSize == (size_t)fileSize) {
-                        int width, height;
-                        uint8_t* rgbaData = WebPDecodeRGBA(fileData, fileSize, &width, &height);
-                        
-                        if (rgbaData) {
-                            FileLogger::GetInstance().LogInfo("[libwebp SUCCESS] Decoded %dx%d WEBP image", width, height);
-                            
-                            // 创建 SDL_Surface - 使用正确的像素格式
-                            // WebPDecodeRGBA 返回 RGBA 字节序: R, G, B, A
-                            #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-                                Uint32 rmask = 0xff000000;
-                                Uint32 gmask = 0x00ff0000;
-                                Uint32 bmask = 0x0000ff00;
-                                Uint32 amask = 0x000000ff;
-                            #else
-                                Uint32 rmask = 0x000000ff;
-                                Uint32 gmask = 0x0000ff00;
-                                Uint32 bmask = 0x00ff0000;
-                                Uint32 amask = 0xff000000;
-                            #endif
-                            
-                            surface = SDL_CreateRGBSurfaceFrom(
-                                rgbaData,
-                                width, height,
-                                32, // bits per pixel
-                                width * 4, // pitch
-                                rmask, gmask, bmask, amask
-                            );
-                            
-                            if (surface) {
-                                // 复制数据因为 WebPFree 会释放 rgbaData
-                                SDL_Surface* copiedSurface = SDL_ConvertSurface(surface, surface->format, 0);
-                                SDL_FreeSurface(surface);
-                                surface = copiedSurface;
-                                FileLogger::GetInstance().LogInfo("[libwebp] Surface created and copied");
-                            }
-                            
-                            WebPFree(rgbaData);
-                        } else {
-                            FileLogger::GetInstance().LogError("[libwebp FAILED] Could not decode WEBP data");
-                        }
-                    } else {
-                        FileLogger::GetInstance().LogError("[FILE READ FAILED] Expected %ld bytes, read %zu bytes", fileSize, readSize);
-                    }
-                    
-                    free(fileData);
-                } else {
-                    FileLogger::GetInstance().LogError("[MALLOC FAILED] Could not allocate %ld bytes", fileSize);
-                    fclose(fp);
-                }
-            } else {
-                FileLogger::GetInstance().LogError("[FILE OPEN FAILED] Could not open: %s", localPath.c_str());
+        job.callback = [url](SDL_Texture* texture) {
+            if (!texture) {
+                FileLogger::GetInstance().LogError("[LOCAL FILE LOAD FAILED] %s", url.c_str());
             }
+            FinishLoad(url, texture);
+        };
+        mDecodePool.Submit(std::move(job));
+        return;
+    }
+    
+    LoadRequest options = request;
+    options.callback = nullptr;
+    
+    // 磁盘缓存: 读取和解码都在工作线程, 损坏时重新下载
+    // 查询走内存中的索引, 未命中时不访问 SD 卡; 已存的缩略图不需要原图
+    const bool stored = request.thumbnail &&
+        ThumbnailStore::GetInstance().Contains(url, request.targetWidth, request.targetHeight, 0);
+    if (ImageDiskCache::GetInstance().Contains(url) || stored) {
+        ImageDecodePool::Job job;
+        job.path = GetCachePath(url);
+        job.targetWidth = request.targetWidth;
+        job.targetHeight = request.targetHeight;
+        if (request.thumbnail) {
+            PrepareThumbnailJob(job, url);
         }
-        
-        if (surface) {
-            FileLogger::GetInstance().LogInfo("[SURFACE CREATED] %dx%d, format: %s", 
-                surface->w, surface->h, SDL_GetPixelFormatName(surface->format->format));
-                
-            SDL_Texture* texture = SDL_CreateTextureFromSurface(Gfx::GetRenderer(), surface);
-            SDL_FreeSurface(surface);
-            
+        job.highPriority = request.highPriority;
+        job.callback = [options](SDL_Texture* texture) {
+            const std::string& url = options.url;
             if (texture) {
-                FileLogger::GetInstance().LogInfo("[LOCAL FILE LOADED] %s -> texture: %p", localPath.c_str(), texture);
-                // 缓存纹理
-                CacheTexture(request.url, texture);
-                if (request.callback) {
-                    request.callback(texture);
-                }
+                FileLogger::GetInstance().LogInfo("[CACHE HIT - DISK] Async: %s", url.c_str());
+                FinishLoad(url, texture);
             } else {
-                FileLogger::GetInstance().LogError("[LOCAL FILE TEXTURE FAILED] %s: %s", localPath.c_str(), SDL_GetError());
-                if (request.callback) {
-                    request.callback(nullptr);
-                }
-            }
-        } else {
-            FileLogger::GetInstance().LogError("[LOCAL FILE LOAD FAILED] %s: All methods failed", localPath.c_str());
-            if (request.callback) {
-                request.callback(nullptr);
+                FileLogger::GetInstance().LogWarning("[CACHE CORRUPT] Failed to load texture from cache: %s", GetCachePath(url).c_str());
+                ImageDiskCache::GetInstance().Remove(url);
+                StartDownload(options);
             }
-        }
+        };
+        mDecodePool.Submit(std::move(job));
         return;
     }
     
-    // 网络URL - 原有逻辑
-    SDL_Texture* cached = GetCached(request.url);
-    if (cached) {
-        if (FileLogger::GetInstance().IsVerbose()) {
-            FileLogger::GetInstance().LogDebug("[CACHE HIT - MEMORY] Async: %s", request.url.c_str());
-        }
-        if (request.callback) {
-            request.callback(cached);
-        }
-        return;
-    }
+    StartDownload(options);
+}
+
+void ImageLoader::StartDownload(const LoadRequest& request) {
+    const std::string& url = request.url;
+    FileLogger::GetInstance().LogInfo("[DOWNLOADING - ASYNC] %s", url.c_str());
     
-    std::vector<uint8_t> diskData = LoadFromCache(request.url);
-    if (!diskData.empty()) {
-        SDL_Texture* texture = LoadFromMemory(diskData.data(), diskData.size());
-        if (texture) {
-            CacheTexture(request.url, texture);
-            FileLogger::GetInstance().LogInfo("[CACHE HIT - DISK] Async: %s", request.url.c_str());
-            if (request.callback) {
-                request.callback(texture);
-            }
-            return;
-        }
+    if (!DownloadQueue::GetInstance()) {
+        FileLogger::GetInstance().LogError("DownloadQueue not initialized!");
+        FinishLoad(url, nullptr);
+        return;
     }
     
-    FileLogger::GetInstance().LogInfo("[DOWNLOADING - ASYNC] %s", request.url.c_str());
-    
     AsyncDownloadContext* context = new AsyncDownloadContext();
-    context->url = request.url;
-    context->callback = request.callback;
+    context->request = request;
     context->download = new DownloadOperation();
-    context->download->url = request.url;
+    context->download->url = url;
+    
+    // 边下载边解码: 不在 curl 写入回调中解码, 由 FeedProgressive 每帧送入一部分已收到的数据
+    if (request.progressive) {
+        ProgressiveEntry& entry = mProgressive[url];
+        entry.decoder = std::make_unique<ProgressiveWebP>(request.targetWidth, request.targetHeight);
+        entry.download = context->download;
+    }
     
     context->download->cb = [](DownloadOperation* download) {
         AsyncDownloadContext* ctx = (AsyncDownloadContext*)download->cbdata;
+        const LoadRequest& request = ctx->request;
         
-        SDL_Texture* texture = nullptr;
+        // 部分解码的纹理继续显示, 直到完整解码的纹理上传后才移除
+        auto partial = mProgressive.find(request.url);
+        ProgressiveWebP* progressive = nullptr;
+        if (partial != mProgressive.end()) {
+            progressive = partial->second.decoder.get();
+            partial->second.download = nullptr;
+        }
         
         if (download->status == DownloadStatus::COMPLETE && !download->buffer.empty()) {
-            // 先记录下载的数据信息
-            FileLogger::GetInstance().LogInfo("[DOWNLOAD COMPLETE] %s (%zu bytes)", ctx->url.c_str(), download->buffer.size());
+            FileLogger::GetInstance().LogInfo("[DOWNLOAD COMPLETE] %s (%zu bytes)", request.url.c_str(), download->buffer.size());
             
-            // 检查前几个字节
-            if (download->buffer.size() >= 4) {
-                const unsigned char* bytes = (const unsigned char*)download->buffer.data();
-                FileLogger::GetInstance().LogInfo("[DOWNLOAD DATA] First 4 bytes: %02X %02X %02X %02X", 
-                    bytes[0], bytes[1], bytes[2], bytes[3]);
-                    
-                // 检查前16字节看是否是HTML错误
-                if (download->buffer.size() >= 16) {
-                    char preview[17] = {0};
-                    memcpy(preview, bytes, 16);
-                    for (int i = 0; i < 16; i++) {
-                        if (preview[i] < 32 || preview[i] > 126) preview[i] = '.';
-                    }
-                    FileLogger::GetInstance().LogInfo("[DOWNLOAD DATA] First 16 chars: %s", preview);
-                }
+            // 写磁盘缓存和解码交给工作线程
+            ImageDecodePool::Job job;
+            job.data.assign(download->buffer.begin(), download->buffer.end());
+            job.cacheUrl = request.url;
+            job.targetWidth = request.targetWidth;
+            job.targetHeight = request.targetHeight;
+            if (request.thumbnail) {
+                PrepareThumbnailJob(job, request.url);
             }
+            job.highPriority = request.highPriority;
             
-            SaveToCache(ctx->url, download->buffer.data(), download->buffer.size());
+            // 增量解码已经完成, 工作线程只写磁盘缓存
+            if (progressive && progressive->IsComplete()) {
+                job.decode = false;
+                mDecodePool.Submit(std::move(job));
+                SDL_Texture* texture = progressive->ReleaseTexture();
+                mProgressive.erase(partial);
+                FinishLoad(request.url, texture);
+                delete ctx->download;
+                delete ctx;
+                return;
+            }
             
-            texture = LoadFromMemory(download->buffer.data(), download->buffer.size());
-            if (texture) {
-                CacheTexture(ctx->url, texture);
-            } else {
-                FileLogger::GetInstance().LogError("[TEXTURE CREATION FAILED] %s", ctx->url.c_str());
+            job.callback = [url = request.url](SDL_Texture* texture) {
+                if (!texture) {
+                    FileLogger::GetInstance().LogError("[TEXTURE CREATION FAILED] %s", url.c_str());
+                }
+                mProgressive.erase(url);
+                FinishLoad(url, texture);
+            };
+            mDecodePool.Submit(std::move(job));
+        } else {
+            if (download->status == DownloadStatus::FAILED) {
+                FileLogger::GetInstance().LogError("[DOWNLOAD FAILED] %s (HTTP %ld)", request.url.c_str(), download->response_code);
             }
-        } else if (download->status == DownloadStatus::FAILED) {
-            FileLogger::GetInstance().LogError("[DOWNLOAD FAILED] %s (HTTP %ld)", ctx->url.c_str(), download->response_code);
-        }
-        
-        if (ctx->callback) {
-            ctx->callback(texture);
+            if (progressive) {
+                mProgressive.erase(partial);
+            }
+            FinishLoad(request.url, nullptr);
         }
         
         delete ctx->download;
@@ -788,12 +775,26 @@ void ImageLoader::LoadAsync(const LoadRequest& request) {
     };
     
     context->download->cbdata = context;
+    DownloadQueue::GetInstance()->DownloadAdd(context->download);
+}
+
+void ImageLoader::FinishLoad(const std::string& url, SDL_Texture* texture) {
+    std::vector<std::function<void(SDL_Texture*)>> callbacks;
+    auto it = mInFlight.find(url);
+    if (it != mInFlight.end()) {
+        callbacks = std::move(it->second);
+        mInFlight.erase(it);
+    }
     
-    if (DownloadQueue::GetInstance()) {
-        DownloadQueue::GetInstance()->DownloadAdd(context->download);
-    } else {
-        FileLogger::GetInstance().LogError("DownloadQueue not initialized!");
-        delete context->download;
-        delete context;
+    if (texture) {
+        CacheTexture(url, texture);
+    }
+    // 加载失败时界面状态也会变化
+    FrameDamage::Mark();
+    
+    for (auto& callback : callbacks) {
+        if (callback) {
+            callback(texture);
+        }
     }
 }
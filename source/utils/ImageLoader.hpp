@@ -2,11 +2,26 @@
 
 #include <string>
 #include <map>
+#include <set>
+#include <list>
+#include <unordered_map>
 #include <vector>
 #include <functional>
+#include <cstdint>
+#include <memory>
 #include <SDL2/SDL.h>
+#include <coreinit/time.h>
+#include "ImageDecodePool.hpp"
+#include "TextureAtlas.hpp"
+
+class ProgressiveWebP;
+struct DownloadOperation;
 
 // 图片加载器 - 从 URL 下载并创建 SDL 纹理
+// 异步加载的读文件和解码在 ImageDecodePool 工作线程中完成, 主线程只上传纹理
+// 纹理缓存按 URL 哈希索引, 按纹理字节数 (宽 x 高 x 每像素字节) 做 LRU 淘汰, 缓存拥有纹理;
+// 界面持有的纹理指针在被淘汰后失效, 使用前用 IsCached 检查, 可见的纹理用 Pin 防止被淘汰
+// 列表缩略图放入 TextureAtlas, 多个 URL 共用同一张图集纹理, 绘制时需要用 GetSourceRect 取得所在区域
 class ImageLoader {
 public:
     // 初始化 SDL_image
@@ -18,26 +33,57 @@ public:
     // 同步加载图片 (阻塞)
     static SDL_Texture* LoadFromUrl(const std::string& url);
     
-    // 从内存数据加载图片
-    static SDL_Texture* LoadFromMemory(const void* data, size_t size);
+    // 从内存数据加载图片, 指定目标尺寸时按比例缩小到能放入该尺寸
+    static SDL_Texture* LoadFromMemory(const void* data, size_t size, int targetWidth = 0, int targetHeight = 0);
     
     // 异步加载图片 (非阻塞,使用回调)
     struct LoadRequest {
         std::string url;
         std::function<void(SDL_Texture*)> callback;
         bool highPriority = false;
+        // 显示尺寸, 解码时按比例缩小到能放入该尺寸 (不放大), 0 表示原始尺寸
+        // 缓存按 URL 区分, 同一 URL 以第一次加载时的尺寸为准
+        int targetWidth = 0;
+        int targetHeight = 0;
+        // 需要下载的 WebP 边下载边解码, 下载期间可用 GetProgressive 取得部分解码的纹理
+        bool progressive = false;
+        // 固定尺寸的列表缩略图, 需要指定目标尺寸:
+        // 解码结果存入 ThumbnailStore, 再次加载时直接读取像素; 纹理放入共用的图集, 绘制时用 GetSourceRect 取源矩形
+        bool thumbnail = false;
     };
     static void LoadAsync(const LoadRequest& request);
     
-    // 处理异步加载队列 (在主循环中调用)
+    // 处理下载队列并上传已解码的图片 (在主循环和界面内部的循环中调用)
     static void Update();
     
+    // 上传已解码的图片并调用回调; 同一帧内多次调用 (主循环和界面的 Update) 只上传一次
+    static void UploadDecoded();
+    static void FeedProgressive();
+    
+    // 正在增量解码的纹理, 下载完成后保留到完整解码的纹理上传为止; 没有时返回 nullptr
+    // 纹理归 ImageLoader 所有, 只在当前帧内有效
+    static SDL_Texture* GetProgressive(const std::string& url);
+    
     // 缓存管理
     static SDL_Texture* GetCached(const std::string& url);
     static void CacheTexture(const std::string& url, SDL_Texture* texture);
     static void ClearCache();
     static void RemoveFromCache(const std::string& url);
     
+    // texture 是否仍是 url 的缓存纹理 (未被淘汰或替换), 不计入命中统计
+    static bool IsCached(const std::string& url, SDL_Texture* texture);
+    
+    // url 的图片在 texture 中的区域: 图集中的缩略图为所在槽位, 其他为整张纹理; 绘制时作为源矩形
+    static SDL_Rect GetSourceRect(const std::string& url, SDL_Texture* texture);
+    
+    // 固定 / 解除固定 (引用计数), 固定的纹理不会被淘汰; 可以在纹理加载完成前固定
+    static void Pin(const std::string& url);
+    static void Unpin(const std::string& url);
+    
+    // 缓存预算 (字节), 超出时从最久未使用的未固定纹理开始淘汰
+    static void SetCacheBudget(size_t bytes);
+    static size_t GetCacheBudget() { return mCacheBudget; }
+    
     // 磁盘缓存
     static bool SaveToCache(const std::string& url, const void* data, size_t size);
     static std::vector<uint8_t> LoadFromCache(const std::string& url);
@@ -45,14 +91,70 @@ public:
     static std::string UrlToFilename(const std::string& url);
     
     // 统计信息
-    static size_t GetCacheSize() { return mTextureCache.size(); }
+    static size_t GetCacheSize() { return mCacheIndex.size(); }
+    static size_t GetCacheBytes() { return mCacheBytes; }
+    static uint64_t GetCacheHits() { return mCacheHits; }
+    static uint64_t GetCacheMisses() { return mCacheMisses; }
     static size_t GetQueueSize() { return mLoadQueue.size(); }
     
 private:
-    static std::map<std::string, SDL_Texture*> mTextureCache;
+    static constexpr size_t DEFAULT_CACHE_BUDGET = 64 * 1024 * 1024;
+    static constexpr int UPLOAD_INTERVAL_US = 8000;  // 间隔小于半帧的调用视为同一帧
+    
+    struct CacheEntry {
+        uint64_t key;
+        std::string url;
+        SDL_Texture* texture;
+        size_t bytes;
+        TextureAtlas::Slot slot;  // 在图集中时纹理为图集页, 归 mAtlas 所有
+    };
+    
+    // 链表头部为最近使用
+    static std::list<CacheEntry> mCacheLru;
+    static std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> mCacheIndex;
+    static std::unordered_map<uint64_t, int> mPinCounts;
+    static size_t mCacheBytes;
+    static size_t mCacheBudget;
+    static uint64_t mCacheHits;
+    static uint64_t mCacheMisses;
+    
     static std::vector<LoadRequest> mLoadQueue;
     static bool mInitialized;
+    static ImageDecodePool mDecodePool;
+    static OSTime mLastUpload;
+    static TextureAtlas mAtlas;
+    
+    // 正在加载的 URL 及等待的回调, 同一 URL 只加载一次
+    static std::map<std::string, std::vector<std::function<void(SDL_Texture*)>>> mInFlight;
+    
+    // 正在增量解码的下载, 已收到的数据在 UploadDecoded 中每帧送入解码器一次
+    struct ProgressiveEntry {
+        std::unique_ptr<ProgressiveWebP> decoder;
+        DownloadOperation* download = nullptr;  // 下载结束后置空, 不再送入数据
+    };
+    static std::map<std::string, ProgressiveEntry> mProgressive;
     
     // 内部辅助函数
     static std::vector<uint8_t> DownloadData(const std::string& url);
+    static void StartDownload(const LoadRequest& request);
+    static void FinishLoad(const std::string& url, SDL_Texture* texture);
+    static uint64_t HashUrl(const std::string& url);
+    static std::list<CacheEntry>::iterator FindEntry(const std::string& url);
+    static void InsertEntry(const std::string& url, SDL_Texture* texture, size_t bytes, const TextureAtlas::Slot& slot);
+    static void EraseEntry(std::list<CacheEntry>::iterator entry);
+    static void PrepareThumbnailJob(ImageDecodePool::Job& job, const std::string& url);
+    static SDL_Texture* UploadToAtlas(const std::string& url, SDL_Renderer* renderer, SDL_Surface* surface);
+    static void EvictToBudget();
+};
+
+// 一组固定的 URL, 界面每帧用当前可见的 URL 调用 Update, 离开可见范围的自动解除固定
+class TexturePinSet {
+public:
+    ~TexturePinSet() { Clear(); }
+    
+    void Update(const std::vector<std::string>& urls);
+    void Clear();
+
+private:
+    std::set<std::string> mUrls;
 };
@@ -0,0 +1,851 @@
+#include "InstalledThemeIndex.hpp"
+#include "FileLogger.hpp"
+#include "rapidjson/document.h"
+#include "rapidjson/writer.h"
+#include "rapidjson/stringbuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define THEMES_ROOT "fs:/vol/external01/wiiu/themes"
+#define INSTALLED_THEMES_ROOT "fs:/vol/external01/UTheme/installed"
+
+// 索引文件不能放在被校验的两个目录里, 否则写索引会改变目录修改时间
+#define INDEX_DIR "fs:/vol/external01/UTheme"
+#define INDEX_SNAPSHOT INDEX_DIR "/installed_index.json"
+#define INDEX_SNAPSHOT_TMP INDEX_DIR "/installed_index.tmp"
+#define INDEX_JOURNAL INDEX_DIR "/installed_index.journal"
+#define INDEX_VERSION 1
+
+// 日志条数超过该值时合并为新快照
+#define JOURNAL_COMPACT_THRESHOLD 32
+
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+namespace {
+
+bool ReadWholeFile(const std::string& path, std::string& out) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+    
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    rewind(fp);
+    
+    if (size < 0) {
+        fclose(fp);
+        return false;
+    }
+    
+    out.resize(size);
+    size_t readSize = size > 0 ? fread(&out[0], 1, size, fp) : 0;
+    out.resize(readSize);
+    fclose(fp);
+    return true;
+}
+
+std::string GetString(const rapidjson::Value& obj, const char* key) {
+    if (obj.HasMember(key) && obj[key].IsString()) {
+        return obj[key].GetString();
+    }
+    return "";
+}
+
+int GetInt(const rapidjson::Value& obj, const char* key) {
+    if (obj.HasMember(key) && obj[key].IsInt()) {
+        return obj[key].GetInt();
+    }
+    return 0;
+}
+
+int64_t GetInt64(const rapidjson::Value& obj, const char* key) {
+    if (obj.HasMember(key) && obj[key].IsInt64()) {
+        return obj[key].GetInt64();
+    }
+    return 0;
+}
+
+void WriteFolderRecord(JsonWriter& w, const LocalThemeRecord& r) {
+    w.StartObject();
+    w.Key("folder"); w.String(r.folder.c_str());
+    w.Key("mtime"); w.Int64(r.mtime);
+    w.Key("id"); w.String(r.id.c_str());
+    w.Key("shortId"); w.String(r.shortId.c_str());
+    w.Key("author"); w.String(r.author.c_str());
+    w.Key("description"); w.String(r.description.c_str());
+    w.Key("downloads"); w.Int(r.downloads);
+    w.Key("likes"); w.Int(r.likes);
+    w.Key("updatedAt"); w.String(r.updatedAt.c_str());
+    w.Key("tags");
+    w.StartArray();
+    for (const auto& tag : r.tags) {
+        w.String(tag.c_str());
+    }
+    w.EndArray();
+    w.Key("hasPatched"); w.Bool(r.hasPatched);
+    w.Key("bpsCount"); w.Int(r.bpsCount);
+    w.Key("collageThumb"); w.String(r.collageThumbPath.c_str());
+    w.Key("collageHd"); w.String(r.collageHdPath.c_str());
+    w.Key("launcherThumb"); w.String(r.launcherThumbPath.c_str());
+    w.Key("launcherHd"); w.String(r.launcherHdPath.c_str());
+    w.Key("warawaraThumb"); w.String(r.warawaraThumbPath.c_str());
+    w.Key("warawaraHd"); w.String(r.warawaraHdPath.c_str());
+    w.EndObject();
+}
+
+bool ReadFolderRecord(const rapidjson::Value& v, LocalThemeRecord& r) {
+    if (!v.IsObject()) {
+        return false;
+    }
+    
+    r.folder = GetString(v, "folder");
+    if (r.folder.empty()) {
+        return false;
+    }
+    
+    r.mtime = GetInt64(v, "mtime");
+    r.id = GetString(v, "id");
+    r.shortId = GetString(v, "shortId");
+    r.author = GetString(v, "author");
+    r.description = GetString(v, "description");
+    r.downloads = GetInt(v, "downloads");
+    r.likes = GetInt(v, "likes");
+    r.updatedAt = GetString(v, "updatedAt");
+    r.tags.clear();
+    if (v.HasMember("tags") && v["tags"].IsArray()) {
+        for (const auto& tag : v["tags"].GetArray()) {
+            if (tag.IsString()) {
+                r.tags.push_back(tag.GetString());
+            }
+        }
+    }
+    r.hasPatched = v.HasMember("hasPatched") && v["hasPatched"].IsBool() && v["hasPatched"].GetBool();
+    r.bpsCount = GetInt(v, "bpsCount");
+    r.collageThumbPath = GetString(v, "collageThumb");
+    r.collageHdPath = GetString(v, "collageHd");
+    r.launcherThumbPath = GetString(v, "launcherThumb");
+    r.launcherHdPath = GetString(v, "launcherHd");
+    r.warawaraThumbPath = GetString(v, "warawaraThumb");
+    r.warawaraHdPath = GetString(v, "warawaraHd");
+    return true;
+}
+
+void WriteInstalledRecord(JsonWriter& w, const InstalledThemeRecord& r) {
+    w.StartObject();
+    w.Key("id"); w.String(r.id.c_str());
+    w.Key("name"); w.String(r.name.c_str());
+    w.Key("author"); w.String(r.author.c_str());
+    w.Key("installPath"); w.String(r.installPath.c_str());
+    w.EndObject();
+}
+
+bool ReadInstalledRecord(const rapidjson::Value& v, InstalledThemeRecord& r) {
+    if (!v.IsObject()) {
+        return false;
+    }
+    
+    r.id = GetString(v, "id");
+    r.name = GetString(v, "name");
+    r.author = GetString(v, "author");
+    r.installPath = GetString(v, "installPath");
+    return !r.id.empty();
+}
+
+// 一条日志记录占一行: {"op":..., "tm":..., "im":..., "data":...}
+// 每条记录都带上写入后的目录修改时间, 重放后索引即与目录一致
+std::string BuildJournalLine(const char* op, int64_t themesMtime, int64_t installedMtime,
+                             const std::function<void(JsonWriter&)>& writeData) {
+    rapidjson::StringBuffer buffer;
+    JsonWriter w(buffer);
+    w.StartObject();
+    w.Key("op"); w.String(op);
+    w.Key("tm"); w.Int64(themesMtime);
+    w.Key("im"); w.Int64(installedMtime);
+    w.Key("data");
+    writeData(w);
+    w.EndObject();
+    return buffer.GetString();
+}
+
+// 查找存在的图片文件 (尝试多种扩展名), 都不存在时返回 .jpg (兼容旧逻辑)
+std::string FindImage(const std::string& basePath) {
+    const char* extensions[] = {".webp", ".jpg", ".jpeg", ".png"};
+    struct stat st;
+    for (const char* ext : extensions) {
+        std::string path = basePath + ext;
+        if (stat(path.c_str(), &st) == 0) {
+            return path;
+        }
+    }
+    return basePath + ".jpg";
+}
+
+} // namespace
+
+InstalledThemeIndex& InstalledThemeIndex::GetInstance() {
+    static InstalledThemeIndex instance;
+    return instance;
+}
+
+std::string InstalledThemeIndex::FolderFromPath(const std::string& path) {
+    size_t end = path.find_last_not_of('/');
+    if (end == std::string::npos) {
+        return "";
+    }
+    size_t start = path.rfind('/', end);
+    start = (start == std::string::npos) ? 0 : start + 1;
+    return path.substr(start, end - start + 1);
+}
+
+int64_t InstalledThemeIndex::GetMtime(const char* path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return 0;
+    }
+    return (int64_t)st.st_mtime;
+}
+
+void InstalledThemeIndex::Load() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mLoaded) {
+        LoadLocked();
+    } else {
+        ValidateLocked();
+    }
+}
+
+void InstalledThemeIndex::Rescan() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    auto t1 = std::chrono::steady_clock::now();
+    
+    // 清除记录中的修改时间, ReconcileFolders 会重新扫描每个目录
+    for (auto& folder : mFolders) {
+        folder.second.mtime = -1;
+    }
+    ReconcileFolders();
+    ReconcileInstalled();
+    mThemesMtime = GetMtime(THEMES_ROOT);
+    mInstalledMtime = GetMtime(INSTALLED_THEMES_ROOT);
+    WriteSnapshot();
+    
+    auto t2 = std::chrono::steady_clock::now();
+    FileLogger::GetInstance().LogInfo("  [+%lldms] Installed index rescanned (%zu folders, %zu installed)",
+        std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(),
+        mFolders.size(), mInstalled.size());
+}
+
+void InstalledThemeIndex::EnsureLoadedLocked() {
+    if (!mLoaded) {
+        LoadLocked();
+    }
+}
+
+void InstalledThemeIndex::LoadLocked() {
+    auto t1 = std::chrono::steady_clock::now();
+    
+    mLoaded = true;
+    mFolders.clear();
+    mInstalled.clear();
+    mThemesMtime = 0;
+    mInstalledMtime = 0;
+    mJournalCount = 0;
+    
+    // 写快照中途断电时 (旧快照已删除, 新快照未改名) 使用临时文件
+    bool hasSnapshot = ReadSnapshot(INDEX_SNAPSHOT) || ReadSnapshot(INDEX_SNAPSHOT_TMP);
+    ReplayJournal();
+    
+    auto t2 = std::chrono::steady_clock::now();
+    FileLogger::GetInstance().LogInfo("  [+%lldms] Installed index loaded (%zu folders, %zu installed, %d journal entries%s)",
+        std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(),
+        mFolders.size(), mInstalled.size(), mJournalCount, hasSnapshot ? "" : ", no snapshot");
+    
+    ValidateLocked();
+}
+
+void InstalledThemeIndex::ValidateLocked() {
+    auto t1 = std::chrono::steady_clock::now();
+    bool dirty = false;
+    
+    // 目录修改时间与索引一致且目录名单相同时直接信任索引, 不逐个检查主题目录
+    // (SD 卡 FAT 上根目录修改时间不一定随增删变化, 名单只需读取目录项, 开销很小)
+    int64_t themesMtime = GetMtime(THEMES_ROOT);
+    if (themesMtime == 0 || themesMtime != mThemesMtime || !FolderNamesMatch()) {
+        dirty |= ReconcileFolders();
+        dirty |= (themesMtime != mThemesMtime);
+        mThemesMtime = themesMtime;
+    }
+    
+    int64_t installedMtime = GetMtime(INSTALLED_THEMES_ROOT);
+    if (installedMtime == 0 || installedMtime != mInstalledMtime) {
+        dirty |= ReconcileInstalled();
+        dirty |= (installedMtime != mInstalledMtime);
+        mInstalledMtime = installedMtime;
+    }
+    
+    if (dirty) {
+        WriteSnapshot();
+        
+        auto t2 = std::chrono::steady_clock::now();
+        FileLogger::GetInstance().LogInfo("  [+%lldms] Installed index revalidated (%zu folders, %zu installed)",
+            std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(),
+            mFolders.size(), mInstalled.size());
+    }
+}
+
+bool InstalledThemeIndex::ReadSnapshot(const char* path) {
+    std::string content;
+    if (!ReadWholeFile(path, content) || content.empty()) {
+        return false;
+    }
+    
+    rapidjson::Document root;
+    root.Parse(content.c_str());
+    if (root.HasParseError() || !root.IsObject() || GetInt(root, "version") != INDEX_VERSION) {
+        FileLogger::GetInstance().LogWarning("Installed index snapshot invalid: %s", path);
+        return false;
+    }
+    
+    mThemesMtime = GetInt64(root, "themesMtime");
+    mInstalledMtime = GetInt64(root, "installedMtime");
+    
+    if (root.HasMember("folders") && root["folders"].IsArray()) {
+        const auto& folders = root["folders"];
+        mFolders.reserve(folders.Size());
+        for (const auto& v : folders.GetArray()) {
+            LocalThemeRecord record;
+            if (ReadFolderRecord(v, record)) {
+                mFolders[record.folder] = std::move(record);
+            }
+        }
+    }
+    
+    if (root.HasMember("installed") && root["installed"].IsArray()) {
+        for (const auto& v : root["installed"].GetArray()) {
+            InstalledThemeRecord record;
+            if (ReadInstalledRecord(v, record)) {
+                mInstalled[record.id] = std::move(record);
+            }
+        }
+    }
+    
+    return true;
+}
+
+void InstalledThemeIndex::ReplayJournal() {
+    std::string content;
+    if (!ReadWholeFile(INDEX_JOURNAL, content)) {
+        return;
+    }
+    
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t end = content.find('\n', pos);
+        if (end == std::string::npos) {
+            end = content.size();
+        }
+        std::string line = content.substr(pos, end - pos);
+        pos = end + 1;
+        
+        if (line.empty()) {
+            continue;
+        }
+        
+        // 写入中断的最后一行解析失败, 直接忽略
+        rapidjson::Document entry;
+        entry.Parse(line.c_str());
+        if (entry.HasParseError() || !entry.IsObject() || !entry.HasMember("data")) {
+            FileLogger::GetInstance().LogWarning("Installed index: ignoring corrupt journal entry");
+            continue;
+        }
+        
+        std::string op = GetString(entry, "op");
+        const auto& data = entry["data"];
+        
+        if (op == "folder") {
+            LocalThemeRecord record;
+            if (ReadFolderRecord(data, record)) {
+                mFolders[record.folder] = std::move(record);
+            }
+        } else if (op == "rmfolder" && data.IsString()) {
+            mFolders.erase(data.GetString());
+        } else if (op == "install") {
+            InstalledThemeRecord record;
+            if (ReadInstalledRecord(data, record)) {
+                mInstalled[record.id] = std::move(record);
+            }
+        } else if (op == "uninstall" && data.IsString()) {
+            mInstalled.erase(data.GetString());
+        } else {
+            continue;
+        }
+        
+        mThemesMtime = GetInt64(entry, "tm");
+        mInstalledMtime = GetInt64(entry, "im");
+        mJournalCount++;
+    }
+}
+
+bool InstalledThemeIndex::WriteSnapshot() {
+    rapidjson::StringBuffer buffer;
+    JsonWriter w(buffer);
+    w.StartObject();
+    w.Key("version"); w.Int(INDEX_VERSION);
+    w.Key("themesMtime"); w.Int64(mThemesMtime);
+    w.Key("installedMtime"); w.Int64(mInstalledMtime);
+    w.Key("folders");
+    w.StartArray();
+    for (const auto& pair : mFolders) {
+        WriteFolderRecord(w, pair.second);
+    }
+    w.EndArray();
+    w.Key("installed");
+    w.StartArray();
+    for (const auto& pair : mInstalled) {
+        WriteInstalledRecord(w, pair.second);
+    }
+    w.EndArray();
+    w.EndObject();
+    
+    mkdir(INDEX_DIR, 0777);
+    
+    // 先写临时文件再改名, 避免写一半的快照
+    FILE* fp = fopen(INDEX_SNAPSHOT_TMP, "wb");
+    if (!fp) {
+        FileLogger::GetInstance().LogError("Installed index: failed to create %s", INDEX_SNAPSHOT_TMP);
+        return false;
+    }
+    
+    bool ok = fwrite(buffer.GetString(), 1, buffer.GetSize(), fp) == buffer.GetSize();
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok) {
+        FileLogger::GetInstance().LogError("Installed index: failed to write snapshot");
+        remove(INDEX_SNAPSHOT_TMP);
+        return false;
+    }
+    
+    // FAT 上 rename 不能覆盖已有文件
+    remove(INDEX_SNAPSHOT);
+    if (rename(INDEX_SNAPSHOT_TMP, INDEX_SNAPSHOT) != 0) {
+        FileLogger::GetInstance().LogError("Installed index: failed to rename snapshot");
+        return false;
+    }
+    
+    // 快照已包含所有日志记录
+    remove(INDEX_JOURNAL);
+    mJournalCount = 0;
+    return true;
+}
+
+void InstalledThemeIndex::AppendJournal(std::string line) {
+    line += '\n';
+    
+    FILE* fp = fopen(INDEX_JOURNAL, "ab");
+    if (!fp) {
+        mkdir(INDEX_DIR, 0777);
+        fp = fopen(INDEX_JOURNAL, "ab");
+    }
+    if (!fp) {
+        FileLogger::GetInstance().LogError("Installed index: failed to open journal");
+        return;
+    }
+    
+    fwrite(line.c_str(), 1, line.size(), fp);
+    fflush(fp);
+    fclose(fp);
+    
+    if (++mJournalCount >= JOURNAL_COMPACT_THRESHOLD) {
+        WriteSnapshot();
+    }
+}
+
+bool InstalledThemeIndex::FolderNamesMatch() const {
+    DIR* dir = opendir(THEMES_ROOT);
+    if (!dir) {
+        return mFolders.empty();
+    }
+    
+    size_t count = 0;
+    bool match = true;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_type != DT_DIR) continue;
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        
+        count++;
+        if (!mFolders.count(entry->d_name)) {
+            match = false;
+            break;
+        }
+    }
+    closedir(dir);
+    
+    return match && count == mFolders.size();
+}
+
+bool InstalledThemeIndex::ReconcileFolders() {
+    DIR* dir = opendir(THEMES_ROOT);
+    if (!dir) {
+        bool hadFolders = !mFolders.empty();
+        mFolders.clear();
+        return hadFolders;
+    }
+    
+    std::unordered_map<std::string, LocalThemeRecord> folders;
+    folders.reserve(mFolders.size());
+    
+    int rescanned = 0;
+    size_t matched = 0;
+    
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_type != DT_DIR) continue;
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        
+        std::string folder = entry->d_name;
+        int64_t mtime = GetMtime((std::string(THEMES_ROOT) + "/" + folder).c_str());
+        
+        // 目录修改时间未变, 沿用索引中的记录
+        auto it = mFolders.find(folder);
+        if (it != mFolders.end()) {
+            matched++;
+            if (mtime != 0 && it->second.mtime == mtime) {
+                folders[folder] = std::move(it->second);
+                continue;
+            }
+        }
+        
+        LocalThemeRecord record;
+        if (ScanFolder(folder, mtime, record)) {
+            folders[folder] = std::move(record);
+            rescanned++;
+        }
+    }
+    closedir(dir);
+    
+    size_t removed = mFolders.size() - matched;
+    mFolders.swap(folders);
+    
+    FileLogger::GetInstance().LogInfo("Installed index: %d theme folders rescanned, %zu removed (%zu total)",
+        rescanned, removed, mFolders.size());
+    
+    return rescanned > 0 || removed > 0;
+}
+
+bool InstalledThemeIndex::ReconcileInstalled() {
+    DIR* dir = opendir(INSTALLED_THEMES_ROOT);
+    if (!dir) {
+        bool hadInstalled = !mInstalled.empty();
+        mInstalled.clear();
+        return hadInstalled;
+    }
+    
+    std::unordered_map<std::string, InstalledThemeRecord> installed;
+    installed.reserve(mInstalled.size());
+    
+    int added = 0;
+    
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_type != DT_REG) continue;
+        
+        std::string filename = entry->d_name;
+        if (filename.length() <= 5 || filename.substr(filename.length() - 5) != ".json") {
+            continue;
+        }
+        std::string id = filename.substr(0, filename.length() - 5);
+        
+        // 安装记录只在安装时写入, 已知 ID 不需要重新读取
+        auto it = mInstalled.find(id);
+        if (it != mInstalled.end()) {
+            installed[id] = std::move(it->second);
+            continue;
+        }
+        
+        InstalledThemeRecord record;
+        if (ReadInstalledFile(id, record)) {
+            installed[id] = std::move(record);
+            added++;
+        }
+    }
+    closedir(dir);
+    
+    size_t removed = mInstalled.size() - (installed.size() - added);
+    mInstalled.swap(installed);
+    
+    FileLogger::GetInstance().LogInfo("Installed index: %d install records read, %zu removed (%zu total)",
+        added, removed, mInstalled.size());
+    
+    return added > 0 || removed > 0;
+}
+
+bool InstalledThemeIndex::ScanFolder(const std::string& folder, int64_t mtime, LocalThemeRecord& out) {
+    std::string path = std::string(THEMES_ROOT) + "/" + folder;
+    
+    out = LocalThemeRecord();
+    out.folder = folder;
+    out.mtime = mtime;
+    out.author = "Unknown";
+    
+    // 元数据: theme_info.json (下载/本地安装时写入)
+    std::string content;
+    if (ReadWholeFile(path + "/theme_info.json", content)) {
+        rapidjson::Document root;
+        root.Parse(content.c_str());
+        if (!root.HasParseError() && root.IsObject()) {
+            out.id = GetString(root, "id");
+            out.shortId = GetString(root, "shortId");
+            std::string author = GetString(root, "author");
+            if (!author.empty()) {
+                out.author = author;
+            }
+            out.description = GetString(root, "description");
+            out.downloads = GetInt(root, "downloads");
+            out.likes = GetInt(root, "likes");
+            out.updatedAt = GetString(root, "updatedAt");
+            if (root.HasMember("tags") && root["tags"].IsArray()) {
+                for (const auto& tag : root["tags"].GetArray()) {
+                    if (tag.IsString()) {
+                        out.tags.push_back(tag.GetString());
+                    }
+                }
+            }
+        } else {
+            FileLogger::GetInstance().LogWarning("Installed index: failed to parse theme_info.json for %s", folder.c_str());
+        }
+    }
+    
+    // 没有 theme_info.json 时尝试从 metadata.json 取 ID: "id", "themeID", "Metadata.id", "Metadata.themeID"
+    if (out.id.empty() && ReadWholeFile(path + "/metadata.json", content)) {
+        rapidjson::Document root;
+        root.Parse(content.c_str());
+        if (!root.HasParseError() && root.IsObject()) {
+            out.id = GetString(root, "id");
+            if (out.id.empty()) {
+                out.id = GetString(root, "themeID");
+            }
+            if (out.id.empty() && root.HasMember("Metadata") && root["Metadata"].IsObject()) {
+                const auto& metaObj = root["Metadata"];
+                out.id = GetString(metaObj, "id");
+                if (out.id.empty()) {
+                    out.id = GetString(metaObj, "themeID");
+                }
+            }
+        }
+    }
+    
+    // 修补完成的文件 (Men.pack 或 Men2.pack)
+    std::string packageDir = path + "/content/Common/Package";
+    struct stat st;
+    out.hasPatched = (stat((packageDir + "/Men.pack").c_str(), &st) == 0) ||
+                     (stat((packageDir + "/Men2.pack").c_str(), &st) == 0);
+    
+    // 统计 BPS 文件数量
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return false;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        size_t len = strlen(entry->d_name);
+        if (len > 4 && strcmp(entry->d_name + len - 4, ".bps") == 0) {
+            out.bpsCount++;
+        }
+    }
+    closedir(dir);
+    
+    // 图片路径 - 新格式在 images/ 子目录, 旧格式直接在主题根目录
+    std::string imagesDir = path + "/images";
+    bool hasImagesDir = (stat(imagesDir.c_str(), &st) == 0 && S_ISDIR(st.st_mode));
+    std::string imageBase = hasImagesDir ? imagesDir : path;
+    
+    out.collageThumbPath = FindImage(imageBase + "/collage_thumb");
+    out.collageHdPath = FindImage(imageBase + "/collage");
+    out.launcherThumbPath = FindImage(imageBase + "/launcher_thumb");
+    out.launcherHdPath = FindImage(imageBase + "/launcher");
+    out.warawaraThumbPath = FindImage(imageBase + "/warawara_thumb");
+    out.warawaraHdPath = FindImage(imageBase + "/warawara");
+    
+    return true;
+}
+
+bool InstalledThemeIndex::ReadInstalledFile(const std::string& id, InstalledThemeRecord& out) {
+    std::string content;
+    if (!ReadWholeFile(std::string(INSTALLED_THEMES_ROOT) + "/" + id + ".json", content)) {
+        return false;
+    }
+    
+    out = InstalledThemeRecord();
+    out.id = id;
+    
+    rapidjson::Document root;
+    root.Parse(content.c_str());
+    if (!root.HasParseError() && root.IsObject()) {
+        out.name = GetString(root, "themeName");
+        out.author = GetString(root, "themeAuthor");
+        out.installPath = GetString(root, "installPath");
+    } else {
+        // 记录文件损坏也视为已安装, 只是缺少名称等信息
+        FileLogger::GetInstance().LogWarning("Installed index: failed to parse install record %s", id.c_str());
+    }
+    
+    return true;
+}
+
+std::vector<LocalThemeRecord> InstalledThemeIndex::GetLocalThemes() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    std::vector<LocalThemeRecord> themes;
+    themes.reserve(mFolders.size());
+    for (const auto& pair : mFolders) {
+        themes.push_back(pair.second);
+    }
+    
+    std::sort(themes.begin(), themes.end(), [](const LocalThemeRecord& a, const LocalThemeRecord& b) {
+        return a.folder < b.folder;
+    });
+    return themes;
+}
+
+std::string InstalledThemeIndex::FindFolderById(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    if (id.empty()) {
+        return "";
+    }
+    
+    // 优先使用安装记录中的安装路径
+    auto it = mInstalled.find(id);
+    if (it != mInstalled.end() && !it->second.installPath.empty()) {
+        std::string folder = FolderFromPath(it->second.installPath);
+        if (mFolders.count(folder)) {
+            return folder;
+        }
+    }
+    
+    for (const auto& pair : mFolders) {
+        if (pair.second.id == id) {
+            return pair.first;
+        }
+    }
+    return "";
+}
+
+bool InstalledThemeIndex::IsInstalled(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    return mInstalled.count(id) > 0;
+}
+
+bool InstalledThemeIndex::GetInstalled(const std::string& id, InstalledThemeRecord& out) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    auto it = mInstalled.find(id);
+    if (it == mInstalled.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
+}
+
+std::vector<InstalledThemeRecord> InstalledThemeIndex::GetInstalledThemes() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    std::vector<InstalledThemeRecord> records;
+    records.reserve(mInstalled.size());
+    for (const auto& pair : mInstalled) {
+        records.push_back(pair.second);
+    }
+    return records;
+}
+
+std::set<std::string> InstalledThemeIndex::GetInstalledIds() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    std::set<std::string> ids;
+    for (const auto& pair : mInstalled) {
+        ids.insert(pair.first);
+    }
+    return ids;
+}
+
+void InstalledThemeIndex::RecordInstall(const InstalledThemeRecord& record) {
+    if (record.id.empty()) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    mInstalled[record.id] = record;
+    
+    AppendJournal(BuildJournalLine("install", mThemesMtime, mInstalledMtime, [&record](JsonWriter& w) {
+        WriteInstalledRecord(w, record);
+    }));
+}
+
+void InstalledThemeIndex::RecordUninstall(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    mInstalled.erase(id);
+    
+    AppendJournal(BuildJournalLine("uninstall", mThemesMtime, mInstalledMtime, [&id](JsonWriter& w) {
+        w.String(id.c_str());
+    }));
+}
+
+void InstalledThemeIndex::RefreshFolder(const std::string& folder) {
+    if (folder.empty()) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    
+    int64_t mtime = GetMtime((std::string(THEMES_ROOT) + "/" + folder).c_str());
+    LocalThemeRecord record;
+    if (mtime == 0 || !ScanFolder(folder, mtime, record)) {
+        // 目录已不存在
+        RemoveFolderLocked(folder);
+        return;
+    }
+    
+    // 只更新这一个目录; 根目录修改时间只在完整扫描后更新, 否则同一时间内的其他外部修改会被当作已校验
+    mFolders[folder] = record;
+    
+    AppendJournal(BuildJournalLine("folder", mThemesMtime, mInstalledMtime, [&record](JsonWriter& w) {
+        WriteFolderRecord(w, record);
+    }));
+}
+
+void InstalledThemeIndex::RemoveFolder(const std::string& folder) {
+    if (folder.empty()) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    EnsureLoadedLocked();
+    RemoveFolderLocked(folder);
+}
+
+void InstalledThemeIndex::RemoveFolderLocked(const std::string& folder) {
+    mFolders.erase(folder);
+    
+    AppendJournal(BuildJournalLine("rmfolder", mThemesMtime, mInstalledMtime, [&folder](JsonWriter& w) {
+        w.String(folder.c_str());
+    }));
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+// 本地主题目录记录 (wiiu/themes/<folder>)
+struct LocalThemeRecord {
+    std::string folder;      // 目录名
+    int64_t mtime = 0;       // 目录修改时间, 用于判断是否需要重新扫描
+    
+    std::string id;
+    std::string shortId;
+    std::string author;
+    std::string description;
+    int downloads = 0;
+    int likes = 0;
+    std::string updatedAt;
+    std::vector<std::string> tags;
+    
+    bool hasPatched = false;  // 是否已有修补完成的 Men.pack / Men2.pack
+    int bpsCount = 0;
+    
+    // 图片路径 (扫描时已确定扩展名)
+    std::string collageThumbPath;
+    std::string collageHdPath;
+    std::string launcherThumbPath;
+    std::string launcherHdPath;
+    std::string warawaraThumbPath;
+    std::string warawaraHdPath;
+};
+
+// 安装记录 (UTheme/installed/<id>.json)
+struct InstalledThemeRecord {
+    std::string id;
+    std::string name;
+    std::string author;
+    std::string installPath;
+};
+
+// 已安装/已下载主题索引
+// - 快照 + 追加日志保存在 UTheme/ 下, 启动后只加载一次到哈希表
+// - 用 wiiu/themes 和 UTheme/installed 的目录修改时间校验, 并比对 wiiu/themes 的目录名单 (只读目录项);
+//   都未变化时不逐个检查主题目录, 变化时只重新扫描修改时间不同的主题目录
+// - 安装/卸载/下载完成时由调用方写入一条日志记录, 日志过长时合并为新快照
+class InstalledThemeIndex {
+public:
+    static InstalledThemeIndex& GetInstance();
+    
+    // 加载 (首次) 并校验索引, 可重复调用
+    void Load();
+    
+    // 手动刷新: 不信任目录修改时间, 重新扫描所有主题目录和安装记录 (例如从电脑复制到 SD 卡的主题)
+    void Rescan();
+    
+    // 本地主题目录 (按目录名排序)
+    std::vector<LocalThemeRecord> GetLocalThemes();
+    
+    // 按主题 ID 查找所在目录名, 找不到返回空字符串
+    std::string FindFolderById(const std::string& id);
+    
+    // 安装记录
+    bool IsInstalled(const std::string& id);
+    bool GetInstalled(const std::string& id, InstalledThemeRecord& out);
+    std::vector<InstalledThemeRecord> GetInstalledThemes();
+    std::set<std::string> GetInstalledIds();
+    
+    // 事务更新: 修改内存索引并追加一条日志
+    void RecordInstall(const InstalledThemeRecord& record);
+    void RecordUninstall(const std::string& id);
+    void RefreshFolder(const std::string& folder);  // 重新扫描一个主题目录
+    void RemoveFolder(const std::string& folder);
+    
+    // 从完整路径取目录名 (fs:/.../wiiu/themes/Name/ -> Name)
+    static std::string FolderFromPath(const std::string& path);
+
+private:
+    InstalledThemeIndex() = default;
+    ~InstalledThemeIndex() = default;
+    InstalledThemeIndex(const InstalledThemeIndex&) = delete;
+    InstalledThemeIndex& operator=(const InstalledThemeIndex&) = delete;
+    
+    std::mutex mMutex;
+    bool mLoaded = false;
+    
+    std::unordered_map<std::string, LocalThemeRecord> mFolders;        // 目录名 -> 记录
+    std::unordered_map<std::string, InstalledThemeRecord> mInstalled;  // 主题 ID -> 安装记录
+    
+    int64_t mThemesMtime = 0;     // 索引对应的 wiiu/themes 修改时间
+    int64_t mInstalledMtime = 0;  // 索引对应的 UTheme/installed 修改时间
+    int mJournalCount = 0;        // 快照之后的日志条数
+    
+    void EnsureLoadedLocked();
+    void LoadLocked();
+    void ValidateLocked();
+    void RemoveFolderLocked(const std::string& folder);
+    bool ReadSnapshot(const char* path);
+    void ReplayJournal();
+    bool WriteSnapshot();
+    void AppendJournal(std::string line);
+    
+    bool FolderNamesMatch() const;  // wiiu/themes 下的目录名与索引一致
+    bool ReconcileFolders();
+    bool ReconcileInstalled();
+    static bool ScanFolder(const std::string& folder, int64_t mtime, LocalThemeRecord& out);
+    static bool ReadInstalledFile(const std::string& id, InstalledThemeRecord& out);
+    static int64_t GetMtime(const char* path);
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+// 编译后的语言包格式, 由 tools/langpack.cpp 在构建时从 data/*.json 生成
+// 所有整数为 Wii U 字节序 (大端), 运行时直接使用嵌入的数据, 不做解析
+//
+//   LangPackHeader
+//   LangPackEntry[tableSize]   按键 ID 开放寻址 (线性探测), 大小为 2 的幂
+//   char blob[blobSize]        UTF-8 文本, 每条以 '\0' 结尾
+
+constexpr uint32_t LANGPACK_MAGIC = 0x554C4E47;  // "ULNG"
+constexpr uint32_t LANGPACK_VERSION = 1;
+
+enum LangPackFlags : uint32_t {
+    LANGPACK_FLAG_CJK = 1 << 0,  // 文本含中日韩字符, 需要 CJK 字体
+};
+
+struct LangPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t count;      // 文本条数
+    uint32_t tableSize;  // 查找表槽数
+    uint32_t blobSize;
+};
+
+struct LangPackEntry {
+    uint32_t id;      // 键 ID, 0 表示空槽
+    uint32_t offset;  // 在 blob 中的位置
+    uint32_t length;  // 不含结尾的 '\0'
+};
+
+static_assert(sizeof(LangPackHeader) == 24, "LangPackHeader layout");
+static_assert(sizeof(LangPackEntry) == 12, "LangPackEntry layout");
+
+// 语言键哈希 (FNV-1a), 0 保留给空槽
+constexpr uint32_t LangHash(std::string_view key) {
+    uint32_t hash = 2166136261u;
+    for (char c : key) {
+        hash ^= (uint8_t)c;
+        hash *= 16777619u;
+    }
+    return hash ? hash : 1;
+}
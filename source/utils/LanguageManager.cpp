@@ -2,65 +2,42 @@
 #include "Config.hpp"
 #include "Utils.hpp"
 #include "logger.h"
+#include "FileLogger.hpp"
 #include "../Gfx.hpp"
-#include "rapidjson/document.h"
-#include <fstream>
-#include <sstream>
-#include <functional>
 #include <algorithm>
+#include <chrono>
 
-// 包含嵌入的语言文件
-#include <zh-cn_json.h>
-#include <zh-tw_json.h>
-#include <en-us_json.h>
-#include <ja-jp_json.h>
-#include <ko-kr_json.h>
-#include <fr-fr_json.h>
-#include <de-de_json.h>
-#include <es-es_json.h>
-#include <it-it_json.h>
-#include <ru-ru_json.h>
-#include <pt-br_json.h>
-#include <nl-nl_json.h>
-#include <pl-pl_json.h>
+// 包含嵌入的语言包 (构建时由 data/*.json 编译)
+#include <zh-cn_lang.h>
+#include <zh-tw_lang.h>
+#include <en-us_lang.h>
+#include <ja-jp_lang.h>
+#include <ko-kr_lang.h>
+#include <fr-fr_lang.h>
+#include <de-de_lang.h>
+#include <es-es_lang.h>
+#include <it-it_lang.h>
+#include <ru-ru_lang.h>
+#include <pt-br_lang.h>
+#include <nl-nl_lang.h>
+#include <pl-pl_lang.h>
 
-LanguageManager* LanguageManager::mInstance = nullptr;
+// 对应的界面字形图集 (构建时由语言包烘焙)
+#include <zh-cn_glyphs.h>
+#include <zh-tw_glyphs.h>
+#include <en-us_glyphs.h>
+#include <ja-jp_glyphs.h>
+#include <ko-kr_glyphs.h>
+#include <fr-fr_glyphs.h>
+#include <de-de_glyphs.h>
+#include <es-es_glyphs.h>
+#include <it-it_glyphs.h>
+#include <ru-ru_glyphs.h>
+#include <pt-br_glyphs.h>
+#include <nl-nl_glyphs.h>
+#include <pl-pl_glyphs.h>
 
-// 使用 rapidjson 解析平坦化的 JSON
-static std::map<std::string, std::string> ParseFlatJson(const std::string& jsonStr) {
-    std::map<std::string, std::string> result;
-    
-    try {
-        rapidjson::Document j;
-        j.Parse(jsonStr.c_str());
-        
-        if (j.HasParseError()) {
-            DEBUG_FUNCTION_LINE("JSON parsing failed: parse error");
-            return result;
-        }
-        
-        // 使用递归函数将嵌套的 JSON 对象平坦化
-        std::function<void(const rapidjson::Value&, const std::string&)> flatten;
-        flatten = [&](const rapidjson::Value& node, const std::string& prefix) {
-            if (node.IsObject()) {
-                for (auto it = node.MemberBegin(); it != node.MemberEnd(); ++it) {
-                    std::string key = prefix.empty() ? it->name.GetString() : prefix + "." + it->name.GetString();
-                    flatten(it->value, key);
-                }
-            } else if (node.IsString()) {
-                result[prefix] = node.GetString();
-            }
-            // 忽略其他类型（数组、数字等）
-        };
-        
-        flatten(j, "");
-        
-    } catch (const std::exception& e) {
-        DEBUG_FUNCTION_LINE("JSON parsing failed: %s", e.what());
-    }
-    
-    return result;
-}
+LanguageManager* LanguageManager::mInstance = nullptr;
 
 LanguageManager& LanguageManager::getInstance() {
     if (!mInstance) {
@@ -74,19 +51,19 @@ bool LanguageManager::Initialize() {
     
     // 设置可用语言
     mAvailableLanguages = {
-        {"zh-cn", "简体中文", "zh-cn.json"},
-        {"zh-tw", "繁體中文", "zh-tw.json"},
-        {"en-us", "English", "en-us.json"},
-        {"ja-jp", "日本語", "ja-jp.json"},
-        {"ko-kr", "한국어", "ko-kr.json"},
-        {"fr-fr", "Français", "fr-fr.json"},
-        {"de-de", "Deutsch", "de-de.json"},
-        {"es-es", "Español", "es-es.json"},
-        {"it-it", "Italiano", "it-it.json"},
-        {"ru-ru", "Русский", "ru-ru.json"},
-        {"pt-br", "Português", "pt-br.json"},
-        {"nl-nl", "Nederlands", "nl-nl.json"},
-        {"pl-pl", "Polski", "pl-pl.json"}
+        {"zh-cn", "简体中文", zh_cn_lang, zh_cn_lang_size, zh_cn_glyphs, zh_cn_glyphs_size},
+        {"zh-tw", "繁體中文", zh_tw_lang, zh_tw_lang_size, zh_tw_glyphs, zh_tw_glyphs_size},
+        {"en-us", "English", en_us_lang, en_us_lang_size, en_us_glyphs, en_us_glyphs_size},
+        {"ja-jp", "日本語", ja_jp_lang, ja_jp_lang_size, ja_jp_glyphs, ja_jp_glyphs_size},
+        {"ko-kr", "한국어", ko_kr_lang, ko_kr_lang_size, ko_kr_glyphs, ko_kr_glyphs_size},
+        {"fr-fr", "Français", fr_fr_lang, fr_fr_lang_size, fr_fr_glyphs, fr_fr_glyphs_size},
+        {"de-de", "Deutsch", de_de_lang, de_de_lang_size, de_de_glyphs, de_de_glyphs_size},
+        {"es-es", "Español", es_es_lang, es_es_lang_size, es_es_glyphs, es_es_glyphs_size},
+        {"it-it", "Italiano", it_it_lang, it_it_lang_size, it_it_glyphs, it_it_glyphs_size},
+        {"ru-ru", "Русский", ru_ru_lang, ru_ru_lang_size, ru_ru_glyphs, ru_ru_glyphs_size},
+        {"pt-br", "Português", pt_br_lang, pt_br_lang_size, pt_br_glyphs, pt_br_glyphs_size},
+        {"nl-nl", "Nederlands", nl_nl_lang, nl_nl_lang_size, nl_nl_glyphs, nl_nl_glyphs_size},
+        {"pl-pl", "Polski", pl_pl_lang, pl_pl_lang_size, pl_pl_glyphs, pl_pl_glyphs_size}
     };
     
     // 加载设置
@@ -107,86 +84,60 @@ bool LanguageManager::Initialize() {
 bool LanguageManager::LoadLanguage(const std::string& languageCode) {
     DEBUG_FUNCTION_LINE("Loading language: %s", languageCode.c_str());
     
-    // 获取嵌入的语言数据
-    const uint8_t* langData = nullptr;
-    size_t langSize = 0;
-    
-    if (languageCode == "zh-cn") {
-        langData = zh_cn_json;
-        langSize = zh_cn_json_size;
-    } else if (languageCode == "zh-tw") {
-        langData = zh_tw_json;
-        langSize = zh_tw_json_size;
-    } else if (languageCode == "en-us") {
-        langData = en_us_json;
-        langSize = en_us_json_size;
-    } else if (languageCode == "ja-jp") {
-        langData = ja_jp_json;
-        langSize = ja_jp_json_size;
-    } else if (languageCode == "ko-kr") {
-        langData = ko_kr_json;
-        langSize = ko_kr_json_size;
-    } else if (languageCode == "fr-fr") {
-        langData = fr_fr_json;
-        langSize = fr_fr_json_size;
-    } else if (languageCode == "de-de") {
-        langData = de_de_json;
-        langSize = de_de_json_size;
-    } else if (languageCode == "es-es") {
-        langData = es_es_json;
-        langSize = es_es_json_size;
-    } else if (languageCode == "it-it") {
-        langData = it_it_json;
-        langSize = it_it_json_size;
-    } else if (languageCode == "ru-ru") {
-        langData = ru_ru_json;
-        langSize = ru_ru_json_size;
-    } else if (languageCode == "pt-br") {
-        langData = pt_br_json;
-        langSize = pt_br_json_size;
-    } else if (languageCode == "nl-nl") {
-        langData = nl_nl_json;
-        langSize = nl_nl_json_size;
-    } else if (languageCode == "pl-pl") {
-        langData = pl_pl_json;
-        langSize = pl_pl_json_size;
+    const LanguageInfo* info = nullptr;
+    for (const auto& lang : mAvailableLanguages) {
+        if (lang.code == languageCode) {
+            info = &lang;
+            break;
+        }
     }
     
-    if (!langData || langSize == 0) {
+    if (!info || !info->pack || info->packSize < sizeof(LangPackHeader)) {
         DEBUG_FUNCTION_LINE("Language data not found: %s", languageCode.c_str());
         return false;
     }
     
-    // 转换为字符串
-    std::string content(reinterpret_cast<const char*>(langData), langSize);
+    // 语言包已在构建时校验并生成查找表, 这里只检查头部后切换指针
+    auto t1 = std::chrono::steady_clock::now();
+    const LangPackHeader* header = reinterpret_cast<const LangPackHeader*>(info->pack);
+    const size_t tableBytes = (size_t)header->tableSize * sizeof(LangPackEntry);
     
-    if (content.empty()) {
-        DEBUG_FUNCTION_LINE("Language content is empty: %s", languageCode.c_str());
+    if (header->magic != LANGPACK_MAGIC || header->version != LANGPACK_VERSION ||
+        header->tableSize == 0 || (header->tableSize & (header->tableSize - 1)) != 0 ||
+        sizeof(LangPackHeader) + tableBytes + header->blobSize > info->packSize) {
+        DEBUG_FUNCTION_LINE("Invalid language pack: %s", languageCode.c_str());
         return false;
     }
     
-    // 解析JSON
-    mTexts = ParseFlatJson(content);
+    mTextTable = reinterpret_cast<const LangPackEntry*>(info->pack + sizeof(LangPackHeader));
+    mTextBlob = reinterpret_cast<const char*>(info->pack + sizeof(LangPackHeader) + tableBytes);
+    mTextMask = header->tableSize - 1;
+    mTextCount = header->count;
     
-    if (mTexts.empty()) {
-        DEBUG_FUNCTION_LINE("Failed to parse language data: %s", languageCode.c_str());
-        return false;
+    auto t2 = std::chrono::steady_clock::now();
+    FileLogger::GetInstance().LogInfo("  [+%lldus] Language %s loaded (%zu texts, %u bytes)",
+        std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count(),
+        languageCode.c_str(), mTextCount, (unsigned)info->packSize);
+    
+    if (FileLogger::GetInstance().IsVerbose()) {
+        RunLookupBenchmark();
     }
     
     mCurrentLanguage = languageCode;
     
-    // Determine if language needs CJK font or Latin font
-    // CJK languages: zh-cn, zh-tw, ja-jp, ko-kr
-    // All others use Latin/Cyrillic font (Noto Sans)
-    bool needsCJKFont = (languageCode == "zh-cn" || 
-                         languageCode == "zh-tw" || 
-                         languageCode == "ja-jp" || 
-                         languageCode == "ko-kr");
+    // CJK 字体标志由构建工具根据文本内容决定 (zh-cn, zh-tw, ja-jp, ko-kr)
+    // 其他语言使用 Latin/Cyrillic 字体 (Noto Sans)
+    bool needsCJKFont = (header->flags & LANGPACK_FLAG_CJK) != 0;
     
     Gfx::SetUseLatinFont(!needsCJKFont);
     
+    // 界面文本在常用字号下的字形和图标已在构建时烘焙, 整张图集作为一个纹理载入, 不再运行时光栅化
+    if (!Gfx::LoadGlyphAtlas(info->atlas, info->atlasSize)) {
+        DEBUG_FUNCTION_LINE("Glyph atlas unavailable for %s, glyphs are rendered on demand", languageCode.c_str());
+    }
+    
     DEBUG_FUNCTION_LINE("Successfully loaded language: %s (%d texts), using %s font", 
-                       languageCode.c_str(), (int)mTexts.size(),
+                       languageCode.c_str(), (int)mTextCount,
                        needsCJKFont ? "CJK" : "Latin");
     
     // 测试几个关键键是否存在
@@ -196,15 +147,54 @@ bool LanguageManager::LoadLanguage(const std::string& languageCode) {
     return true;
 }
 
-std::string LanguageManager::GetText(const std::string& key) const {
-    auto it = mTexts.find(key);
-    if (it != mTexts.end()) {
-        return it->second;
+LangText LanguageManager::GetText(LangKey key) const {
+    if (mTextTable) {
+        uint32_t slot = key.id & mTextMask;
+        while (mTextTable[slot].id != 0) {
+            const LangPackEntry& entry = mTextTable[slot];
+            if (entry.id == key.id) {
+                return LangText(mTextBlob + entry.offset, entry.length);
+            }
+            slot = (slot + 1) & mTextMask;
+        }
     }
     
     // 如果没找到，返回键本身
-    // DEBUG_FUNCTION_LINE("Language key not found: %s (total keys: %d)", key.c_str(), (int)mTexts.size());
-    return key;
+    return LangText(key.name);
+}
+
+void LanguageManager::RunLookupBenchmark() const {
+    // 模拟 DownloadScreen::Draw 每帧的底部栏提示: 6 次查找 + 拼接
+    static constexpr LangKey keys[] = {
+        "input.select", "download.download", "download.local_install",
+        "download.refresh", "download.sort_label", "input.back"
+    };
+    const int frames = 1000;
+    volatile size_t sink = 0;
+    
+    // 只查找, 不拼接
+    auto t1 = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (const LangKey& key : keys) {
+            sink = sink + _(key).size();
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    
+    // 与 Draw 中相同的写法: 查找后拼接成提示字符串
+    for (int frame = 0; frame < frames; frame++) {
+        std::string leftHint = std::string("\ue07d ") + _(keys[0]);
+        std::string middleHint = std::string("\ue000 ") + _(keys[1]) + " | \ue002 " + _(keys[2]) + " | \ue003 " + _(keys[3]);
+        middleHint += std::string(" | \ue083/\ue084 ") + _(keys[4]);
+        std::string rightHint = std::string("\ue001 ") + _(keys[5]);
+        sink = sink + leftHint.size() + middleHint.size() + rightHint.size();
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    
+    FileLogger::GetInstance().LogInfo("[LangBench] %d frames x %zu keys: id lookup %lldus, lookup+concat %lldus",
+        frames, sizeof(keys) / sizeof(keys[0]),
+        std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count(),
+        std::chrono::duration_cast<std::chrono::microseconds>(t3 - t2).count());
 }
 
 void LanguageManager::SetCurrentLanguage(const std::string& languageCode) {
@@ -1,14 +1,76 @@
 #pragma once
 #include <string>
-#include <map>
+#include <string_view>
 #include <vector>
+#include <cstdint>
+#include "LangPack.hpp"
+
+// 语言键: 字符串字面量在编译期算出 ID, 运行时只做整数查找
+// 非字面量的键需要显式构造: _(LangKey(keyPtr))
+struct LangKey {
+    uint32_t id;
+    const char* name;  // 键名, 找不到翻译时原样显示
+    
+    template <size_t N>
+    consteval LangKey(const char (&key)[N]) : id(LangHash(std::string_view(key, N - 1))), name(key) {}
+    explicit LangKey(const char* key) : id(LangHash(key)), name(key) {}
+};
+
+// 翻译文本: 指向嵌入语言包的视图 (以 '\0' 结尾), 查找时不分配内存
+class LangText {
+public:
+    constexpr LangText(const char* text, size_t length) : mText(text, length) {}
+    explicit LangText(const char* text) : mText(text) {}
+    
+    const char* c_str() const { return mText.data(); }
+    const char* data() const { return mText.data(); }
+    size_t size() const { return mText.size(); }
+    size_t length() const { return mText.size(); }
+    bool empty() const { return mText.empty(); }
+    
+    operator std::string_view() const { return mText; }
+    operator std::string() const { return std::string(mText); }
+
+private:
+    std::string_view mText;
+};
+
+inline std::string operator+(const std::string& lhs, LangText rhs) {
+    std::string result;
+    result.reserve(lhs.size() + rhs.size());
+    result.append(lhs).append(rhs.data(), rhs.size());
+    return result;
+}
+
+inline std::string operator+(std::string&& lhs, LangText rhs) {
+    lhs.append(rhs.data(), rhs.size());
+    return std::move(lhs);
+}
+
+inline std::string operator+(LangText lhs, const std::string& rhs) {
+    std::string result;
+    result.reserve(lhs.size() + rhs.size());
+    result.append(lhs.data(), lhs.size()).append(rhs);
+    return result;
+}
+
+inline std::string operator+(const char* lhs, LangText rhs) {
+    return std::string(lhs) + rhs;
+}
+
+inline std::string operator+(LangText lhs, const char* rhs) {
+    return std::string(lhs) + rhs;
+}
 
 class LanguageManager {
 public:
     struct LanguageInfo {
         std::string code;
         std::string name;
-        std::string filename;
+        const uint8_t* pack;  // 嵌入的语言包 (data/<code>.json 编译生成)
+        size_t packSize;
+        const uint8_t* atlas; // 嵌入的字形图集 (由语言包烘焙)
+        size_t atlasSize;
     };
 
     static LanguageManager& getInstance();
@@ -16,11 +78,11 @@ public:
     // 初始化语言系统
     bool Initialize();
     
-    // 加载指定语言
+    // 加载指定语言 (切换到嵌入的语言包, 不解析)
     bool LoadLanguage(const std::string& languageCode);
     
-    // 获取文本
-    std::string GetText(const std::string& key) const;
+    // 获取文本 (O(1), 不分配内存), 找不到时返回键名
+    LangText GetText(LangKey key) const;
     
     // 获取当前语言代码
     const std::string& GetCurrentLanguage() const { return mCurrentLanguage; }
@@ -40,14 +102,19 @@ private:
     LanguageManager(const LanguageManager&) = delete;
     LanguageManager& operator=(const LanguageManager&) = delete;
     
-    // 解析嵌套的JSON键（如 "menu.download_themes"）
-    std::string GetNestedValue(const std::string& key) const;
-    
     // 加载设置
     void LoadSettings();
     
+    // 详细日志模式下测量每帧提示文本的查找与拼接耗时
+    void RunLookupBenchmark() const;
+    
     std::string mCurrentLanguage = "zh-cn";
-    std::map<std::string, std::string> mTexts;
+    
+    // 当前语言包: 查找表按键 ID 开放寻址, 文本指向嵌入数据
+    const LangPackEntry* mTextTable = nullptr;
+    const char* mTextBlob = nullptr;
+    uint32_t mTextMask = 0;
+    size_t mTextCount = 0;
     std::vector<LanguageInfo> mAvailableLanguages;
     
     static LanguageManager* mInstance;
@@ -0,0 +1,105 @@
+#include "NineSliceCache.hpp"
+#include "FileLogger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+bool NineSliceCache::Init(SDL_Renderer* renderer) {
+    mTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, ATLAS_SIZE, ATLAS_SIZE);
+    if (!mTexture) {
+        FileLogger::GetInstance().LogError("[NineSlice] Failed to create atlas texture");
+        return false;
+    }
+    
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+    // 四角按原尺寸绘制, 拉伸方向上内容一致, 最近邻采样不会串到相邻条目
+    SDL_SetTextureScaleMode(mTexture, SDL_ScaleModeNearest);
+    
+    std::vector<Uint32> solid(SOLID_SIZE * SOLID_SIZE, 0xFFFFFFFFu);
+    SDL_Rect solidRect = {0, 0, SOLID_SIZE, SOLID_SIZE};
+    SDL_UpdateTexture(mTexture, &solidRect, solid.data(), SOLID_SIZE * sizeof(Uint32));
+    
+    Reset();
+    return true;
+}
+
+void NineSliceCache::Shutdown() {
+    if (mTexture) {
+        SDL_DestroyTexture(mTexture);
+        mTexture = nullptr;
+    }
+    mSlices.clear();
+}
+
+SDL_FPoint NineSliceCache::GetSolidUV() const {
+    // 白色块中心, 无论采样方式都不会取到块外像素
+    const float center = SOLID_SIZE / 2.0f / ATLAS_SIZE;
+    return SDL_FPoint{center, center};
+}
+
+const NineSliceCache::Slice* NineSliceCache::Find(int radius) const {
+    auto it = mSlices.find(radius);
+    return it != mSlices.end() ? &it->second : nullptr;
+}
+
+const NineSliceCache::Slice* NineSliceCache::Add(int radius) {
+    if (!mTexture || radius <= 0 || radius > MAX_RADIUS) {
+        return nullptr;
+    }
+    
+    const int size = radius * 2 + CENTER_SIZE;
+    SDL_Rect rect;
+    if (!Allocate(size, rect)) {
+        // 图集已满: 清空后重新打包, 仍在使用的半径会在之后的绘制中重新加入
+        FileLogger::GetInstance().LogInfo("[NineSlice] Atlas full (%zu radii), resetting", mSlices.size());
+        Reset();
+        if (!Allocate(size, rect)) {
+            return nullptr;
+        }
+    }
+    
+    // 到圆角矩形边界的距离求覆盖率, 边缘 1 像素抗锯齿
+    std::vector<Uint32> pixels(size * size);
+    for (int py = 0; py < size; py++) {
+        for (int px = 0; px < size; px++) {
+            float x = px + 0.5f;
+            float y = py + 0.5f;
+            float cx = std::clamp(x, (float)radius, (float)(size - radius));
+            float cy = std::clamp(y, (float)radius, (float)(size - radius));
+            float distance = std::sqrt((x - cx) * (x - cx) + (y - cy) * (y - cy)) - radius;
+            float coverage = std::clamp(0.5f - distance, 0.0f, 1.0f);
+            pixels[py * size + px] = 0xFFFFFF00u | (Uint32)(coverage * 255.0f + 0.5f);
+        }
+    }
+    SDL_UpdateTexture(mTexture, &rect, pixels.data(), size * sizeof(Uint32));
+    
+    Slice& slice = mSlices[radius];
+    slice.rect = rect;
+    slice.radius = radius;
+    return &slice;
+}
+
+void NineSliceCache::Reset() {
+    mSlices.clear();
+    // 第一行从白色块右侧开始
+    mCursorX = SOLID_SIZE + PADDING;
+    mCursorY = 0;
+    mRowHeight = SOLID_SIZE;
+}
+
+bool NineSliceCache::Allocate(int size, SDL_Rect& rect) {
+    if (mCursorX + size > ATLAS_SIZE) {
+        mCursorX = 0;
+        mCursorY += mRowHeight + PADDING;
+        mRowHeight = 0;
+    }
+    if (mCursorY + size > ATLAS_SIZE) {
+        return false;
+    }
+    
+    rect = {mCursorX, mCursorY, size, size};
+    mCursorX += size + PADDING;
+    mRowHeight = std::max(mRowHeight, size);
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SDL.h>
+#include <map>
+
+// 圆角矩形九宫格缓存
+// - 每个圆角半径只光栅化一次 (带抗锯齿的白色覆盖率), 放在一张共享图集纹理中
+// - 任意大小的圆角矩形由 9 块拼成 (四角原样, 四边和中间拉伸), 开销与半径无关
+// - 颜色由顶点颜色调制, 调色板变化不需要重新光栅化; 图集放满时整体清空重建
+// - 图集左上角保留一块白色像素, 纯色图元从这里取样, 以便和九宫格在同一批次中提交 (见 GeometryBatch)
+class NineSliceCache {
+public:
+    struct Slice {
+        SDL_Rect rect;  // 在图集中的位置, 宽高均为 2 * radius + CENTER_SIZE
+        int radius;
+    };
+    
+    static constexpr int MAX_RADIUS = 96;  // 更大的半径直接用多边形绘制
+    static constexpr int CENTER_SIZE = 2;  // 中间可拉伸部分
+    
+    bool Init(SDL_Renderer* renderer);
+    void Shutdown();
+    
+    SDL_Texture* GetTexture() const { return mTexture; }
+    int GetTextureSize() const { return ATLAS_SIZE; }
+    
+    // 白色像素的纹理坐标
+    SDL_FPoint GetSolidUV() const;
+    
+    // 已缓存的九宫格, 没有时返回 nullptr
+    const Slice* Find(int radius) const;
+    
+    // 光栅化并加入图集; 图集已满时会先清空, 调用前必须提交所有引用图集的顶点
+    const Slice* Add(int radius);
+
+private:
+    static constexpr int ATLAS_SIZE = 512;
+    static constexpr int SOLID_SIZE = 4;
+    static constexpr int PADDING = 1;
+    
+    SDL_Texture* mTexture = nullptr;
+    std::map<int, Slice> mSlices;
+    
+    // 逐行 (shelf) 打包光标
+    int mCursorX = 0;
+    int mCursorY = 0;
+    int mRowHeight = 0;
+    
+    void Reset();
+    bool Allocate(int size, SDL_Rect& rect);
+};
@@ -0,0 +1,127 @@
+#include "ProgressiveWebP.hpp"
+#include "ImageDecodePool.hpp"
+#include "FileLogger.hpp"
+#include <cstring>
+#include <algorithm>
+
+// libwebp 解码器
+#include "src/webp/decode.h"
+
+ProgressiveWebP::ProgressiveWebP(int targetWidth, int targetHeight)
+    : mTargetWidth(targetWidth), mTargetHeight(targetHeight), mConfig(new WebPDecoderConfig()) {
+}
+
+ProgressiveWebP::~ProgressiveWebP() {
+    if (mDecoder) {
+        WebPIDelete(mDecoder);
+        WebPFreeDecBuffer(&mConfig->output);
+    }
+    if (mTexture) {
+        SDL_DestroyTexture(mTexture);
+    }
+}
+
+bool ProgressiveWebP::Start(SDL_Renderer* renderer, const uint8_t* data, size_t size) {
+    WebPDecoderConfig& config = *mConfig;
+    if (!WebPInitDecoderConfig(&config)) {
+        return false;
+    }
+    
+    VP8StatusCode status = WebPGetFeatures(data, size, &config.input);
+    if (status == VP8_STATUS_NOT_ENOUGH_DATA) {
+        // 头部还没收全
+        return true;
+    }
+    if (status != VP8_STATUS_OK) {
+        return false;
+    }
+    
+    int width, height;
+    if (ImageDecodePool::FitSize(config.input.width, config.input.height, mTargetWidth, mTargetHeight, width, height)) {
+        config.options.use_scaling = 1;
+        config.options.scaled_width = width;
+        config.options.scaled_height = height;
+    }
+    config.output.colorspace = MODE_RGBA;
+    
+    mTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!mTexture) {
+        return false;
+    }
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+    
+    // 未解码的部分保持透明
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(mTexture, nullptr, &pixels, &pitch) == 0) {
+        memset(pixels, 0, (size_t)pitch * height);
+        SDL_UnlockTexture(mTexture);
+    }
+    
+    mDecoder = WebPIDecode(nullptr, 0, &config);
+    return mDecoder != nullptr;
+}
+
+bool ProgressiveWebP::Update(SDL_Renderer* renderer, const uint8_t* data, size_t size) {
+    if (mFailed) {
+        return false;
+    }
+    if (mComplete) {
+        return true;
+    }
+    
+    size = std::min(size, mFedBytes + MAX_FEED_BYTES);
+    if (size <= mFedBytes) {
+        return true;
+    }
+    
+    if (!mDecoder) {
+        if (!Start(renderer, data, size)) {
+            FileLogger::GetInstance().LogWarning("[ProgressiveWebP] Not a WebP stream, waiting for full download");
+            mFailed = true;
+            return false;
+        }
+        if (!mDecoder) {
+            return true;
+        }
+    }
+    
+    // 数据从头开始且由调用方保存, 不复制到解码器内部
+    VP8StatusCode status = WebPIUpdate(mDecoder, data, size);
+    mFedBytes = size;
+    if (status == VP8_STATUS_OK) {
+        mComplete = true;
+    } else if (status != VP8_STATUS_SUSPENDED) {
+        FileLogger::GetInstance().LogError("[ProgressiveWebP] WebPIUpdate failed: %d", status);
+        mFailed = true;
+        return false;
+    }
+    
+    UploadRows(mComplete);
+    return true;
+}
+
+void ProgressiveWebP::UploadRows(bool force) {
+    int lastRow = 0, width = 0, height = 0, stride = 0;
+    const uint8_t* rgba = WebPIDecGetRGB(mDecoder, &lastRow, &width, &height, &stride);
+    if (!rgba || lastRow <= mUploadedRows) {
+        return;
+    }
+    if (!force && lastRow - mUploadedRows < UPLOAD_ROWS) {
+        return;
+    }
+    
+    SDL_Rect rows = {0, mUploadedRows, width, lastRow - mUploadedRows};
+    SDL_UpdateTexture(mTexture, &rows, rgba + (size_t)mUploadedRows * stride, stride);
+    mUploadedRows = lastRow;
+}
+
+SDL_Texture* ProgressiveWebP::ReleaseTexture() {
+    if (!mComplete) {
+        return nullptr;
+    }
+    SDL_Texture* texture = mTexture;
+    mTexture = nullptr;
+    mUploadedRows = 0;
+    return texture;
+}
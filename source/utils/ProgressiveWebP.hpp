@@ -0,0 +1,53 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+struct WebPIDecoder;
+struct WebPDecoderConfig;
+
+// WebP 增量解码: 边下载边解码, 已解码的行分批上传到流式纹理, 预览图随下载逐步显示
+// 由 ImageLoader 在主线程使用
+class ProgressiveWebP {
+public:
+    ProgressiveWebP(int targetWidth, int targetHeight);
+    ~ProgressiveWebP();
+    
+    ProgressiveWebP(const ProgressiveWebP&) = delete;
+    ProgressiveWebP& operator=(const ProgressiveWebP&) = delete;
+    
+    // data 为从文件开头到目前为止收到的全部数据 (缓冲区可以在两次调用之间重新分配)
+    // 每次最多解码 MAX_FEED_BYTES 新数据, 其余留到下次调用, 避免一次收到大量数据时整张图在一帧内解码
+    // 返回 false 表示无法增量解码 (不是 WebP 或数据出错), 之后应改用完整解码
+    bool Update(SDL_Renderer* renderer, const uint8_t* data, size_t size);
+    
+    bool IsComplete() const { return mComplete; }
+    
+    // 已收到但还没送入解码器的数据
+    bool HasPending(size_t size) const { return !mComplete && !mFailed && size > mFedBytes; }
+    
+    // 已经有内容可显示时返回纹理, 归本对象所有
+    SDL_Texture* GetTexture() const { return mUploadedRows > 0 ? mTexture : nullptr; }
+    
+    // 解码完成后取走纹理, 之后由调用方负责释放
+    SDL_Texture* ReleaseTexture();
+
+private:
+    static constexpr int UPLOAD_ROWS = 32;  // 新解码的行数达到该值才上传
+    static constexpr size_t MAX_FEED_BYTES = 32 * 1024;  // 每次调用最多送入的新数据, 约为 720p 预览图的四分之一
+    
+    int mTargetWidth;
+    int mTargetHeight;
+    std::unique_ptr<WebPDecoderConfig> mConfig;  // 解码器保存了其中 options / output 的指针, 需与解码器同生命周期
+    WebPIDecoder* mDecoder = nullptr;
+    SDL_Texture* mTexture = nullptr;
+    int mUploadedRows = 0;
+    size_t mFedBytes = 0;
+    bool mComplete = false;
+    bool mFailed = false;
+    
+    bool Start(SDL_Renderer* renderer, const uint8_t* data, size_t size);
+    void UploadRows(bool force);
+};
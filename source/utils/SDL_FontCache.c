@@ -812,6 +812,10 @@ static Uint8 FC_GrowGlyphCache(FC_Font *font) {
     SDL_Texture *new_level = SDL_CreateTexture(
             font->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
             font->height * 12, font->height * 12);
+    if (new_level != NULL)
+        SDL_SetTextureScaleMode(new_level, FC_GetFilterMode(font) == FC_FILTER_LINEAR
+                                                   ? SDL_ScaleModeLinear
+                                                   : SDL_ScaleModeNearest);
 #endif
     if (new_level == NULL ||
         !FC_SetGlyphCacheLevel(font, font->glyph_cache_count, new_level)) {
@@ -1493,56 +1497,83 @@ void FC_GetCodepoints(FC_Font *font, Uint32 *result) {
     }
 }
 
+// Packs an already rendered glyph surface into the cache
+static FC_GlyphData *FC_InsertGlyph(FC_Font *font, Uint32 codepoint, SDL_Surface *surf) {
+    int w, h;
+    FC_GlyphData *e;
+    FC_Image *cache_image;
+
+    cache_image = FC_GetGlyphCacheLevel(font, font->last_glyph.cache_level);
+    if (cache_image == NULL) {
+        FC_Log("SDL_FontCache: Failed to load cache image, so cannot add new "
+               "glyphs!\n");
+        return NULL;
+    }
+
+#ifdef FC_USE_SDL_GPU
+    w = cache_image->w;
+    h = cache_image->h;
+#else
+    SDL_QueryTexture(cache_image, NULL, NULL, &w, &h);
+#endif
+
+    e = FC_PackGlyphData(font, codepoint, surf->w, w, h);
+    if (e == NULL) {
+        // Grow the cache
+        FC_GrowGlyphCache(font);
+
+        // Try packing again
+        e = FC_PackGlyphData(font, codepoint, surf->w, w, h);
+        if (e == NULL)
+            return NULL;
+    }
+
+    // Render onto the cache texture
+    FC_AddGlyphToCache(font, surf);
+
+    return e;
+}
+
+Uint8 FC_HasGlyph(FC_Font *font, Uint32 codepoint) {
+    if (font == NULL)
+        return 0;
+
+    return FC_MapFind(font->glyphs, codepoint) != NULL;
+}
+
+Uint8 FC_CacheGlyphSurface(FC_Font *font, Uint32 codepoint, SDL_Surface *surf) {
+    if (font == NULL || surf == NULL)
+        return 0;
+
+    if (FC_MapFind(font->glyphs, codepoint) != NULL)
+        return 1;
+
+    return FC_InsertGlyph(font, codepoint, surf) != NULL;
+}
+
 Uint8 FC_GetGlyphData(FC_Font *font, FC_GlyphData *result, Uint32 codepoint) {
     FC_GlyphData *e = FC_MapFind(font->glyphs, codepoint);
     if (e == NULL) {
         char buff[5];
-        int w, h;
         SDL_Color white = {255, 255, 255, 255};
         SDL_Surface *surf;
-        FC_Image *cache_image;
 
         if (font->ttf_source == NULL)
             return 0;
 
         FC_GetUTF8FromCodepoint(buff, codepoint);
 
-        cache_image = FC_GetGlyphCacheLevel(font, font->last_glyph.cache_level);
-        if (cache_image == NULL) {
-            FC_Log("SDL_FontCache: Failed to load cache image, so cannot add new "
-                   "glyphs!\n");
-            return 0;
-        }
-
-#ifdef FC_USE_SDL_GPU
-        w = cache_image->w;
-        h = cache_image->h;
-#else
-        SDL_QueryTexture(cache_image, NULL, NULL, &w, &h);
-#endif
-
         surf = TTF_RenderUTF8_Blended(font->ttf_source, buff, white);
         if (surf == NULL) {
             return 0;
         }
 
-        e = FC_PackGlyphData(font, codepoint, surf->w, w, h);
-        if (e == NULL) {
-            // Grow the cache
-            FC_GrowGlyphCache(font);
-
-            // Try packing again
-            e = FC_PackGlyphData(font, codepoint, surf->w, w, h);
-            if (e == NULL) {
-                SDL_FreeSurface(surf);
-                return 0;
-            }
-        }
-
-        // Render onto the cache texture
-        FC_AddGlyphToCache(font, surf);
+        e = FC_InsertGlyph(font, codepoint, surf);
 
         SDL_FreeSurface(surf);
+
+        if (e == NULL)
+            return 0;
     }
 
     if (result != NULL && e != NULL)
@@ -2721,6 +2752,19 @@ void FC_SetFilterMode(FC_Font *font, FC_FilterEnum filter) {
                 GPU_SetImageFilter(font->glyph_cache[i], gpu_filter);
             }
         }
+#else
+        // Update each texture to use this filter mode
+        {
+            int i;
+            SDL_ScaleMode scale_mode = SDL_ScaleModeNearest;
+            if (FC_GetFilterMode(font) == FC_FILTER_LINEAR)
+                scale_mode = SDL_ScaleModeLinear;
+
+            for (i = 0; i < font->glyph_cache_count; ++i) {
+                if (font->glyph_cache[i] != NULL)
+                    SDL_SetTextureScaleMode(font->glyph_cache[i], scale_mode);
+            }
+        }
 #endif
     }
 }
@@ -264,6 +264,15 @@ void FC_GetCodepoints(FC_Font *font, Uint32 *result);
  * codepoint was not found in the cache. */
 Uint8 FC_GetGlyphData(FC_Font *font, FC_GlyphData *result, Uint32 codepoint);
 
+/*! Returns 1 if the codepoint is already in the glyph cache, without loading
+ * it. */
+Uint8 FC_HasGlyph(FC_Font *font, Uint32 codepoint);
+
+/*! Adds a glyph rendered elsewhere (e.g. TTF_RenderUTF8_Blended in white on
+ * another thread) to the glyph cache.  Does nothing if the codepoint is
+ * already cached.  The surface is not freed.  Returns 0 on failure. */
+Uint8 FC_CacheGlyphSurface(FC_Font *font, Uint32 codepoint, SDL_Surface *surf);
+
 /*! Sets the glyph data for the given codepoint.  Duplicates are not checked.
  * Returns a pointer to the stored data. */
 FC_GlyphData *FC_SetGlyphData(FC_Font *font, Uint32 codepoint,
@@ -0,0 +1,242 @@
+#include "TextRenderCache.hpp"
+#include "FileLogger.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+uint64_t TextRenderCache::HashText(std::string_view text, uint64_t seed) {
+    // FNV-1a 64, 先混入字体/对齐等参数
+    uint64_t hash = 14695981039346656037ULL ^ seed;
+    hash *= 1099511628211ULL;
+    for (char c : text) {
+        hash ^= (uint8_t)c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void TextRenderCache::Draw(SDL_Renderer* renderer, FC_Font* font, float x, float y, const FC_Effect& effect, std::string_view text) {
+    if (!font || !renderer || text.empty()) {
+        return;
+    }
+    
+    const Run& run = GetRun(font, effect, text);
+    
+    // FC_DrawEffect 同样是在绘制前给字形缓存纹理设置颜色
+    for (int level : run.levels) {
+        SDL_Texture* texture = FC_GetGlyphCacheLevel(font, level);
+        if (texture) {
+            SDL_SetTextureColorMod(texture, effect.color.r, effect.color.g, effect.color.b);
+            SDL_SetTextureAlphaMod(texture, effect.color.a);
+        }
+    }
+    
+    for (const Quad& quad : run.quads) {
+        SDL_Texture* texture = FC_GetGlyphCacheLevel(font, quad.level);
+        if (!texture) {
+            continue;
+        }
+        SDL_Rect dst = {(int)(x + quad.dx), (int)(y + quad.dy), quad.w, quad.h};
+        SDL_RenderCopy(renderer, texture, &quad.src, &dst);
+    }
+}
+
+int TextRenderCache::GetWidth(FC_Font* font, std::string_view text) {
+    if (!font) {
+        return 0;
+    }
+    
+    Measure& measure = GetMeasure(font, text);
+    if (measure.width < 0) {
+        measure.width = FC_GetWidth(font, "%s", measure.text.c_str());
+    }
+    return measure.width;
+}
+
+int TextRenderCache::GetHeight(FC_Font* font, std::string_view text) {
+    if (!font) {
+        return 0;
+    }
+    
+    Measure& measure = GetMeasure(font, text);
+    if (measure.height < 0) {
+        measure.height = FC_GetHeight(font, "%s", measure.text.c_str());
+    }
+    return measure.height;
+}
+
+void TextRenderCache::Clear() {
+    mRuns.clear();
+    mRunIndex.clear();
+    mRunBytes = 0;
+    mMeasures.clear();
+}
+
+void TextRenderCache::OnFrame() {
+    if (++mFrames < STATS_INTERVAL_FRAMES) {
+        return;
+    }
+    
+    if (FileLogger::GetInstance().IsVerbose()) {
+        FileLogger::GetInstance().LogInfo("[TextCache] %d frames: %u hits, %u misses, %u evictions, %zu runs (%zu KB), %zu measures",
+            mFrames, mHits, mMisses, mEvictions, mRuns.size(), mRunBytes / 1024, mMeasures.size());
+    }
+    
+    mFrames = 0;
+    mHits = 0;
+    mMisses = 0;
+    mEvictions = 0;
+}
+
+TextRenderCache::Measure& TextRenderCache::GetMeasure(FC_Font* font, std::string_view text) {
+    const uint64_t key = HashText(text, (uint64_t)(uintptr_t)font);
+    
+    auto it = mMeasures.find(key);
+    if (it != mMeasures.end() && it->second.font == font && it->second.text == text) {
+        return it->second;
+    }
+    
+    // 测量结果很小, 超过上限直接整体清空
+    if (it == mMeasures.end() && mMeasures.size() >= MAX_MEASURES) {
+        mMeasures.clear();
+    }
+    
+    Measure& measure = mMeasures[key];
+    measure.font = font;
+    measure.text.assign(text.data(), text.size());
+    measure.width = -1;
+    measure.height = -1;
+    return measure;
+}
+
+TextRenderCache::Run& TextRenderCache::GetRun(FC_Font* font, const FC_Effect& effect, std::string_view text) {
+    uint32_t scaleBits[2];
+    memcpy(&scaleBits[0], &effect.scale.x, sizeof(float));
+    memcpy(&scaleBits[1], &effect.scale.y, sizeof(float));
+    
+    uint64_t seed = (uint64_t)(uintptr_t)font;
+    seed = seed * 31 + effect.alignment;
+    seed = seed * 31 + scaleBits[0];
+    seed = seed * 31 + scaleBits[1];
+    const uint64_t key = HashText(text, seed);
+    
+    auto it = mRunIndex.find(key);
+    if (it != mRunIndex.end()) {
+        Run& run = *it->second;
+        if (run.font == font && run.alignment == effect.alignment &&
+            run.scaleX == effect.scale.x && run.scaleY == effect.scale.y && run.text == text) {
+            mRuns.splice(mRuns.begin(), mRuns, it->second);
+            mHits++;
+            return run;
+        }
+        
+        // 哈希冲突, 丢弃旧条目
+        mRunBytes -= run.bytes;
+        mRuns.erase(it->second);
+        mRunIndex.erase(it);
+    }
+    
+    mMisses++;
+    
+    mRuns.emplace_front();
+    Run& run = mRuns.front();
+    run.key = key;
+    run.font = font;
+    run.alignment = effect.alignment;
+    run.scaleX = effect.scale.x;
+    run.scaleY = effect.scale.y;
+    run.text.assign(text.data(), text.size());
+    BuildRun(run);
+    run.bytes = sizeof(Run) + run.text.capacity() + run.quads.capacity() * sizeof(Quad) + run.levels.capacity() * sizeof(int);
+    
+    mRunIndex[key] = mRuns.begin();
+    mRunBytes += run.bytes;
+    EvictToBudget();
+    
+    return run;
+}
+
+void TextRenderCache::BuildRun(Run& run) {
+    FC_Font* font = run.font;
+    
+    if (run.alignment == FC_ALIGN_LEFT) {
+        LayoutLine(run, font, run.text.c_str(), 0.0f, 0.0f);
+    } else if (run.alignment == FC_ALIGN_CENTER || run.alignment == FC_ALIGN_RIGHT) {
+        // 与 FC_RenderCenter / FC_RenderRight 相同: 逐行按行宽偏移, 行距只用字体高度
+        const float lineHeight = run.scaleY * FC_GetLineHeight(font);
+        float y = 0.0f;
+        size_t start = 0;
+        while (true) {
+            size_t end = run.text.find('\n', start);
+            std::string line = run.text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            
+            float width = run.scaleX * FC_GetWidth(font, "%s", line.c_str());
+            float x = (run.alignment == FC_ALIGN_CENTER) ? -width / 2.0f : -width;
+            LayoutLine(run, font, line.c_str(), x, y);
+            
+            if (end == std::string::npos) {
+                break;
+            }
+            start = end + 1;
+            y += lineHeight;
+        }
+    }
+    
+    run.quads.shrink_to_fit();
+}
+
+void TextRenderCache::LayoutLine(Run& run, FC_Font* font, const char* text, float x, float y) {
+    // 与 FC_RenderLeft 相同的排版, 只记录结果不绘制
+    const float destH = FC_GetLineHeight(font) * run.scaleY;
+    const float destLineSpacing = FC_GetLineSpacing(font) * run.scaleY;
+    const float destLetterSpacing = FC_GetSpacing(font) * run.scaleX;
+    
+    float destX = x;
+    float destY = y;
+    int newlineX = x;
+    
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '\n') {
+            destX = newlineX;
+            destY += destH + destLineSpacing;
+            continue;
+        }
+        
+        FC_GlyphData glyph;
+        Uint32 codepoint = FC_GetCodepointFromUTF8(&c, 1);
+        if (!FC_GetGlyphData(font, &glyph, codepoint)) {
+            codepoint = ' ';
+            if (!FC_GetGlyphData(font, &glyph, codepoint)) {
+                continue;
+            }
+        }
+        
+        if (codepoint != ' ') {
+            Quad quad;
+            quad.level = glyph.cache_level;
+            quad.src = glyph.rect;
+            quad.dx = destX;
+            quad.dy = destY;
+            quad.w = (int)(run.scaleX * glyph.rect.w);
+            quad.h = (int)(run.scaleY * glyph.rect.h);
+            run.quads.push_back(quad);
+            
+            if (std::find(run.levels.begin(), run.levels.end(), glyph.cache_level) == run.levels.end()) {
+                run.levels.push_back(glyph.cache_level);
+            }
+        }
+        
+        destX += glyph.rect.w * run.scaleX + destLetterSpacing;
+    }
+}
+
+void TextRenderCache::EvictToBudget() {
+    // 至少保留刚加入的一条
+    while (mRunBytes > RUN_BUDGET_BYTES && mRuns.size() > 1) {
+        const Run& oldest = mRuns.back();
+        mRunBytes -= oldest.bytes;
+        mRunIndex.erase(oldest.key);
+        mRuns.pop_back();
+        mEvictions++;
+    }
+}
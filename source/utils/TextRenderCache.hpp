@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SDL.h>
+#include "SDL_FontCache.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+
+// Gfx::Print / GetTextWidth 的文本缓存
+// - 字形排版结果 (每个字形在 FC 字形缓存纹理中的位置和相对坐标) 按 (字体, 对齐, 缩放, 文本哈希) 缓存,
+//   命中时直接提交 SDL_RenderCopy, 不再经过 vsnprintf / UTF-8 解码 / 字形查找
+// - 颜色通过纹理颜色调制实现 (与 FC_DrawEffect 相同), 同一段文本不同颜色共用一条缓存
+// - 按字节预算做 LRU 淘汰; 宽高测量另有独立的备忘表
+class TextRenderCache {
+public:
+    // 与 FC_DrawEffect(font, renderer, x, y, effect, "%s", text) 效果一致
+    void Draw(SDL_Renderer* renderer, FC_Font* font, float x, float y, const FC_Effect& effect, std::string_view text);
+    
+    // 与 FC_GetWidth / FC_GetHeight 结果一致
+    int GetWidth(FC_Font* font, std::string_view text);
+    int GetHeight(FC_Font* font, std::string_view text);
+    
+    // 字体释放前必须清空
+    void Clear();
+    
+    // 每帧调用一次, 详细日志模式下定期输出命中率
+    void OnFrame();
+
+private:
+    static constexpr size_t RUN_BUDGET_BYTES = 512 * 1024;
+    static constexpr size_t MAX_MEASURES = 2048;
+    static constexpr int STATS_INTERVAL_FRAMES = 600;
+    
+    struct Quad {
+        int level;       // FC 字形缓存层
+        SDL_Rect src;
+        float dx, dy;    // 相对绘制原点的位置 (与 FC 相同, 绘制时才取整)
+        int w, h;
+    };
+    
+    struct Run {
+        uint64_t key;
+        FC_Font* font;
+        int alignment;
+        float scaleX, scaleY;
+        std::string text;
+        std::vector<Quad> quads;
+        std::vector<int> levels;  // 用到的字形缓存层, 绘制前设置颜色
+        size_t bytes;
+    };
+    
+    struct Measure {
+        FC_Font* font;
+        std::string text;
+        int width = -1;
+        int height = -1;
+    };
+    
+    std::list<Run> mRuns;  // 头部为最近使用
+    std::unordered_map<uint64_t, std::list<Run>::iterator> mRunIndex;
+    size_t mRunBytes = 0;
+    
+    std::unordered_map<uint64_t, Measure> mMeasures;
+    
+    uint32_t mHits = 0;
+    uint32_t mMisses = 0;
+    uint32_t mEvictions = 0;
+    int mFrames = 0;
+    
+    static uint64_t HashText(std::string_view text, uint64_t seed);
+    Measure& GetMeasure(FC_Font* font, std::string_view text);
+    Run& GetRun(FC_Font* font, const FC_Effect& effect, std::string_view text);
+    void BuildRun(Run& run);
+    void LayoutLine(Run& run, FC_Font* font, const char* text, float x, float y);
+    void EvictToBudget();
+};
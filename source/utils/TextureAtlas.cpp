@@ -0,0 +1,152 @@
+#include "TextureAtlas.hpp"
+#include "FileLogger.hpp"
+#include <algorithm>
+
+TextureAtlas::~TextureAtlas() {
+    Clear();
+}
+
+SDL_Texture* TextureAtlas::GetTexture(int page) const {
+    return page >= 0 && page < (int)mPages.size() ? mPages[page].texture : nullptr;
+}
+
+Uint32 TextureAtlas::GetPageFormat(int page) const {
+    return page >= 0 && page < (int)mPages.size() ? mPages[page].format : SDL_PIXELFORMAT_UNKNOWN;
+}
+
+void TextureAtlas::Clear() {
+    for (auto& page : mPages) {
+        if (page.texture) {
+            SDL_DestroyTexture(page.texture);
+        }
+    }
+    mPages.clear();
+}
+
+bool TextureAtlas::Allocate(SDL_Renderer* renderer, int width, int height, Uint32 format, Slot& slot) {
+    if (width <= 0 || height <= 0 || !Fits(width, height)) {
+        return false;
+    }
+    
+    for (int i = 0; i < (int)mPages.size(); i++) {
+        if (mPages[i].format == format && AllocateInPage(i, width, height, slot)) {
+            return true;
+        }
+    }
+    
+    if ((int)mPages.size() < MAX_PAGES && CreatePage(renderer, format)) {
+        return AllocateInPage((int)mPages.size() - 1, width, height, slot);
+    }
+    return false;
+}
+
+bool TextureAtlas::AllocateInPage(int pageIndex, int width, int height, Slot& slot) {
+    Page& page = mPages[pageIndex];
+    const int paddedW = width + PADDING;
+    const int paddedH = height + PADDING;
+    
+    // 高度相近的行才放入, 避免矮图占用高行浪费空间
+    for (auto& shelf : page.shelves) {
+        if (shelf.height < paddedH || shelf.height > paddedH + paddedH / 4) {
+            continue;
+        }
+        
+        // 优先复用释放的区间 (最合适的一段)
+        auto best = shelf.freeSpans.end();
+        for (auto it = shelf.freeSpans.begin(); it != shelf.freeSpans.end(); ++it) {
+            if (it->width >= paddedW && (best == shelf.freeSpans.end() || it->width < best->width)) {
+                best = it;
+            }
+        }
+        if (best != shelf.freeSpans.end()) {
+            slot.page = pageIndex;
+            slot.rect = {best->x, shelf.y, width, height};
+            best->x += paddedW;
+            best->width -= paddedW;
+            if (best->width <= 0) {
+                shelf.freeSpans.erase(best);
+            }
+            return true;
+        }
+        
+        if (shelf.cursor + paddedW <= PAGE_WIDTH) {
+            slot.page = pageIndex;
+            slot.rect = {shelf.cursor, shelf.y, width, height};
+            shelf.cursor += paddedW;
+            return true;
+        }
+    }
+    
+    // 新开一行
+    if (page.nextY + paddedH <= PAGE_HEIGHT && paddedW <= PAGE_WIDTH) {
+        page.shelves.push_back({page.nextY, paddedH, paddedW, {}});
+        slot.page = pageIndex;
+        slot.rect = {0, page.nextY, width, height};
+        page.nextY += paddedH;
+        return true;
+    }
+    return false;
+}
+
+void TextureAtlas::Free(const Slot& slot) {
+    if (slot.page < 0 || slot.page >= (int)mPages.size()) {
+        return;
+    }
+    
+    Page& page = mPages[slot.page];
+    auto shelf = std::find_if(page.shelves.begin(), page.shelves.end(),
+                              [&slot](const Shelf& item) { return item.y == slot.rect.y; });
+    if (shelf == page.shelves.end()) {
+        return;
+    }
+    
+    // 放回空闲区间并与相邻区间合并
+    auto& spans = shelf->freeSpans;
+    spans.push_back({slot.rect.x, slot.rect.w + PADDING});
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.x < b.x; });
+    std::vector<Span> merged;
+    for (const auto& span : spans) {
+        if (!merged.empty() && merged.back().x + merged.back().width == span.x) {
+            merged.back().width += span.width;
+        } else {
+            merged.push_back(span);
+        }
+    }
+    
+    // 末尾的空闲区间还给未使用部分
+    if (!merged.empty() && merged.back().x + merged.back().width == shelf->cursor) {
+        shelf->cursor = merged.back().x;
+        merged.pop_back();
+    }
+    spans = std::move(merged);
+    
+    // 最下面的空行还给页面, 之后可以按其他高度重新分行
+    while (!page.shelves.empty() && page.shelves.back().cursor == 0) {
+        page.nextY = page.shelves.back().y;
+        page.shelves.pop_back();
+    }
+}
+
+bool TextureAtlas::CreatePage(SDL_Renderer* renderer, Uint32 format) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, PAGE_WIDTH, PAGE_HEIGHT);
+    if (!texture) {
+        FileLogger::GetInstance().LogError("[Atlas] Failed to create %dx%d page: %s", PAGE_WIDTH, PAGE_HEIGHT, SDL_GetError());
+        return false;
+    }
+    if (SDL_ISPIXELFORMAT_ALPHA(format)) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+    
+    // 槽位间的留空需要是透明的
+    const int stripRows = 64;
+    const int pitch = PAGE_WIDTH * SDL_BYTESPERPIXEL(format);
+    std::vector<uint8_t> zeros((size_t)pitch * stripRows, 0);
+    for (int y = 0; y < PAGE_HEIGHT; y += stripRows) {
+        SDL_Rect strip = {0, y, PAGE_WIDTH, std::min(stripRows, PAGE_HEIGHT - y)};
+        SDL_UpdateTexture(texture, &strip, zeros.data(), pitch);
+    }
+    
+    mPages.push_back({texture, format, {}, 0});
+    FileLogger::GetInstance().LogInfo("[Atlas] Created page %zu (%dx%d)", mPages.size() - 1, PAGE_WIDTH, PAGE_HEIGHT);
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// 缩略图图集
+// - 几张大纹理按行 (shelf) 装入卡片大小的缩略图, 列表绘制时多张卡片共用同一纹理
+// - 释放的槽位放回所在行的空闲区间, 之后同样高度的缩略图可以复用
+// - 纹理按像素格式分页, 需要时才创建, 最多 MAX_PAGES 页
+// 只能在主线程使用, 由 ImageLoader 持有
+class TextureAtlas {
+public:
+    struct Slot {
+        int page = -1;      // -1 表示不在图集中
+        SDL_Rect rect = {0, 0, 0, 0};
+    };
+    
+    ~TextureAtlas();
+    
+    // 分配 width x height 的槽位, 没有空间时返回 false (由调用方淘汰后重试)
+    bool Allocate(SDL_Renderer* renderer, int width, int height, Uint32 format, Slot& slot);
+    
+    // 释放槽位, 纹理内容不清除
+    void Free(const Slot& slot);
+    
+    SDL_Texture* GetTexture(int page) const;
+    Uint32 GetPageFormat(int page) const;
+    
+    // 销毁所有页
+    void Clear();
+    
+    int GetPageCount() const { return (int)mPages.size(); }
+    
+    // 超过该尺寸的图片不放入图集
+    static bool Fits(int width, int height) { return width <= MAX_SLOT_SIZE && height <= MAX_SLOT_SIZE; }
+
+private:
+    static constexpr int PAGE_WIDTH = 2048;
+    static constexpr int PAGE_HEIGHT = 1024;
+    static constexpr int MAX_PAGES = 3;
+    static constexpr int MAX_SLOT_SIZE = 512;
+    static constexpr int PADDING = 1;  // 槽位间留空, 缩放采样时不会取到相邻缩略图
+    
+    struct Span {
+        int x;
+        int width;
+    };
+    
+    struct Shelf {
+        int y;
+        int height;
+        int cursor;                   // 未使用部分的起点
+        std::vector<Span> freeSpans;  // 释放后可复用的区间
+    };
+    
+    struct Page {
+        SDL_Texture* texture;
+        Uint32 format;
+        std::vector<Shelf> shelves;
+        int nextY;
+    };
+    
+    std::vector<Page> mPages;
+    
+    bool AllocateInPage(int pageIndex, int width, int height, Slot& slot);
+    bool CreatePage(SDL_Renderer* renderer, Uint32 format);
+};
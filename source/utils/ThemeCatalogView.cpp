@@ -0,0 +1,182 @@
+#include "ThemeCatalogView.hpp"
+#include "ThemeSearchIndex.hpp"
+#include "FileLogger.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+
+void ThemeCatalogView::Rebuild(const std::vector<Theme>& themes) {
+    auto t1 = std::chrono::steady_clock::now();
+    
+    mCount = themes.size();
+    
+    // 名称排序使用折叠后的文本, 避免每次比较都转换大小写
+    std::vector<std::u32string> foldedNames;
+    foldedNames.reserve(mCount);
+    for (const auto& theme : themes) {
+        foldedNames.push_back(ThemeSearchIndex::Fold(theme.name));
+    }
+    
+    for (int order = 0; order < SORT_COUNT; order++) {
+        auto& perm = mPermutations[order];
+        perm.resize(mCount);
+        std::iota(perm.begin(), perm.end(), 0);
+        
+        // stable_sort: 相同值保持 API 顺序
+        switch (order) {
+            case SORT_DOWNLOADS:
+                std::stable_sort(perm.begin(), perm.end(), [&themes](size_t a, size_t b) {
+                    return themes[a].downloads > themes[b].downloads;
+                });
+                break;
+            case SORT_LIKES:
+                std::stable_sort(perm.begin(), perm.end(), [&themes](size_t a, size_t b) {
+                    return themes[a].likes > themes[b].likes;
+                });
+                break;
+            case SORT_UPDATED:
+                // updatedAt 是 ISO 8601 字符串, 字典序即时间顺序
+                std::stable_sort(perm.begin(), perm.end(), [&themes](size_t a, size_t b) {
+                    return themes[a].updatedAt > themes[b].updatedAt;
+                });
+                break;
+            case SORT_NAME:
+                std::stable_sort(perm.begin(), perm.end(), [&foldedNames](size_t a, size_t b) {
+                    return foldedNames[a] < foldedNames[b];
+                });
+                break;
+            default:
+                break;
+        }
+        
+        auto& ranks = mRanks[order];
+        ranks.resize(mCount);
+        for (size_t pos = 0; pos < mCount; pos++) {
+            ranks[perm[pos]] = (uint32_t)pos;
+        }
+    }
+    
+    // 标签位集
+    const size_t words = (mCount + 63) / 64;
+    mTagBits.clear();
+    for (size_t i = 0; i < mCount; i++) {
+        for (const auto& tag : themes[i].tags) {
+            auto& bits = mTagBits[ThemeSearchIndex::Fold(tag)];
+            if (bits.empty()) {
+                bits.resize(words, 0);
+            }
+            bits[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+    
+    // 主题列表变了, 重新计算当前筛选
+    std::vector<std::string> activeTags;
+    activeTags.swap(mActiveTags);
+    SetActiveTags(activeTags);
+    
+    auto t2 = std::chrono::steady_clock::now();
+    FileLogger::GetInstance().LogInfo("  [+%lldms] Catalog view rebuilt (%zu themes, %zu tags)",
+        std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(), mCount, mTagBits.size());
+}
+
+void ThemeCatalogView::SetSortOrder(SortOrder order) {
+    if (order >= SORT_COUNT || order == mSortOrder) {
+        return;
+    }
+    mSortOrder = order;
+    
+    // 没有标签筛选时直接换用预先计算的排列, 有筛选时只重排筛选结果
+    if (!mActiveTags.empty()) {
+        RebuildFiltered();
+    }
+}
+
+const char* ThemeCatalogView::GetSortLabelKey(SortOrder order) {
+    switch (order) {
+        case SORT_DOWNLOADS: return "download.sort_downloads";
+        case SORT_LIKES:     return "download.sort_likes";
+        case SORT_UPDATED:   return "download.sort_updated";
+        case SORT_NAME:      return "download.sort_name";
+        default:             return "download.sort_default";
+    }
+}
+
+bool ThemeCatalogView::SetActiveTags(const std::vector<std::string>& tags) {
+    if (tags == mActiveTags) {
+        return false;
+    }
+    
+    mActiveTags = tags;
+    mActiveMask.clear();
+    mFiltered.clear();
+    
+    if (mActiveTags.empty()) {
+        return true;
+    }
+    
+    // 位集 AND: 任何一个标签不存在则结果为空
+    const size_t words = (mCount + 63) / 64;
+    mActiveMask.assign(words, ~0ULL);
+    if (mCount % 64) {
+        mActiveMask[words - 1] = (1ULL << (mCount % 64)) - 1;
+    }
+    
+    for (const auto& tag : mActiveTags) {
+        auto it = mTagBits.find(ThemeSearchIndex::Fold(tag));
+        if (it == mTagBits.end()) {
+            std::fill(mActiveMask.begin(), mActiveMask.end(), 0);
+            break;
+        }
+        for (size_t w = 0; w < words; w++) {
+            mActiveMask[w] &= it->second[w];
+        }
+    }
+    
+    RebuildFiltered();
+    return true;
+}
+
+void ThemeCatalogView::RebuildFiltered() {
+    mFiltered.clear();
+    
+    // 只遍历位集中置位的主题, 再按当前排序的位置排列
+    for (size_t w = 0; w < mActiveMask.size(); w++) {
+        uint64_t bits = mActiveMask[w];
+        while (bits) {
+            int bit = __builtin_ctzll(bits);
+            mFiltered.push_back(w * 64 + bit);
+            bits &= bits - 1;
+        }
+    }
+    
+    SortByView(mFiltered);
+}
+
+const std::vector<size_t>& ThemeCatalogView::GetOrder() const {
+    if (!mActiveTags.empty()) {
+        return mFiltered;
+    }
+    return mPermutations[mSortOrder];
+}
+
+bool ThemeCatalogView::Matches(size_t index) const {
+    if (mActiveTags.empty()) {
+        return true;
+    }
+    if (index >= mCount) {
+        return false;
+    }
+    return (mActiveMask[index / 64] >> (index % 64)) & 1;
+}
+
+void ThemeCatalogView::SortByView(std::vector<size_t>& indices) const {
+    if (indices.empty()) {
+        return;
+    }
+    
+    const auto& ranks = mRanks[mSortOrder];
+    std::sort(indices.begin(), indices.end(), [&ranks](size_t a, size_t b) {
+        return ranks[a] < ranks[b];
+    });
+}
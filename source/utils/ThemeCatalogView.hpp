@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ThemeManager.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// 主题目录视图 (基于 ThemeManager::GetThemes())
+// - 每种排序方式预先计算好排列数组, 切换排序只是换一个数组
+// - 标签 -> 位集索引, 按标签筛选是位集 AND, 不需要重新扫描主题
+// 主题列表变化 (全量获取/增量同步/加载缓存) 后需要调用 Rebuild()
+class ThemeCatalogView {
+public:
+    enum SortOrder {
+        SORT_DEFAULT,    // API 顺序
+        SORT_DOWNLOADS,  // 下载量
+        SORT_LIKES,      // 收藏数 (saveCount)
+        SORT_UPDATED,    // 最近更新
+        SORT_NAME,       // 名称
+        SORT_COUNT
+    };
+    
+    void Rebuild(const std::vector<Theme>& themes);
+    
+    void SetSortOrder(SortOrder order);
+    SortOrder GetSortOrder() const { return mSortOrder; }
+    static const char* GetSortLabelKey(SortOrder order);  // 语言文件中的键
+    
+    // 设置需要同时包含的标签 (不区分大小写), 返回是否与之前不同
+    bool SetActiveTags(const std::vector<std::string>& tags);
+    bool HasActiveTags() const { return !mActiveTags.empty(); }
+    const std::vector<std::string>& GetActiveTags() const { return mActiveTags; }
+    
+    // 默认排序且没有标签筛选时, 视图就是原始列表
+    bool IsIdentity() const { return mSortOrder == SORT_DEFAULT && mActiveTags.empty(); }
+    
+    // 当前视图的主题下标 (已排序、已筛选)
+    const std::vector<size_t>& GetOrder() const;
+    
+    // 主题是否通过当前标签筛选
+    bool Matches(size_t index) const;
+    
+    // 按当前排序方式重排一组主题下标 (用于搜索结果)
+    void SortByView(std::vector<size_t>& indices) const;
+
+private:
+    size_t mCount = 0;
+    SortOrder mSortOrder = SORT_DEFAULT;
+    
+    std::vector<size_t> mPermutations[SORT_COUNT];  // 每种排序的主题下标
+    std::vector<uint32_t> mRanks[SORT_COUNT];       // 主题下标 -> 在该排序中的位置
+    
+    std::unordered_map<std::u32string, std::vector<uint64_t>> mTagBits;  // 折叠后的标签 -> 位集
+    std::vector<std::string> mActiveTags;
+    std::vector<uint64_t> mActiveMask;  // 所有激活标签位集的 AND
+    std::vector<size_t> mFiltered;      // 有标签筛选时的视图
+    
+    void RebuildFiltered();
+};
@@ -8,6 +8,7 @@
 #include "DownloadQueue.hpp"
 #include "logger.h"
 #include "FileLogger.hpp"
+#include "InstalledThemeIndex.hpp"
 
 #include <curl/curl.h>
 #include <nn/ac.h>
@@ -18,6 +19,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <chrono>
+#include <algorithm>
 
 // Themezer GraphQL API URL
 #define THEMEZER_GRAPHQL_URL "https://api.themezer.net/graphql"
@@ -25,6 +27,11 @@
 #define CACHE_DIR "fs:/vol/external01/UTheme/temp"
 #define CACHE_FILE "fs:/vol/external01/UTheme/temp/themes_cache.json"
 
+// 主题节点字段 (全量获取与增量同步使用同一组字段)
+#define THEMEZER_THEME_FIELDS "uuid name description downloadCount saveCount updatedAt creator { username } downloadUrl collagePreview { thumbUrl hdUrl } launcherScreenshot { thumbUrl hdUrl } waraWaraPlazaScreenshot { thumbUrl hdUrl } launcherBgUrl waraWaraPlazaBgUrl tags { name }"
+// 变化的主题超过本地数量的 1/2 时直接拉取完整列表, 避免构造过长的别名查询
+#define SYNC_FULL_FETCH_RATIO 2
+
 // CURL回调函数
 static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
     size_t realsize = size * nmemb;
@@ -53,6 +60,110 @@ static size_t WriteFileCallback(char* ptr, size_t size, size_t nmemb, void* user
     return written;  // 返回实际写入的字节数
 }
 
+// 解析 ImageSizes 对象
+static ThemeImage ParseImageSizes(const rapidjson::Value& imgObj) {
+    ThemeImage img;
+    if (imgObj.HasMember("thumbUrl") && imgObj["thumbUrl"].IsString()) {
+        img.thumbUrl = imgObj["thumbUrl"].GetString();
+    }
+    if (imgObj.HasMember("hdUrl") && imgObj["hdUrl"].IsString()) {
+        img.hdUrl = imgObj["hdUrl"].GetString();
+    }
+    return img;
+}
+
+// 解析单个 GraphQL 主题节点 (FetchThemes 和增量同步共用)
+static void ParseThemeNode(const rapidjson::Value& themeJson, Theme& theme) {
+    // 解析主题数据
+    if (themeJson.HasMember("uuid") && themeJson["uuid"].IsString()) {
+        theme.id = themeJson["uuid"].GetString();
+    }
+    
+    if (themeJson.HasMember("name") && themeJson["name"].IsString()) {
+        theme.name = themeJson["name"].GetString();
+    }
+    
+    if (themeJson.HasMember("description") && themeJson["description"].IsString()) {
+        theme.description = themeJson["description"].GetString();
+    } else {
+        theme.description = "";
+    }
+    
+    // 作者信息
+    if (themeJson.HasMember("creator") && themeJson["creator"].IsObject()) {
+        const auto& creator = themeJson["creator"];
+        if (creator.HasMember("username") && creator["username"].IsString()) {
+            theme.author = creator["username"].GetString();
+        }
+    }
+    
+    // 统计信息 (GraphQL 使用 downloadCount 和 saveCount)
+    if (themeJson.HasMember("downloadCount") && themeJson["downloadCount"].IsInt()) {
+        theme.downloads = themeJson["downloadCount"].GetInt();
+    }
+    
+    if (themeJson.HasMember("saveCount") && themeJson["saveCount"].IsInt()) {
+        theme.likes = themeJson["saveCount"].GetInt();
+    }
+    
+    // 版本 (GraphQL 没有 version 字段,使用空字符串)
+    theme.version = "1.0";
+    
+    // 更新时间
+    if (themeJson.HasMember("updatedAt") && themeJson["updatedAt"].IsString()) {
+        theme.updatedAt = themeJson["updatedAt"].GetString();
+    }
+    
+    // 解析图片 URLs
+    if (themeJson.HasMember("collagePreview") && themeJson["collagePreview"].IsObject()) {
+        theme.collagePreview = ParseImageSizes(themeJson["collagePreview"]);
+    }
+    
+    if (themeJson.HasMember("launcherScreenshot") && themeJson["launcherScreenshot"].IsObject()) {
+        theme.launcherScreenshot = ParseImageSizes(themeJson["launcherScreenshot"]);
+    }
+    
+    if (themeJson.HasMember("waraWaraPlazaScreenshot") && themeJson["waraWaraPlazaScreenshot"].IsObject()) {
+        theme.waraWaraScreenshot = ParseImageSizes(themeJson["waraWaraPlazaScreenshot"]);
+    }
+    
+    // 背景图 URLs
+    if (themeJson.HasMember("launcherBgUrl") && themeJson["launcherBgUrl"].IsString()) {
+        theme.launcherBgUrl = themeJson["launcherBgUrl"].GetString();
+    }
+    
+    if (themeJson.HasMember("waraWaraPlazaBgUrl") && themeJson["waraWaraPlazaBgUrl"].IsString()) {
+        theme.waraWaraBgUrl = themeJson["waraWaraPlazaBgUrl"].GetString();
+    }
+    
+    // 下载 URL
+    if (themeJson.HasMember("downloadUrl") && themeJson["downloadUrl"].IsString()) {
+        theme.downloadUrl = themeJson["downloadUrl"].GetString();
+        
+        // 从 downloadUrl 中提取短ID
+        // 格式: https://api.themezer.net/wiiu/themes/123/download
+        size_t themesPos = theme.downloadUrl.find("/wiiu/themes/");
+        if (themesPos != std::string::npos) {
+            size_t idStart = themesPos + 13; // 跳过 "/wiiu/themes/"
+            size_t idEnd = theme.downloadUrl.find("/", idStart);
+            if (idEnd != std::string::npos) {
+                theme.shortId = theme.downloadUrl.substr(idStart, idEnd - idStart);
+            }
+        }
+    }
+    
+    // 标签
+    if (themeJson.HasMember("tags") && themeJson["tags"].IsArray()) {
+        const auto& tags = themeJson["tags"];
+        for (rapidjson::SizeType j = 0; j < tags.Size(); j++) {
+            const auto& tagObj = tags[j];
+            if (tagObj.IsObject() && tagObj.HasMember("name") && tagObj["name"].IsString()) {
+                theme.tags.push_back(tagObj["name"].GetString());
+            }
+        }
+    }
+}
+
 ThemeManager::ThemeManager() {
     FileLogger::GetInstance().LogInfo("========== ThemeManager Constructor START ==========");
     auto constructorStart = std::chrono::steady_clock::now();
@@ -91,6 +202,13 @@ ThemeManager::~ThemeManager() {
         FileLogger::GetInstance().LogInfo("[ThemeManager] Fetch operation exists but DownloadQueue is null");
     }
     
+    // 取消未完成的增量同步
+    if (mUpdateOp && DownloadQueue::GetInstance()) {
+        FileLogger::GetInstance().LogInfo("[ThemeManager] Cancelling update check operation");
+        DownloadQueue::GetInstance()->DownloadCancel(mUpdateOp);
+        mUpdateOp = nullptr;
+    }
+    
     FileLogger::GetInstance().LogInfo("[ThemeManager] About to clean up downloader");
     
     // 清理主题下载器
@@ -208,18 +326,6 @@ bool ThemeManager::ParseThemezerResponse(const std::string& jsonData) {
         
         const auto& nodes = wiiuThemes["nodes"];
         
-        // 辅助函数: 解析 ImageSizes 对象
-        auto parseImageSizes = [](const rapidjson::Value& imgObj) -> ThemeImage {
-            ThemeImage img;
-            if (imgObj.HasMember("thumbUrl") && imgObj["thumbUrl"].IsString()) {
-                img.thumbUrl = imgObj["thumbUrl"].GetString();
-            }
-            if (imgObj.HasMember("hdUrl") && imgObj["hdUrl"].IsString()) {
-                img.hdUrl = imgObj["hdUrl"].GetString();
-            }
-            return img;
-        };
-        
         // 遍历主题数组
         for (rapidjson::SizeType i = 0; i < nodes.Size(); i++) {
             const auto& themeJson = nodes[i];
@@ -228,95 +334,7 @@ bool ThemeManager::ParseThemezerResponse(const std::string& jsonData) {
             }
             
             Theme theme;
-            
-            // 解析主题数据
-            if (themeJson.HasMember("uuid") && themeJson["uuid"].IsString()) {
-                theme.id = themeJson["uuid"].GetString();
-            }
-            
-            if (themeJson.HasMember("name") && themeJson["name"].IsString()) {
-                theme.name = themeJson["name"].GetString();
-            }
-            
-            if (themeJson.HasMember("description") && themeJson["description"].IsString()) {
-                theme.description = themeJson["description"].GetString();
-            } else {
-                theme.description = "";
-            }
-            
-            // 作者信息
-            if (themeJson.HasMember("creator") && themeJson["creator"].IsObject()) {
-                const auto& creator = themeJson["creator"];
-                if (creator.HasMember("username") && creator["username"].IsString()) {
-                    theme.author = creator["username"].GetString();
-                }
-            }
-            
-            // 统计信息 (GraphQL 使用 downloadCount 和 saveCount)
-            if (themeJson.HasMember("downloadCount") && themeJson["downloadCount"].IsInt()) {
-                theme.downloads = themeJson["downloadCount"].GetInt();
-            }
-            
-            if (themeJson.HasMember("saveCount") && themeJson["saveCount"].IsInt()) {
-                theme.likes = themeJson["saveCount"].GetInt();
-            }
-            
-            // 版本 (GraphQL 没有 version 字段,使用空字符串)
-            theme.version = "1.0";
-            
-            // 更新时间
-            if (themeJson.HasMember("updatedAt") && themeJson["updatedAt"].IsString()) {
-                theme.updatedAt = themeJson["updatedAt"].GetString();
-            }
-            
-            // 解析图片 URLs
-            if (themeJson.HasMember("collagePreview") && themeJson["collagePreview"].IsObject()) {
-                theme.collagePreview = parseImageSizes(themeJson["collagePreview"]);
-            }
-            
-            if (themeJson.HasMember("launcherScreenshot") && themeJson["launcherScreenshot"].IsObject()) {
-                theme.launcherScreenshot = parseImageSizes(themeJson["launcherScreenshot"]);
-            }
-            
-            if (themeJson.HasMember("waraWaraPlazaScreenshot") && themeJson["waraWaraPlazaScreenshot"].IsObject()) {
-                theme.waraWaraScreenshot = parseImageSizes(themeJson["waraWaraPlazaScreenshot"]);
-            }
-            
-            // 背景图 URLs
-            if (themeJson.HasMember("launcherBgUrl") && themeJson["launcherBgUrl"].IsString()) {
-                theme.launcherBgUrl = themeJson["launcherBgUrl"].GetString();
-            }
-            
-            if (themeJson.HasMember("waraWaraPlazaBgUrl") && themeJson["waraWaraPlazaBgUrl"].IsString()) {
-                theme.waraWaraBgUrl = themeJson["waraWaraPlazaBgUrl"].GetString();
-            }
-            
-            // 下载 URL
-            if (themeJson.HasMember("downloadUrl") && themeJson["downloadUrl"].IsString()) {
-                theme.downloadUrl = themeJson["downloadUrl"].GetString();
-                
-                // 从 downloadUrl 中提取短ID
-                // 格式: https://api.themezer.net/wiiu/themes/123/download
-                size_t themesPos = theme.downloadUrl.find("/wiiu/themes/");
-                if (themesPos != std::string::npos) {
-                    size_t idStart = themesPos + 13; // 跳过 "/wiiu/themes/"
-                    size_t idEnd = theme.downloadUrl.find("/", idStart);
-                    if (idEnd != std::string::npos) {
-                        theme.shortId = theme.downloadUrl.substr(idStart, idEnd - idStart);
-                    }
-                }
-            }
-            
-            // 标签
-            if (themeJson.HasMember("tags") && themeJson["tags"].IsArray()) {
-                const auto& tags = themeJson["tags"];
-                for (rapidjson::SizeType j = 0; j < tags.Size(); j++) {
-                    const auto& tagObj = tags[j];
-                    if (tagObj.IsObject() && tagObj.HasMember("name") && tagObj["name"].IsString()) {
-                        theme.tags.push_back(tagObj["name"].GetString());
-                    }
-                }
-            }
+            ParseThemeNode(themeJson, theme);
             
             // 只添加有效的主题
             if (!theme.id.empty() && !theme.name.empty()) {
@@ -325,6 +343,7 @@ bool ThemeManager::ParseThemezerResponse(const std::string& jsonData) {
             }
         }
         
+        RebuildThemeIndex();
         return !mThemes.empty();
         
     } catch (...) {
@@ -349,9 +368,7 @@ void ThemeManager::FetchThemes() {
     FileLogger::GetInstance().LogInfo("Starting async FetchThemes");
     
     // 构造 GraphQL 查询 (包含图片URL) - 设置limit为200以获取更多主题
-    std::string query = R"({
-        "query": "{ wiiuThemes(limit: 200) { nodes { uuid name description downloadCount saveCount updatedAt creator { username } downloadUrl collagePreview { thumbUrl hdUrl } launcherScreenshot { thumbUrl hdUrl } waraWaraPlazaScreenshot { thumbUrl hdUrl } launcherBgUrl waraWaraPlazaBgUrl tags { name } } } }"
-    })";
+    std::string query = "{\"query\": \"{ wiiuThemes(limit: 200) { nodes { " THEMEZER_THEME_FIELDS " } } }\"}";
     
     // 使用 DownloadQueue 进行异步请求
     if (!DownloadQueue::GetInstance()) {
@@ -535,7 +552,40 @@ void ThemeManager::CancelDownload() {
 }
 
 void ThemeManager::Update() {
-    // 回退到同步解析，不再需要分帧逻辑
+    // 增量同步结果在主循环中合并, 保证合并时没有其他地方持有 mThemes 的引用
+    if (mSyncReady) {
+        ApplySync();
+    }
+}
+
+int ThemeManager::FindThemeIndex(const std::string& id) const {
+    auto it = mThemeIndex.find(id);
+    if (it == mThemeIndex.end() || it->second >= mThemes.size()) {
+        return -1;
+    }
+    return (int)it->second;
+}
+
+void ThemeManager::RebuildThemeIndex() {
+    auto t1 = std::chrono::steady_clock::now();
+    
+    mThemeIndex.clear();
+    mThemeIndex.reserve(mThemes.size());
+    mSearchIndex.Clear();
+    mSearchIndex.Reserve(mThemes.size());
+    for (size_t i = 0; i < mThemes.size(); i++) {
+        mThemeIndex[mThemes[i].id] = i;
+        IndexTheme(i);
+    }
+    
+    auto t2 = std::chrono::steady_clock::now();
+    FileLogger::GetInstance().LogInfo("  [+%lldms] Theme index rebuilt (%zu themes)", 
+        std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(), mThemes.size());
+}
+
+void ThemeManager::IndexTheme(size_t index) {
+    const Theme& theme = mThemes[index];
+    mSearchIndex.SetDocument((uint32_t)index, theme.name, theme.author, theme.tags, theme.shortId);
 }
 
 void ThemeManager::SetProgressCallback(std::function<void(float progress, long downloaded, long total)> callback) {
@@ -546,6 +596,10 @@ void ThemeManager::SetStateCallback(std::function<void(FetchState state, const s
     mStateCallback = callback;
 }
 
+void ThemeManager::SetSyncCallback(std::function<void(size_t added, size_t changed, size_t removed)> callback) {
+    mSyncCallback = callback;
+}
+
 std::string ThemeManager::GetCachePath() const {
     return CACHE_FILE;
 }
@@ -721,6 +775,8 @@ bool ThemeManager::DeserializeThemes(const std::string& data) {
             }
         }
         
+        RebuildThemeIndex();
+        
         t2 = std::chrono::steady_clock::now();
         FileLogger::GetInstance().LogInfo("    [+%lldms] Theme array iteration completed, loaded %zu themes", 
             std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(), mThemes.size());
@@ -921,86 +977,307 @@ bool ThemeManager::IsCacheValid() const {
     return valid;
 }
 
-// 后台检测更新
+// 后台增量同步
+// 第一步只拉取 { uuid updatedAt } 与本地缓存对比, 第二步按 uuid 拉取有变化的主题,
+// 最后在 Update() 中把结果合并进缓存, 全程不阻塞主循环
 void ThemeManager::CheckForUpdates() {
-    if (mCheckingUpdates || mThemes.empty()) {
+    if (mCheckingUpdates || mUpdateOp || mThemes.empty() || mState == FETCH_IN_PROGRESS) {
+        return;
+    }
+    
+    if (!DownloadQueue::GetInstance()) {
+        FileLogger::GetInstance().LogWarning("CheckForUpdates: DownloadQueue not initialized");
         return;
     }
     
     mCheckingUpdates = true;
     mHasUpdates = false;
+    mSyncChangedIds.clear();
+    mSyncRemovedIds.clear();
+    mSyncThemes.clear();
+    mSyncReady = false;
     
-    FileLogger::GetInstance().LogInfo("Checking for theme updates...");
+    FileLogger::GetInstance().LogInfo("Checking for theme updates (async delta sync)...");
     
-    // 构造 GraphQL 查询 (只获取基本信息用于对比)
+    // 只获取 uuid 和 updatedAt 用于对比, limit 与 FetchThemes 保持一致以便识别已删除的主题
     std::string query = R"({
-        "query": "{ wiiuThemes(limit: 50) { nodes { uuid updatedAt } } }"
+        "query": "{ wiiuThemes(limit: 200) { nodes { uuid updatedAt } } }"
     })";
     
-    std::string response = FetchUrl(THEMEZER_GRAPHQL_URL, query);
+    mUpdateOp = new DownloadOperation();
+    mUpdateOp->url = THEMEZER_GRAPHQL_URL;
+    mUpdateOp->postData = query;
+    mUpdateOp->cbdata = this;
+    mUpdateOp->cb = [this](DownloadOperation* op) {
+        OnUpdateCheckResponse(op);
+    };
     
-    if (response.empty()) {
-        mCheckingUpdates = false;
-        FileLogger::GetInstance().LogWarning("Failed to check for updates");
+    DownloadQueue::GetInstance()->DownloadAdd(mUpdateOp);
+}
+
+// 增量同步第一步的响应: 对比 updatedAt, 找出新增/更新/删除的主题
+void ThemeManager::OnUpdateCheckResponse(DownloadOperation* op) {
+    // op 持有正在执行的回调 lambda; 这里不再使用 lambda 的捕获, 接管后在函数末尾释放
+    std::unique_ptr<DownloadOperation> done(op);
+    mUpdateOp = nullptr;
+    
+    auto t1 = std::chrono::steady_clock::now();
+    
+    if (op->status != DownloadStatus::COMPLETE || op->buffer.empty()) {
+        FileLogger::GetInstance().LogWarning("Update check failed: HTTP %ld", op->response_code);
+        FinishUpdateCheck();
         return;
     }
     
-    try {
-        rapidjson::Document root;
-        root.Parse(response.c_str());
+    rapidjson::Document root;
+    root.Parse(op->buffer.c_str());
+    
+    if (root.HasParseError() || !root.IsObject() || !root.HasMember("data") || !root["data"].IsObject()) {
+        FileLogger::GetInstance().LogWarning("Update check: invalid response");
+        FinishUpdateCheck();
+        return;
+    }
+    
+    const auto& data = root["data"];
+    if (!data.HasMember("wiiuThemes") || !data["wiiuThemes"].IsObject() ||
+        !data["wiiuThemes"].HasMember("nodes") || !data["wiiuThemes"]["nodes"].IsArray()) {
+        FileLogger::GetInstance().LogWarning("Update check: missing nodes");
+        FinishUpdateCheck();
+        return;
+    }
+    
+    const auto& nodes = data["wiiuThemes"]["nodes"];
+    
+    // 标记服务器上仍存在的本地主题, 未被标记的即为已删除
+    std::vector<bool> seen(mThemes.size(), false);
+    
+    for (rapidjson::SizeType i = 0; i < nodes.Size(); i++) {
+        const auto& node = nodes[i];
+        if (!node.IsObject()) continue;
+        if (!node.HasMember("uuid") || !node["uuid"].IsString()) continue;
         
-        if (root.HasParseError() || !root.IsObject() || !root.HasMember("data")) {
-            mCheckingUpdates = false;
-            return;
-        }
+        std::string id = node["uuid"].GetString();
+        const char* updatedAt = (node.HasMember("updatedAt") && node["updatedAt"].IsString())
+            ? node["updatedAt"].GetString() : "";
         
-        const auto& data = root["data"];
-        if (!data.HasMember("wiiuThemes") || !data["wiiuThemes"].HasMember("nodes")) {
-            mCheckingUpdates = false;
-            return;
+        auto it = mThemeIndex.find(id);
+        if (it == mThemeIndex.end()) {
+            mSyncChangedIds.push_back(id);  // 新主题
+        } else {
+            seen[it->second] = true;
+            if (mThemes[it->second].updatedAt != updatedAt) {
+                mSyncChangedIds.push_back(id);  // 已更新
+            }
         }
-        
-        const auto& nodes = data["wiiuThemes"]["nodes"];
-        if (!nodes.IsArray()) {
-            mCheckingUpdates = false;
-            return;
+    }
+    
+    // 服务器返回空列表时不视为全部删除
+    if (nodes.Size() > 0) {
+        for (size_t i = 0; i < mThemes.size(); i++) {
+            if (!seen[i]) {
+                mSyncRemovedIds.push_back(mThemes[i].id);
+            }
         }
-        
-        // 检查是否有新主题或更新
-        for (rapidjson::SizeType i = 0; i < nodes.Size(); i++) {
-            const auto& node = nodes[i];
-            if (!node.HasMember("uuid") || !node.HasMember("updatedAt")) continue;
-            if (!node["uuid"].IsString() || !node["updatedAt"].IsString()) continue;
-            
-            std::string id = node["uuid"].GetString();
-            std::string updatedAt = node["updatedAt"].GetString();
-            
-            // 查找本地缓存中的主题
-            bool found = false;
-            bool isNewer = false;
+    }
+    
+    auto t2 = std::chrono::steady_clock::now();
+    FileLogger::GetInstance().LogInfo("  [+%lldms] Update check diff: %zu changed/new, %zu removed (remote %u, local %zu)",
+        std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(),
+        mSyncChangedIds.size(), mSyncRemovedIds.size(), nodes.Size(), mThemes.size());
+    
+    if (!mSyncChangedIds.empty()) {
+        mHasUpdates = true;
+        FetchChangedThemes();
+    } else {
+        // 没有需要拉取的主题, 直接进入合并 (可能只有删除, 也用于刷新缓存时间)
+        mSyncReady = true;
+    }
+}
+
+// 按 uuid 拉取有变化的主题完整数据
+void ThemeManager::FetchChangedThemes() {
+    std::string query;
+    
+    if (mSyncChangedIds.size() * SYNC_FULL_FETCH_RATIO > mThemes.size()) {
+        // 大部分主题都变了, 直接拉取完整列表更划算
+        FileLogger::GetInstance().LogInfo("Delta sync: %zu changed, fetching full list", mSyncChangedIds.size());
+        query = "{\"query\": \"{ wiiuThemes(limit: 200) { nodes { " THEMEZER_THEME_FIELDS " } } }\"}";
+    } else {
+        // 使用 GraphQL 别名在一个请求里按 uuid 查询多个主题
+        query = "{\"query\": \"{ ";
+        for (size_t i = 0; i < mSyncChangedIds.size(); i++) {
+            const std::string& id = mSyncChangedIds[i];
             
-            for (const Theme& theme : mThemes) {
-                if (theme.id == id) {
-                    found = true;
-                    if (theme.updatedAt != updatedAt) {
-                        isNewer = true;
-                    }
+            // uuid 只应包含字母数字和 '-', 其余字符一律跳过以免破坏查询
+            bool safe = !id.empty();
+            for (char c : id) {
+                if (!isalnum((unsigned char)c) && c != '-') {
+                    safe = false;
                     break;
                 }
             }
+            if (!safe) continue;
+            
+            query += "t" + std::to_string(i) + ": wiiuTheme(uuid: \\\"" + id + "\\\") { " THEMEZER_THEME_FIELDS " } ";
+        }
+        query += "}\"}";
+    }
+    
+    mUpdateOp = new DownloadOperation();
+    mUpdateOp->url = THEMEZER_GRAPHQL_URL;
+    mUpdateOp->postData = query;
+    mUpdateOp->cbdata = this;
+    mUpdateOp->cb = [this](DownloadOperation* op) {
+        OnChangedThemesResponse(op);
+    };
+    
+    DownloadQueue::GetInstance()->DownloadAdd(mUpdateOp);
+}
+
+// 增量同步第二步的响应: 保存有变化的主题, 等待 Update() 合并
+void ThemeManager::OnChangedThemesResponse(DownloadOperation* op) {
+    // 同 OnUpdateCheckResponse, 接管后在函数末尾释放
+    std::unique_ptr<DownloadOperation> done(op);
+    mUpdateOp = nullptr;
+    
+    if (op->status == DownloadStatus::COMPLETE && !op->buffer.empty()) {
+        rapidjson::Document root;
+        root.Parse(op->buffer.c_str());
+        
+        if (!root.HasParseError() && root.IsObject() && root.HasMember("data") && root["data"].IsObject()) {
+            const auto& data = root["data"];
+            
+            // 只保留本次需要更新的主题
+            std::unordered_map<std::string, bool> wanted;
+            for (const auto& id : mSyncChangedIds) {
+                wanted[id] = true;
+            }
+            
+            auto addNode = [this, &wanted](const rapidjson::Value& node) {
+                if (!node.IsObject()) return;
+                Theme theme;
+                ParseThemeNode(node, theme);
+                if (wanted.count(theme.id)) {
+                    mSyncThemes.push_back(std::move(theme));
+                }
+            };
             
-            // 如果是新主题或有更新
-            if (!found || isNewer) {
-                mHasUpdates = true;
-                FileLogger::GetInstance().LogInfo("Found updates!");
-                break;
+            if (data.HasMember("wiiuThemes") && data["wiiuThemes"].IsObject() &&
+                data["wiiuThemes"].HasMember("nodes") && data["wiiuThemes"]["nodes"].IsArray()) {
+                // 完整列表响应
+                const auto& nodes = data["wiiuThemes"]["nodes"];
+                for (rapidjson::SizeType i = 0; i < nodes.Size(); i++) {
+                    addNode(nodes[i]);
+                }
+            } else {
+                // 别名响应: { "t0": {...}, "t1": {...} }
+                for (auto m = data.MemberBegin(); m != data.MemberEnd(); ++m) {
+                    addNode(m->value);
+                }
             }
+        } else {
+            FileLogger::GetInstance().LogWarning("Delta sync: invalid theme response");
         }
         
-    } catch (...) {
-        FileLogger::GetInstance().LogError("Error parsing update check response");
+        FileLogger::GetInstance().LogInfo("Delta sync: fetched %zu/%zu changed themes",
+            mSyncThemes.size(), mSyncChangedIds.size());
+    } else {
+        FileLogger::GetInstance().LogWarning("Delta sync fetch failed: HTTP %ld", op->response_code);
     }
     
+    // 即使拉取失败也要合并删除项, 未拉取到的主题会保留"有更新"提示
+    mSyncReady = true;
+}
+
+// 将增量同步结果合并进主题列表 (在 Update() 中调用)
+void ThemeManager::ApplySync() {
+    mSyncReady = false;
+    
+    // 同步期间触发了全量刷新, 增量结果已过时
+    if (mState == FETCH_IN_PROGRESS || mThemes.empty()) {
+        FileLogger::GetInstance().LogInfo("Delta sync discarded (full fetch in progress)");
+        mSyncChangedIds.clear();
+        mSyncRemovedIds.clear();
+        mSyncThemes.clear();
+        FinishUpdateCheck();
+        return;
+    }
+    
+    auto t1 = std::chrono::steady_clock::now();
+    
+    // 图片 URL 未变化时沿用已加载的纹理
+    auto keepLoaded = [](ThemeImage& fresh, const ThemeImage& old) {
+        if (fresh.thumbUrl == old.thumbUrl) {
+            fresh.thumbLoaded = old.thumbLoaded;
+            fresh.thumbTexture = old.thumbTexture;
+        }
+    };
+    
+    size_t added = 0;
+    size_t changed = 0;
+    
+    for (Theme& fresh : mSyncThemes) {
+        if (fresh.id.empty() || fresh.name.empty()) {
+            continue;
+        }
+        
+        auto it = mThemeIndex.find(fresh.id);
+        if (it != mThemeIndex.end()) {
+            Theme& old = mThemes[it->second];
+            keepLoaded(fresh.collagePreview, old.collagePreview);
+            keepLoaded(fresh.launcherScreenshot, old.launcherScreenshot);
+            keepLoaded(fresh.waraWaraScreenshot, old.waraWaraScreenshot);
+            old = std::move(fresh);
+            IndexTheme(it->second);
+            changed++;
+        } else {
+            mThemeIndex[fresh.id] = mThemes.size();
+            mThemes.push_back(std::move(fresh));
+            IndexTheme(mThemes.size() - 1);
+            added++;
+        }
+    }
+    
+    size_t removed = 0;
+    if (!mSyncRemovedIds.empty()) {
+        std::unordered_map<std::string, bool> removedIds;
+        for (const auto& id : mSyncRemovedIds) {
+            removedIds[id] = true;
+        }
+        
+        size_t before = mThemes.size();
+        mThemes.erase(std::remove_if(mThemes.begin(), mThemes.end(),
+            [&removedIds](const Theme& theme) { return removedIds.count(theme.id) > 0; }),
+            mThemes.end());
+        removed = before - mThemes.size();
+        RebuildThemeIndex();
+    }
+    
+    // 仍有未拉取成功的主题时保留提示, 用户可以按 Y 全量刷新
+    mHasUpdates = (added + changed) < mSyncChangedIds.size();
+    
+    mSyncChangedIds.clear();
+    mSyncRemovedIds.clear();
+    mSyncThemes.clear();
+    
+    auto t2 = std::chrono::steady_clock::now();
+    FileLogger::GetInstance().LogInfo("  [+%lldms] Delta sync merged: %zu added, %zu changed, %zu removed (%zu themes)",
+        std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(),
+        added, changed, removed, mThemes.size());
+    
+    // 即使没有变化也重写缓存, 以刷新缓存时间
+    if (!SaveCache()) {
+        FileLogger::GetInstance().LogError("Failed to save cache after delta sync");
+    }
+    
+    FinishUpdateCheck();
+    
+    if (mSyncCallback && (added || changed || removed)) {
+        mSyncCallback(added, changed, removed);
+    }
+}
+
+void ThemeManager::FinishUpdateCheck() {
     mCheckingUpdates = false;
 }
 
@@ -1042,6 +1319,9 @@ void ThemeManager::SaveThemeMetadata(const Theme& theme, const std::string& them
         
         FileLogger::GetInstance().LogInfo("Metadata saved successfully with proper JSON escaping");
         
+        // 下载完成, 登记到已安装主题索引
+        InstalledThemeIndex::GetInstance().RefreshFolder(InstalledThemeIndex::FolderFromPath(themePath));
+        
     } catch (const std::exception& e) {
         FileLogger::GetInstance().LogError("Failed to save metadata: %s", e.what());
         return;
@@ -1115,6 +1395,9 @@ void ThemeManager::SaveThemeMetadata(const Theme& theme, const std::string& them
         }
         
         FileLogger::GetInstance().LogInfo("Async image downloads complete: %d/%d successful", successCount, totalImages);
+        
+        // 图片写入 images/ 子目录, 主题目录的修改时间不一定变化, 需要主动刷新索引中的图片路径
+        InstalledThemeIndex::GetInstance().RefreshFolder(InstalledThemeIndex::FolderFromPath(themePath));
     });
     
     // 分离线程,让它在后台运行
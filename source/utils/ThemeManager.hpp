@@ -4,7 +4,9 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <unordered_map>
 #include <SDL2/SDL.h>
+#include "ThemeSearchIndex.hpp"
 
 // 前向声明
 struct DownloadOperation;
@@ -15,11 +17,9 @@ struct ThemeImage {
     std::string thumbUrl;  // 缩略图 URL
     std::string hdUrl;     // 高清图 URL
     
-    // 本地缓存
+    // 本地缓存 (高清图由详情页的 TieredImage 持有)
     bool thumbLoaded = false;
-    bool hdLoaded = false;
     SDL_Texture* thumbTexture = nullptr;
-    SDL_Texture* hdTexture = nullptr;
 };
 
 // 主题数据结构
@@ -81,9 +81,17 @@ public:
     // 检查是否有缓存数据
     bool HasCachedThemes() const { return !mThemes.empty(); }
     
+    // 通过 uuid 查找主题索引 (哈希索引, 找不到返回 -1)
+    int FindThemeIndex(const std::string& id) const;
+    
+    // 搜索索引 (文档 ID 即 GetThemes() 下标, 随主题列表同步更新)
+    const ThemeSearchIndex& GetSearchIndex() const { return mSearchIndex; }
+    
     // 强制刷新(清除缓存)
     void ForceRefresh() {
         mThemes.clear();
+        mThemeIndex.clear();
+        mSearchIndex.Clear();
         FetchThemes();
     }
     
@@ -91,8 +99,9 @@ public:
     bool SaveCache();           // 保存缓存到文件
     bool LoadCache();           // 从文件加载缓存
     bool IsCacheValid() const;  // 检查缓存是否有效
-    void CheckForUpdates();     // 后台检测更新
+    void CheckForUpdates();     // 后台增量同步 (异步, 通过 DownloadQueue)
     bool HasUpdates() const { return mHasUpdates; }
+    bool IsCheckingUpdates() const { return mCheckingUpdates; }
     
     // 更新(在主循环中调用)
     void Update();
@@ -100,6 +109,8 @@ public:
     // 设置回调
     void SetProgressCallback(std::function<void(float progress, long downloaded, long total)> callback);
     void SetStateCallback(std::function<void(FetchState state, const std::string& message)> callback);
+    // 增量同步合并完成后回调 (新增/更新/删除数量), 主题索引可能已变化
+    void SetSyncCallback(std::function<void(size_t added, size_t changed, size_t removed)> callback);
     
 private:
     std::vector<Theme> mThemes;
@@ -108,12 +119,24 @@ private:
     bool mHasUpdates = false;
     bool mCheckingUpdates = false;
     DownloadOperation* mFetchOp = nullptr;  // 异步网络请求操作
+    DownloadOperation* mUpdateOp = nullptr; // 增量同步网络请求操作
+    
+    // uuid -> mThemes 下标
+    std::unordered_map<std::string, size_t> mThemeIndex;
+    ThemeSearchIndex mSearchIndex;
+    
+    // 增量同步的待合并数据 (在 Update() 中合并, 避免回调期间修改 mThemes)
+    std::vector<std::string> mSyncChangedIds;  // 新增或 updatedAt 变化的 uuid
+    std::vector<std::string> mSyncRemovedIds;  // 服务器上已不存在的 uuid
+    std::vector<Theme> mSyncThemes;            // 拉取到的完整主题数据
+    bool mSyncReady = false;
     ThemeDownloader* mDownloader = nullptr; // 主题下载器
     bool mDownloaderNeedsCleanup = false;   // 标记下载器需要清理
     
     // 回调
     std::function<void(float progress, long downloaded, long total)> mProgressCallback;
     std::function<void(FetchState state, const std::string& message)> mStateCallback;
+    std::function<void(size_t added, size_t changed, size_t removed)> mSyncCallback;
     
     // 内部方法
     bool ParseThemezerResponse(const std::string& jsonData);
@@ -121,6 +144,13 @@ private:
     std::string GetCachePath() const;
     std::string SerializeThemes() const;
     bool DeserializeThemes(const std::string& data);
+    void RebuildThemeIndex();
+    void IndexTheme(size_t index);
+    void OnUpdateCheckResponse(DownloadOperation* op);
+    void FetchChangedThemes();
+    void OnChangedThemesResponse(DownloadOperation* op);
+    void ApplySync();
+    void FinishUpdateCheck();
     void SaveThemeMetadata(const Theme& theme, const std::string& themePath);
     bool DownloadImageToFile(const std::string& url, const std::string& filePath);
     
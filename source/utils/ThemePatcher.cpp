@@ -5,6 +5,7 @@
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/error/en.h"
 #include "FileLogger.hpp"
+#include "InstalledThemeIndex.hpp"
 #include "Utils.hpp"
 #include "logger.h"
 #include "hips.hpp"
@@ -548,6 +549,15 @@ bool ThemePatcher::InstallTheme(const std::string& themePath,
         FileLogger::GetInstance().LogInfo("Saved installation info to: %s", installedInfoPath.c_str());
     }
     
+    // 更新已安装主题索引 (安装记录 + 主题目录的修补状态)
+    InstalledThemeRecord installRecord;
+    installRecord.id = themeID;
+    installRecord.name = themeName;
+    installRecord.author = themeAuthor;
+    installRecord.installPath = themePath;
+    InstalledThemeIndex::GetInstance().RecordInstall(installRecord);
+    InstalledThemeIndex::GetInstance().RefreshFolder(InstalledThemeIndex::FolderFromPath(themePath));
+    
     if (mProgressCallback) {
         mProgressCallback(1.0f, "Installation complete");
     }
@@ -625,100 +635,31 @@ bool ThemePatcher::UninstallTheme(const std::string& themeID) {
     // 删除安装信息
     unlink(installedInfoPath.c_str());
     
+    InstalledThemeIndex::GetInstance().RemoveFolder(themeName);
+    InstalledThemeIndex::GetInstance().RecordUninstall(themeID);
+    
     FileLogger::GetInstance().LogInfo("Theme uninstalled successfully");
     
     return true;
 }
 
 bool ThemePatcher::IsThemeInstalled(const std::string& themeID) {
-    std::string installedInfoPath = std::string(INSTALLED_THEMES_ROOT) + "/" + themeID + ".json";
-    
-    struct stat st;
-    return (stat(installedInfoPath.c_str(), &st) == 0);
+    return InstalledThemeIndex::GetInstance().IsInstalled(themeID);
 }
 
 std::vector<ThemeMetadata> ThemePatcher::GetInstalledThemes() {
     std::vector<ThemeMetadata> themes;
     
-    DIR* dir = opendir(INSTALLED_THEMES_ROOT);
-    if (!dir) {
-        FileLogger::GetInstance().LogInfo("No installed themes directory");
-        return themes;
-    }
-    
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_type != DT_REG) {
-            continue;
-        }
-        
-        std::string filename = entry->d_name;
-        if (filename.length() < 5 || filename.substr(filename.length() - 5) != ".json") {
-            continue;
-        }
-        
-        std::string fullPath = std::string(INSTALLED_THEMES_ROOT) + "/" + filename;
-        
-        FILE* jsonFile = fopen(fullPath.c_str(), "r");
-        if (!jsonFile) {
-            continue;
-        }
-        
-        fseek(jsonFile, 0, SEEK_END);
-        size_t fileSize = ftell(jsonFile);
-        rewind(jsonFile);
-        
-        std::string jsonContent;
-        jsonContent.resize(fileSize);
-        fread(&jsonContent[0], 1, fileSize, jsonFile);
-        fclose(jsonFile);
-        
-        // 简单解析
+    // 从已安装主题索引读取, 不再逐个打开安装记录
+    for (const InstalledThemeRecord& record : InstalledThemeIndex::GetInstance().GetInstalledThemes()) {
         ThemeMetadata metadata;
-        
-        // 解析 themeID
-        size_t pos = jsonContent.find("\"themeID\"");
-        if (pos != std::string::npos) {
-            size_t colonPos = jsonContent.find(":", pos);
-            size_t quoteStart = jsonContent.find("\"", colonPos);
-            size_t quoteEnd = jsonContent.find("\"", quoteStart + 1);
-            metadata.themeID = jsonContent.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
-        }
-        
-        // 解析 themeName
-        pos = jsonContent.find("\"themeName\"");
-        if (pos != std::string::npos) {
-            size_t colonPos = jsonContent.find(":", pos);
-            size_t quoteStart = jsonContent.find("\"", colonPos);
-            size_t quoteEnd = jsonContent.find("\"", quoteStart + 1);
-            metadata.themeName = jsonContent.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
-        }
-        
-        // 解析 themeAuthor
-        pos = jsonContent.find("\"themeAuthor\"");
-        if (pos != std::string::npos) {
-            size_t colonPos = jsonContent.find(":", pos);
-            size_t quoteStart = jsonContent.find("\"", colonPos);
-            size_t quoteEnd = jsonContent.find("\"", quoteStart + 1);
-            metadata.themeAuthor = jsonContent.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
-        }
-        
-        // 解析 themeVersion
-        pos = jsonContent.find("\"themeVersion\"");
-        if (pos != std::string::npos) {
-            size_t colonPos = jsonContent.find(":", pos);
-            size_t quoteStart = jsonContent.find("\"", colonPos);
-            size_t quoteEnd = jsonContent.find("\"", quoteStart + 1);
-            metadata.themeVersion = jsonContent.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
-        }
-        
+        metadata.themeID = record.id;
+        metadata.themeName = record.name;
+        metadata.themeAuthor = record.author;
         metadata.themeRegion = REGION_UNIVERSAL;
-        
         themes.push_back(metadata);
     }
     
-    closedir(dir);
-    
     FileLogger::GetInstance().LogInfo("Found %zu installed themes", themes.size());
     
     return themes;
@@ -765,83 +706,14 @@ bool ThemePatcher::SetCurrentTheme(const std::string& themeID) {
         }
     }
     
-    // 如果从installed info获取失败，尝试从主题目录的theme_info.json读取
+    // 如果从installed info获取失败，通过已安装主题索引按 ID 查找主题目录 (theme_info.json / metadata.json)
     if (themeFolderName.empty()) {
-        FileLogger::GetInstance().LogInfo("[SetCurrentTheme] No installed info, searching theme directory for ID: %s", themeID.c_str());
-        
-        DIR* themesDir = opendir(THEMES_ROOT);
-        if (themesDir) {
-            FileLogger::GetInstance().LogInfo("[SetCurrentTheme] Opened THEMES_ROOT successfully");
-            struct dirent* entry;
-            int dirCount = 0;
-            while ((entry = readdir(themesDir)) != nullptr) {
-                if (entry->d_name[0] == '.') continue;
-                
-                std::string themeDir = std::string(THEMES_ROOT) + "/" + entry->d_name;
-                dirCount++;
-                
-                // 优先尝试 theme_info.json (ManageScreen使用这个)
-                std::string themeInfoPath = themeDir + "/theme_info.json";
-                FILE* metaFile = fopen(themeInfoPath.c_str(), "r");
-                
-                // 如果不存在，尝试 metadata.json
-                if (!metaFile) {
-                    themeInfoPath = themeDir + "/metadata.json";
-                    metaFile = fopen(themeInfoPath.c_str(), "r");
-                }
-                
-                if (metaFile) {
-                    FileLogger::GetInstance().LogInfo("[SetCurrentTheme] Reading: %s", themeInfoPath.c_str());
-                    
-                    fseek(metaFile, 0, SEEK_END);
-                    size_t metaSize = ftell(metaFile);
-                    rewind(metaFile);
-                    
-                    std::string metaContent;
-                    metaContent.resize(metaSize);
-                    fread(&metaContent[0], 1, metaSize, metaFile);
-                    fclose(metaFile);
-                    
-                    rapidjson::Document metadata;
-                    metadata.Parse(metaContent.c_str());
-                    
-                    if (!metadata.HasParseError() && metadata.IsObject()) {
-                        std::string metaID;
-                        
-                        // 尝试多种字段名: "id", "themeID", "Metadata.id", "Metadata.themeID"
-                        if (metadata.HasMember("id") && metadata["id"].IsString()) {
-                            metaID = metadata["id"].GetString();
-                        } else if (metadata.HasMember("themeID") && metadata["themeID"].IsString()) {
-                            metaID = metadata["themeID"].GetString();
-                        } else if (metadata.HasMember("Metadata") && metadata["Metadata"].IsObject()) {
-                            const auto& metaObj = metadata["Metadata"];
-                            if (metaObj.HasMember("id") && metaObj["id"].IsString()) {
-                                metaID = metaObj["id"].GetString();
-                            } else if (metaObj.HasMember("themeID") && metaObj["themeID"].IsString()) {
-                                metaID = metaObj["themeID"].GetString();
-                            }
-                        }
-                        
-                        FileLogger::GetInstance().LogInfo("[SetCurrentTheme] Theme %s has ID: %s (looking for: %s)", 
-                                                          entry->d_name, metaID.c_str(), themeID.c_str());
-                        
-                        if (metaID == themeID) {
-                            // 找到匹配的主题
-                            themeFolderName = entry->d_name;
-                            FileLogger::GetInstance().LogInfo("[SetCurrentTheme] ✓ Found matching theme: %s", themeFolderName.c_str());
-                            break;
-                        }
-                    } else {
-                        FileLogger::GetInstance().LogWarning("[SetCurrentTheme] Failed to parse JSON in %s", themeInfoPath.c_str());
-                    }
-                } else {
-                    FileLogger::GetInstance().LogWarning("[SetCurrentTheme] No metadata file for: %s", entry->d_name);
-                }
-            }
-            FileLogger::GetInstance().LogInfo("[SetCurrentTheme] Scanned %d theme directories", dirCount);
-            closedir(themesDir);
-        } else {
-            FileLogger::GetInstance().LogError("[SetCurrentTheme] Failed to open THEMES_ROOT: %s", THEMES_ROOT);
+        FileLogger::GetInstance().LogInfo("[SetCurrentTheme] No installed info, looking up theme index for ID: %s", themeID.c_str());
+        
+        InstalledThemeIndex::GetInstance().Load();
+        themeFolderName = InstalledThemeIndex::GetInstance().FindFolderById(themeID);
+        if (!themeFolderName.empty()) {
+            FileLogger::GetInstance().LogInfo("[SetCurrentTheme] ✓ Found matching theme: %s", themeFolderName.c_str());
         }
     }
     
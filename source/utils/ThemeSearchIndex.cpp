@@ -0,0 +1,512 @@
+#include "ThemeSearchIndex.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+
+// 字段分隔符, 查询中不会出现, 因此子串匹配不会跨字段
+static const char32_t FIELD_SEPARATOR = U'\x1F';
+
+// 单个码点的大小写折叠
+static char32_t FoldCodepoint(char32_t c) {
+    // ASCII
+    if (c < 0x80) {
+        return (c >= 'A' && c <= 'Z') ? c + 0x20 : c;
+    }
+    
+    // 全角 ASCII (日文/中文输入法常见) -> 半角
+    if (c >= 0xFF01 && c <= 0xFF5E) {
+        c = c - 0xFF01 + 0x21;
+        return (c >= 'A' && c <= 'Z') ? c + 0x20 : c;
+    }
+    
+    // Latin-1 (À-Þ, 跳过 ×)
+    if (c >= 0xC0 && c <= 0xDE && c != 0xD7) {
+        return c + 0x20;
+    }
+    
+    // Latin Extended-A: 大小写成对出现
+    if (c >= 0x100 && c <= 0x17F) {
+        if ((c <= 0x12F) || (c >= 0x132 && c <= 0x137) || (c >= 0x14A && c <= 0x177)) {
+            return (c % 2 == 0) ? c + 1 : c;
+        }
+        if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E)) {
+            return (c % 2 == 1) ? c + 1 : c;
+        }
+        if (c == 0x178) {
+            return 0xFF;  // Ÿ -> ÿ
+        }
+        return c;
+    }
+    
+    // 希腊字母
+    if (c >= 0x391 && c <= 0x3A9 && c != 0x3A2) {
+        return c + 0x20;
+    }
+    
+    // 西里尔字母
+    if (c >= 0x410 && c <= 0x42F) {
+        return c + 0x20;
+    }
+    if (c >= 0x400 && c <= 0x40F) {
+        return c + 0x50;
+    }
+    
+    return c;
+}
+
+std::u32string ThemeSearchIndex::Fold(const std::string& utf8) {
+    std::u32string out;
+    out.reserve(utf8.size());
+    
+    const unsigned char* s = (const unsigned char*)utf8.data();
+    size_t len = utf8.size();
+    size_t i = 0;
+    
+    while (i < len) {
+        unsigned char b = s[i];
+        char32_t c;
+        size_t extra;
+        
+        if (b < 0x80) {
+            c = b;
+            extra = 0;
+        } else if ((b & 0xE0) == 0xC0) {
+            c = b & 0x1F;
+            extra = 1;
+        } else if ((b & 0xF0) == 0xE0) {
+            c = b & 0x0F;
+            extra = 2;
+        } else if ((b & 0xF8) == 0xF0) {
+            c = b & 0x07;
+            extra = 3;
+        } else {
+            // 非法首字节
+            out.push_back(0xFFFD);
+            i++;
+            continue;
+        }
+        
+        bool valid = true;
+        for (size_t k = 1; k <= extra; k++) {
+            if (i + k >= len || (s[i + k] & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            c = (c << 6) | (s[i + k] & 0x3F);
+        }
+        
+        if (!valid) {
+            out.push_back(0xFFFD);
+            i++;
+            continue;
+        }
+        
+        out.push_back(FoldCodepoint(c));
+        i += extra + 1;
+    }
+    
+    return out;
+}
+
+// 三个码点 (各 21 位) 打包成一个 64 位 key
+static inline uint64_t MakeGram(char32_t a, char32_t b, char32_t c) {
+    return ((uint64_t)(a & 0x1FFFFF) << 42) | ((uint64_t)(b & 0x1FFFFF) << 21) | (uint64_t)(c & 0x1FFFFF);
+}
+
+void ThemeSearchIndex::CollectGrams(const std::u32string& field, std::vector<uint64_t>& out) {
+    if (field.size() < 3) {
+        return;
+    }
+    for (size_t i = 0; i + 2 < field.size(); i++) {
+        out.push_back(MakeGram(field[i], field[i + 1], field[i + 2]));
+    }
+}
+
+void ThemeSearchIndex::SetDocument(uint32_t docId,
+                                   const std::string& name,
+                                   const std::string& author,
+                                   const std::vector<std::string>& tags,
+                                   const std::string& shortId) {
+    if (docId < mDocs.size() && mDocs[docId].alive) {
+        RemoveDocument(docId);
+    }
+    if (docId >= mDocs.size()) {
+        mDocs.resize(docId + 1);
+    }
+    
+    Document& doc = mDocs[docId];
+    doc.alive = true;
+    doc.grams.clear();
+    doc.fieldStarts.clear();
+    
+    // 按字段折叠并收集 trigram (trigram 不跨字段)
+    std::u32string field = Fold(name);
+    doc.fieldStarts.push_back(0);
+    doc.text = field;
+    CollectGrams(field, doc.grams);
+    
+    field = Fold(author);
+    doc.text += FIELD_SEPARATOR;
+    doc.fieldStarts.push_back((uint32_t)doc.text.size());
+    doc.text += field;
+    CollectGrams(field, doc.grams);
+    
+    for (const auto& tag : tags) {
+        field = Fold(tag);
+        doc.text += FIELD_SEPARATOR;
+        doc.fieldStarts.push_back((uint32_t)doc.text.size());
+        doc.text += field;
+        CollectGrams(field, doc.grams);
+    }
+    
+    std::sort(doc.grams.begin(), doc.grams.end());
+    doc.grams.erase(std::unique(doc.grams.begin(), doc.grams.end()), doc.grams.end());
+    
+    // 写入倒排表, 保持文档 ID 升序 (顺序建立时只会追加到末尾)
+    for (uint64_t gram : doc.grams) {
+        auto& list = mPostings[gram];
+        if (list.empty() || list.back() < docId) {
+            list.push_back(docId);
+        } else {
+            list.insert(std::lower_bound(list.begin(), list.end(), docId), docId);
+        }
+    }
+    
+    // shortId 只包含数字, 简单转小写即可
+    doc.shortId = shortId;
+    std::transform(doc.shortId.begin(), doc.shortId.end(), doc.shortId.begin(), ::tolower);
+    if (!doc.shortId.empty()) {
+        mShortIds[doc.shortId].push_back(docId);
+    }
+}
+
+void ThemeSearchIndex::RemoveDocument(uint32_t docId) {
+    if (docId >= mDocs.size() || !mDocs[docId].alive) {
+        return;
+    }
+    
+    Document& doc = mDocs[docId];
+    
+    for (uint64_t gram : doc.grams) {
+        auto it = mPostings.find(gram);
+        if (it == mPostings.end()) continue;
+        
+        auto& list = it->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), docId);
+        if (pos != list.end() && *pos == docId) {
+            list.erase(pos);
+        }
+        if (list.empty()) {
+            mPostings.erase(it);
+        }
+    }
+    
+    if (!doc.shortId.empty()) {
+        auto it = mShortIds.find(doc.shortId);
+        if (it != mShortIds.end()) {
+            auto& list = it->second;
+            list.erase(std::remove(list.begin(), list.end(), docId), list.end());
+            if (list.empty()) {
+                mShortIds.erase(it);
+            }
+        }
+    }
+    
+    doc = Document();
+}
+
+void ThemeSearchIndex::Clear() {
+    mDocs.clear();
+    mPostings.clear();
+    mShortIds.clear();
+}
+
+void ThemeSearchIndex::Reserve(size_t count) {
+    mDocs.reserve(count);
+    mShortIds.reserve(count);
+}
+
+// 取出查询的所有 trigram 对应的倒排表, 从最短的开始求交集 (查询至少 3 个码点)
+std::vector<uint32_t> ThemeSearchIndex::ExactCandidates(const std::u32string& folded) const {
+    std::vector<uint32_t> candidates;
+    
+    std::vector<uint64_t> grams;
+    CollectGrams(folded, grams);
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    
+    std::vector<const std::vector<uint32_t>*> lists;
+    lists.reserve(grams.size());
+    for (uint64_t gram : grams) {
+        auto it = mPostings.find(gram);
+        if (it == mPostings.end()) {
+            return candidates;
+        }
+        lists.push_back(&it->second);
+    }
+    
+    if (lists.empty()) {
+        return candidates;
+    }
+    
+    std::sort(lists.begin(), lists.end(),
+        [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+    
+    candidates = *lists[0];
+    std::vector<uint32_t> merged;
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+        merged.clear();
+        std::set_intersection(candidates.begin(), candidates.end(),
+                              lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(merged));
+        candidates.swap(merged);
+    }
+    
+    return candidates;
+}
+
+// 模糊匹配候选: 一处编辑最多破坏 3 个 trigram, 允许 k 处错误的匹配至少保留 (trigram 数 - 3k) 个
+// 查询的 trigram (q-gram 引理); 下限取 1, 查询较短时一处错误可能破坏全部 trigram, 这类匹配会被漏掉
+std::vector<uint32_t> ThemeSearchIndex::FuzzyCandidates(const std::u32string& folded, int maxErrors) const {
+    std::vector<uint32_t> candidates;
+    
+    std::vector<uint64_t> grams;
+    CollectGrams(folded, grams);
+    if (grams.empty()) {
+        return candidates;
+    }
+    const int threshold = std::max(1, (int)grams.size() - 3 * maxErrors);
+    
+    // 查询中重复的 trigram 每次出现都计数, 计数不会低于引理保证的数目
+    std::unordered_map<uint32_t, int> hits;
+    for (uint64_t gram : grams) {
+        auto it = mPostings.find(gram);
+        if (it == mPostings.end()) continue;
+        for (uint32_t docId : it->second) {
+            hits[docId]++;
+        }
+    }
+    
+    candidates.reserve(hits.size());
+    for (const auto& hit : hits) {
+        if (hit.second >= threshold) {
+            candidates.push_back(hit.first);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    return candidates;
+}
+
+// Bitap (Wu-Manber) 模式: 每个码点对应一个 64 位掩码, 第 i 位表示模式第 i 个字符
+namespace {
+
+struct BitapPattern {
+    uint64_t ascii[128] = {};
+    std::vector<std::pair<char32_t, uint64_t>> other;  // 非 ASCII 码点 (模式很短, 线性查找)
+    size_t length = 0;
+    
+    explicit BitapPattern(const std::u32string& pattern) {
+        length = std::min<size_t>(pattern.size(), 63);
+        for (size_t i = 0; i < length; i++) {
+            char32_t c = pattern[i];
+            if (c < 128) {
+                ascii[c] |= 1ULL << i;
+                continue;
+            }
+            bool found = false;
+            for (auto& entry : other) {
+                if (entry.first == c) {
+                    entry.second |= 1ULL << i;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                other.push_back({c, 1ULL << i});
+            }
+        }
+    }
+    
+    uint64_t Mask(char32_t c) const {
+        if (c < 128) {
+            return ascii[c];
+        }
+        for (const auto& entry : other) {
+            if (entry.first == c) {
+                return entry.second;
+            }
+        }
+        return 0;
+    }
+};
+
+// 在 text[begin, end) 中查找模式, 返回最少编辑距离 (<= maxErrors), 未命中返回 -1
+int BitapSearch(const BitapPattern& pattern, const std::u32string& text, size_t begin, size_t end, int maxErrors) {
+    const size_t m = pattern.length;
+    if (m == 0 || end <= begin) {
+        return -1;
+    }
+    
+    const uint64_t accept = 1ULL << (m - 1);
+    uint64_t R[4];
+    for (int d = 0; d <= maxErrors; d++) {
+        R[d] = (1ULL << d) - 1;  // 允许删除模式前 d 个字符
+    }
+    
+    // 整个字段都比模式短时, 删除也可以完成匹配
+    for (int d = 0; d <= maxErrors; d++) {
+        if (R[d] & accept) {
+            return d;
+        }
+    }
+    
+    int best = -1;
+    for (size_t i = begin; i < end; i++) {
+        uint64_t mask = pattern.Mask(text[i]);
+        uint64_t prevOld = R[0];
+        R[0] = ((R[0] << 1) | 1) & mask;
+        
+        for (int d = 1; d <= maxErrors; d++) {
+            uint64_t old = R[d];
+            // 匹配 | 插入 (消耗文本字符) | 替换 | 删除 (跳过模式字符)
+            R[d] = (((old << 1) | 1) & mask) | prevOld | (((prevOld | R[d - 1]) << 1) | 1);
+            prevOld = old;
+        }
+        
+        for (int d = 0; d <= maxErrors; d++) {
+            if (R[d] & accept) {
+                if (best < 0 || d < best) {
+                    best = d;
+                }
+                break;
+            }
+        }
+        
+        if (best == 0) {
+            break;
+        }
+    }
+    
+    return best;
+}
+    
+} // namespace
+
+std::vector<size_t> ThemeSearchIndex::SearchRanked(const std::string& query, size_t topK) const {
+    std::vector<size_t> results;
+    
+    std::u32string folded = Fold(query);
+    if (folded.empty() || topK == 0) {
+        return results;
+    }
+    
+    // 字段权重: 名称 > 作者 > 标签
+    static const int FIELD_WEIGHT[3] = {3, 2, 1};
+    
+    // 允许的错误数随查询长度增加 (短查询容错会匹配到太多无关结果)
+    const int maxErrors = folded.size() <= 3 ? 0 : (folded.size() <= 6 ? 1 : 2);
+    
+    BitapPattern pattern(folded);
+    std::vector<std::pair<int, uint32_t>> scored;  // (分数, 文档 ID)
+    std::vector<bool> visited(mDocs.size(), false);
+    
+    // 对单个文档逐字段打分, 取最高分
+    auto scoreDocument = [&](uint32_t docId, int errorsAllowed) -> int {
+        const Document& doc = mDocs[docId];
+        int best = 0;
+        
+        for (size_t f = 0; f < doc.fieldStarts.size(); f++) {
+            size_t begin = doc.fieldStarts[f];
+            size_t end = (f + 1 < doc.fieldStarts.size()) ? doc.fieldStarts[f + 1] - 1 : doc.text.size();
+            int weight = FIELD_WEIGHT[std::min<size_t>(f, 2)];
+            int score = 0;
+            
+            // 精确子串: 完全相等 / 前缀 / 包含
+            size_t pos = doc.text.find(folded, begin);
+            if (pos != std::u32string::npos && pos + folded.size() <= end) {
+                score = 100;
+                if (pos == begin) {
+                    score += (end - begin == folded.size()) ? 40 : 20;
+                }
+            } else if (errorsAllowed > 0) {
+                int errors = BitapSearch(pattern, doc.text, begin, end, errorsAllowed);
+                if (errors > 0) {
+                    score = 100 - errors * 35;
+                }
+            }
+            
+            best = std::max(best, score * weight);
+        }
+        
+        return best;
+    };
+    
+    // T+ID 完全匹配排在最前
+    if (folded.size() >= 2 && folded[0] == U't') {
+        std::string searchId;
+        for (size_t i = 1; i < folded.size(); i++) {
+            if (folded[i] >= 0x80) {
+                searchId.clear();
+                break;
+            }
+            searchId.push_back((char)folded[i]);
+        }
+        
+        auto it = mShortIds.find(searchId);
+        if (it != mShortIds.end()) {
+            for (uint32_t docId : it->second) {
+                scored.push_back({100000, docId});
+                visited[docId] = true;
+            }
+        }
+    }
+    
+    // 第一轮: 精确命中 (长查询先用倒排表缩小范围)
+    size_t exactHits = 0;
+    if (folded.size() >= 3) {
+        for (uint32_t docId : ExactCandidates(folded)) {
+            if (visited[docId] || !mDocs[docId].alive) continue;
+            int score = scoreDocument(docId, 0);
+            if (score > 0) {
+                scored.push_back({score, docId});
+                visited[docId] = true;
+                exactHits++;
+            }
+        }
+    }
+    
+    // 第二轮: 精确结果不足 topK 时做模糊匹配; 候选同样来自倒排表, 只有查询太短没有 trigram 时才扫描全部文档
+    if (folded.size() < 3) {
+        for (size_t i = 0; i < mDocs.size(); i++) {
+            if (visited[i] || !mDocs[i].alive) continue;
+            int score = scoreDocument((uint32_t)i, maxErrors);
+            if (score > 0) {
+                scored.push_back({score, (uint32_t)i});
+            }
+        }
+    } else if (exactHits < topK && maxErrors > 0) {
+        for (uint32_t docId : FuzzyCandidates(folded, maxErrors)) {
+            if (visited[docId] || !mDocs[docId].alive) continue;
+            int score = scoreDocument(docId, maxErrors);
+            if (score > 0) {
+                scored.push_back({score, docId});
+            }
+        }
+    }
+    
+    // 分数降序, 同分保持原列表顺序
+    auto better = [](const std::pair<int, uint32_t>& a, const std::pair<int, uint32_t>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    };
+    
+    size_t k = std::min(topK, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + k, scored.end(), better);
+    
+    results.reserve(k);
+    for (size_t i = 0; i < k; i++) {
+        results.push_back(scored[i].second);
+    }
+    
+    return results;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// 主题搜索索引 (DownloadScreen / ManageScreen 共用)
+// - 名称/作者/标签在建立索引时做一次 UTF-8 大小写折叠, 搜索时不再逐条转换
+// - 三字符 (trigram) 倒排表: 查询长度 >= 3 时只校验候选文档
+// - shortId 哈希表: T<id> 搜索直接命中
+// 文档 ID 即调用方列表中的下标, 支持单条增删以配合增量同步
+class ThemeSearchIndex {
+public:
+    // 添加或替换一个文档
+    void SetDocument(uint32_t docId,
+                     const std::string& name,
+                     const std::string& author,
+                     const std::vector<std::string>& tags,
+                     const std::string& shortId);
+    
+    // 移除一个文档 (下标不变, 只是不再参与搜索)
+    void RemoveDocument(uint32_t docId);
+    
+    void Clear();
+    void Reserve(size_t count);
+    
+    size_t GetDocumentCount() const { return mDocs.size(); }
+    
+    // 带容错的排序搜索: 精确命中走倒排表, 不足 topK 时对共享足够 trigram 的候选用 Bitap 做模糊匹配,
+    // 按 名称 > 作者 > 标签 打分后用 partial_sort 取前 topK 个 (按相关度排序)
+    std::vector<size_t> SearchRanked(const std::string& query, size_t topK) const;
+    
+    // UTF-8 解码并做大小写折叠 (ASCII/Latin-1/Latin Extended-A/希腊/西里尔/全角)
+    static std::u32string Fold(const std::string& utf8);
+
+private:
+    struct Document {
+        bool alive = false;
+        std::u32string text;           // 折叠后的 名称\x1F作者\x1F标签1\x1F标签2...
+        std::string shortId;           // 小写 shortId
+        std::vector<uint64_t> grams;   // 去重后的 trigram, 用于移除时清理倒排表
+        std::vector<uint32_t> fieldStarts;  // 各字段在 text 中的起始位置 (0: 名称, 1: 作者, 2+: 标签)
+    };
+    
+    std::vector<Document> mDocs;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> mPostings;  // trigram -> 升序文档 ID
+    std::unordered_map<std::string, std::vector<uint32_t>> mShortIds;  // shortId -> 文档 ID
+    
+    static void CollectGrams(const std::u32string& field, std::vector<uint64_t>& out);
+    std::vector<uint32_t> ExactCandidates(const std::u32string& folded) const;
+    std::vector<uint32_t> FuzzyCandidates(const std::u32string& folded, int maxErrors) const;
+};
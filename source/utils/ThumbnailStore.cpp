@@ -0,0 +1,418 @@
+#include "ThumbnailStore.hpp"
+#include "ImageDiskCache.hpp"
+#include "FileLogger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define STORE_DIR "fs:/vol/external01/UTheme/temp/thumbs"
+#define INDEX_PATH STORE_DIR "/index.txt"
+#define INDEX_TMP_PATH STORE_DIR "/index.tmp"
+#define INDEX_MAGIC "UThemeThumbStore"
+
+ThumbnailStore& ThumbnailStore::GetInstance() {
+    static ThumbnailStore instance;
+    return instance;
+}
+
+ThumbnailStore::~ThumbnailStore() {
+    Stop();
+}
+
+std::string ThumbnailStore::PackPath(uint32_t pack) {
+    char path[96];
+    snprintf(path, sizeof(path), STORE_DIR "/pack_%u.bin", (unsigned int)pack);
+    return path;
+}
+
+void ThumbnailStore::AppendRecord(FILE* file, uint64_t key, const Entry& entry) {
+    fprintf(file, "%016llx %u %u %u %u %u %u %u %08x\n", (unsigned long long)key,
+            (unsigned int)entry.pack, (unsigned int)entry.offset,
+            (unsigned int)entry.width, (unsigned int)entry.height,
+            (unsigned int)entry.targetWidth, (unsigned int)entry.targetHeight,
+            (unsigned int)entry.stamp, (unsigned int)entry.format);
+}
+
+bool ThumbnailStore::Matches(const Entry& entry, int targetWidth, int targetHeight, uint32_t stamp) const {
+    return entry.targetWidth == targetWidth && entry.targetHeight == targetHeight && entry.stamp == stamp;
+}
+
+void ThumbnailStore::Start() {
+    std::lock_guard<std::mutex> ioLock(mIoMutex);
+    if (mStarted) {
+        return;
+    }
+    
+    mkdir(STORE_DIR, 0777);
+    
+    // 现有的打包文件
+    std::vector<uint32_t> packs;
+    DIR* dir = opendir(STORE_DIR);
+    if (dir) {
+        struct dirent* item;
+        while ((item = readdir(dir)) != nullptr) {
+            unsigned int pack;
+            int length = 0;
+            if (sscanf(item->d_name, "pack_%u.bin%n", &pack, &length) == 1 && item->d_name[length] == '\0') {
+                packs.push_back(pack);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(packs.begin(), packs.end());
+    mPacks.assign(packs.begin(), packs.end());
+    
+    if (!ReadIndex()) {
+        // 没有索引时打包文件里的数据无法定位, 全部删除
+        for (uint32_t pack : mPacks) {
+            remove(PackPath(pack).c_str());
+        }
+        mPacks.clear();
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mEntries.clear();
+        }
+        WriteIndex();
+    }
+    
+    if (!mIndexFile) {
+        mIndexFile = fopen(INDEX_PATH, "a");
+    }
+    OpenWritePack(false);
+    mStarted = true;
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    FileLogger::GetInstance().LogInfo("[ThumbStore] Loaded %zu thumbnails in %zu packs", mEntries.size(), mPacks.size());
+}
+
+void ThumbnailStore::Stop() {
+    std::lock_guard<std::mutex> ioLock(mIoMutex);
+    if (!mStarted) {
+        return;
+    }
+    CloseFiles();
+    mStarted = false;
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    FileLogger::GetInstance().LogInfo("[ThumbStore] Stopped (hits %u, misses %u)", mHits, mMisses);
+    mEntries.clear();
+}
+
+void ThumbnailStore::CloseFiles() {
+    if (mWriteFile) {
+        fclose(mWriteFile);
+        mWriteFile = nullptr;
+    }
+    if (mReadFile) {
+        fclose(mReadFile);
+        mReadFile = nullptr;
+    }
+    if (mIndexFile) {
+        fclose(mIndexFile);
+        mIndexFile = nullptr;
+    }
+}
+
+bool ThumbnailStore::Contains(const std::string& key, int targetWidth, int targetHeight, uint32_t stamp) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mEntries.find(ImageDiskCache::HashUrl(key));
+    return it != mEntries.end() && Matches(it->second, targetWidth, targetHeight, stamp);
+}
+
+SDL_Surface* ThumbnailStore::Load(const std::string& key, int targetWidth, int targetHeight, uint32_t stamp,
+                                  Uint32 format, Uint32 altFormat) {
+    const uint64_t hash = ImageDiskCache::HashUrl(key);
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mEntries.find(hash);
+        if (it == mEntries.end() || !Matches(it->second, targetWidth, targetHeight, stamp) ||
+            (it->second.format != format && (altFormat == 0 || it->second.format != altFormat))) {
+            mMisses++;
+            return nullptr;
+        }
+        entry = it->second;
+    }
+    format = entry.format;
+    
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, entry.width, entry.height, SDL_BITSPERPIXEL(format), format);
+    if (!surface) {
+        return nullptr;
+    }
+    
+    const size_t rowBytes = (size_t)entry.width * SDL_BYTESPERPIXEL(format);
+    bool ok = false;
+    {
+        std::lock_guard<std::mutex> ioLock(mIoMutex);
+        if (mReadFile && mReadPack != entry.pack) {
+            fclose(mReadFile);
+            mReadFile = nullptr;
+        }
+        if (!mReadFile) {
+            mReadFile = fopen(PackPath(entry.pack).c_str(), "rb");
+            mReadPack = entry.pack;
+        }
+        
+        if (mReadFile && fseek(mReadFile, entry.offset, SEEK_SET) == 0) {
+            uint8_t* pixels = (uint8_t*)surface->pixels;
+            if ((size_t)surface->pitch == rowBytes) {
+                ok = fread(pixels, 1, rowBytes * entry.height, mReadFile) == rowBytes * entry.height;
+            } else {
+                ok = true;
+                for (int y = 0; y < entry.height && ok; y++) {
+                    ok = fread(pixels + (size_t)y * surface->pitch, 1, rowBytes, mReadFile) == rowBytes;
+                }
+            }
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!ok) {
+        FileLogger::GetInstance().LogWarning("[ThumbStore] Failed to read %s from pack %u", key.c_str(), (unsigned int)entry.pack);
+        mEntries.erase(hash);
+        mMisses++;
+        SDL_FreeSurface(surface);
+        return nullptr;
+    }
+    mHits++;
+    return surface;
+}
+
+void ThumbnailStore::Save(const std::string& key, int targetWidth, int targetHeight, uint32_t stamp, SDL_Surface* surface) {
+    if (!surface || surface->w > 0xffff || surface->h > 0xffff || targetWidth > 0xffff || targetHeight > 0xffff) {
+        return;
+    }
+    
+    const size_t rowBytes = (size_t)surface->w * surface->format->BytesPerPixel;
+    const size_t bytes = rowBytes * surface->h;
+    if (bytes == 0 || bytes > PACK_BYTES) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> ioLock(mIoMutex);
+    if (!mStarted) {
+        return;
+    }
+    if (!mWriteFile || mWriteOffset + bytes > PACK_BYTES) {
+        if (!OpenWritePack(true)) {
+            return;
+        }
+    }
+    
+    // 解码得到的 surface 不是 RLE 格式, 不需要加锁
+    const uint8_t* pixels = (const uint8_t*)surface->pixels;
+    bool ok;
+    if ((size_t)surface->pitch == rowBytes) {
+        ok = fwrite(pixels, 1, bytes, mWriteFile) == bytes;
+    } else {
+        ok = true;
+        for (int y = 0; y < surface->h && ok; y++) {
+            ok = fwrite(pixels + (size_t)y * surface->pitch, 1, rowBytes, mWriteFile) == rowBytes;
+        }
+    }
+    ok = ok && fflush(mWriteFile) == 0;
+    
+    if (!ok) {
+        // 写了一半的数据不再使用, 下次换新的打包文件
+        FileLogger::GetInstance().LogError("[ThumbStore] Failed to write %s", key.c_str());
+        mWriteOffset = PACK_BYTES;
+        return;
+    }
+    
+    Entry entry;
+    entry.pack = mPacks.back();
+    entry.offset = mWriteOffset;
+    entry.width = (uint16_t)surface->w;
+    entry.height = (uint16_t)surface->h;
+    entry.targetWidth = (uint16_t)targetWidth;
+    entry.targetHeight = (uint16_t)targetHeight;
+    entry.stamp = stamp;
+    entry.format = surface->format->format;
+    mWriteOffset += bytes;
+    
+    // 先写像素再写索引, 中断时最多丢失条目, 不会指向无效数据
+    const uint64_t hash = ImageDiskCache::HashUrl(key);
+    if (mIndexFile) {
+        AppendRecord(mIndexFile, hash, entry);
+        fflush(mIndexFile);
+    }
+    
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEntries[hash] = entry;
+}
+
+bool ThumbnailStore::OpenWritePack(bool startNew) {
+    if (mWriteFile) {
+        fclose(mWriteFile);
+        mWriteFile = nullptr;
+    }
+    
+    if (!startNew && !mPacks.empty()) {
+        // 继续写上次的打包文件
+        mWriteFile = fopen(PackPath(mPacks.back()).c_str(), "ab");
+        if (mWriteFile) {
+            fseek(mWriteFile, 0, SEEK_END);
+            long size = ftell(mWriteFile);
+            mWriteOffset = size > 0 ? (uint32_t)size : 0;
+            if (mWriteOffset < PACK_BYTES) {
+                return true;
+            }
+            fclose(mWriteFile);
+            mWriteFile = nullptr;
+        }
+    }
+    
+    uint32_t pack = mPacks.empty() ? 0 : mPacks.back() + 1;
+    mWriteFile = fopen(PackPath(pack).c_str(), "wb");
+    if (!mWriteFile) {
+        FileLogger::GetInstance().LogError("[ThumbStore] Failed to create %s", PackPath(pack).c_str());
+        return false;
+    }
+    mPacks.push_back(pack);
+    mWriteOffset = 0;
+    
+    while (mPacks.size() > MAX_PACKS) {
+        DropOldestPack();
+    }
+    return true;
+}
+
+void ThumbnailStore::DropOldestPack() {
+    uint32_t pack = mPacks.front();
+    mPacks.pop_front();
+    if (mReadFile && mReadPack == pack) {
+        fclose(mReadFile);
+        mReadFile = nullptr;
+    }
+    
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto it = mEntries.begin(); it != mEntries.end();) {
+            if (it->second.pack == pack) {
+                it = mEntries.erase(it);
+                dropped++;
+            } else {
+                ++it;
+            }
+        }
+    }
+    remove(PackPath(pack).c_str());
+    
+    // 去掉索引中指向已删除打包文件的记录
+    WriteIndex();
+    FileLogger::GetInstance().LogInfo("[ThumbStore] Dropped pack %u (%zu thumbnails)", (unsigned int)pack, dropped);
+}
+
+bool ThumbnailStore::ReadIndex() {
+    FILE* fp = fopen(INDEX_PATH, "r");
+    if (!fp) {
+        return false;
+    }
+    
+    char line[160];
+    int version = 0;
+    char magic[32] = {};
+    if (!fgets(line, sizeof(line), fp) || sscanf(line, "%31s %d", magic, &version) != 2 ||
+        strcmp(magic, INDEX_MAGIC) != 0 || version != INDEX_VERSION) {
+        fclose(fp);
+        return false;
+    }
+    
+    std::map<uint32_t, uint32_t> packSizes;
+    for (uint32_t pack : mPacks) {
+        struct stat st;
+        if (stat(PackPath(pack).c_str(), &st) == 0) {
+            packSizes[pack] = (uint32_t)st.st_size;
+        }
+    }
+    
+    // 同一 key 以最后一条记录为准
+    std::unordered_map<uint64_t, Entry> entries;
+    size_t records = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        unsigned long long key;
+        unsigned int pack, offset, width, height, targetWidth, targetHeight, stamp, format;
+        if (sscanf(line, "%llx %u %u %u %u %u %u %u %x", &key, &pack, &offset, &width, &height,
+                   &targetWidth, &targetHeight, &stamp, &format) != 9) {
+            continue;
+        }
+        records++;
+        
+        // 打包文件已删除或数据不完整
+        auto size = packSizes.find(pack);
+        uint64_t end = (uint64_t)offset + (uint64_t)width * height * SDL_BYTESPERPIXEL(format);
+        if (size == packSizes.end() || end > size->second) {
+            continue;
+        }
+        
+        Entry& entry = entries[key];
+        entry.pack = pack;
+        entry.offset = offset;
+        entry.width = (uint16_t)width;
+        entry.height = (uint16_t)height;
+        entry.targetWidth = (uint16_t)targetWidth;
+        entry.targetHeight = (uint16_t)targetHeight;
+        entry.stamp = stamp;
+        entry.format = format;
+    }
+    fclose(fp);
+    
+    size_t count = entries.size();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries = std::move(entries);
+    }
+    
+    // 有被替换或失效的记录时压缩索引
+    if (records != count) {
+        WriteIndex();
+    }
+    return true;
+}
+
+bool ThumbnailStore::WriteIndex() {
+    if (mIndexFile) {
+        fclose(mIndexFile);
+        mIndexFile = nullptr;
+    }
+    
+    FILE* fp = fopen(INDEX_TMP_PATH, "w");
+    bool ok = fp != nullptr;
+    if (fp) {
+        fprintf(fp, "%s %d\n", INDEX_MAGIC, INDEX_VERSION);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (const auto& pair : mEntries) {
+                AppendRecord(fp, pair.first, pair.second);
+            }
+        }
+        ok = ferror(fp) == 0;
+        ok = (fclose(fp) == 0) && ok;
+    }
+    if (ok) {
+        // FAT 上 rename 不能覆盖已有文件
+        remove(INDEX_PATH);
+        ok = rename(INDEX_TMP_PATH, INDEX_PATH) == 0;
+    }
+    if (!ok) {
+        FileLogger::GetInstance().LogError("[ThumbStore] Failed to write index");
+        remove(INDEX_TMP_PATH);
+    }
+    
+    mIndexFile = fopen(INDEX_PATH, "a");
+    return ok;
+}
+
+uint32_t ThumbnailStore::GetHits() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mHits;
+}
+
+uint32_t ThumbnailStore::GetMisses() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mMisses;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+
+// 已解码缩略图存储 (UTheme/temp/thumbs)
+// - 卡片缩略图按显示尺寸解码后, 把渲染器格式 (或转换后的 16 位格式) 的像素追加写入打包文件, 索引记录位置
+// - 再次打开列表时只需顺序读取像素并上传纹理, 不再读原图和解码 WebP / JPEG
+// - 打包文件写满后换下一个, 超过 MAX_PACKS 个时整包删除最旧的一个 (先进先出)
+// - 条目按 URL (本地文件为路径) 哈希、目标尺寸、像素格式和来源时间戳匹配, 不一致时视为未命中
+// 所有接口线程安全, 由 ImageDecodePool 工作线程读写
+class ThumbnailStore {
+public:
+    static ThumbnailStore& GetInstance();
+    
+    // 加载索引, 需要 UTheme/temp 目录已创建
+    void Start();
+    
+    // 关闭打包文件
+    void Stop();
+    
+    // 是否有匹配的条目, 只查询内存中的索引
+    bool Contains(const std::string& key, int targetWidth, int targetHeight, uint32_t stamp);
+    
+    // 读取格式为 format (或 altFormat, 非 0 时) 的条目, 未命中或读取失败返回 nullptr
+    SDL_Surface* Load(const std::string& key, int targetWidth, int targetHeight, uint32_t stamp,
+                      Uint32 format, Uint32 altFormat = 0);
+    
+    // 保存解码结果, 同一 key 的旧条目被替换
+    void Save(const std::string& key, int targetWidth, int targetHeight, uint32_t stamp, SDL_Surface* surface);
+    
+    // 统计信息
+    uint32_t GetHits();
+    uint32_t GetMisses();
+
+private:
+    ThumbnailStore() = default;
+    ~ThumbnailStore();
+    ThumbnailStore(const ThumbnailStore&) = delete;
+    ThumbnailStore& operator=(const ThumbnailStore&) = delete;
+    
+    static constexpr int INDEX_VERSION = 1;
+    static constexpr uint32_t PACK_BYTES = 8 * 1024 * 1024;
+    static constexpr size_t MAX_PACKS = 6;
+    
+    struct Entry {
+        uint32_t pack;
+        uint32_t offset;
+        uint16_t width, height;              // 像素尺寸, 每行紧密排列
+        uint16_t targetWidth, targetHeight;  // 请求时的目标尺寸
+        uint32_t stamp;
+        Uint32 format;
+    };
+    
+    // mIoMutex 保护文件句柄, mMutex 保护索引; 需要同时持有时先锁 mIoMutex
+    std::mutex mIoMutex;
+    std::mutex mMutex;
+    bool mStarted = false;
+    
+    std::unordered_map<uint64_t, Entry> mEntries;
+    std::deque<uint32_t> mPacks;  // 从旧到新
+    uint32_t mHits = 0;
+    uint32_t mMisses = 0;
+    
+    FILE* mWriteFile = nullptr;  // 最新的打包文件, 追加写入
+    uint32_t mWriteOffset = 0;
+    FILE* mReadFile = nullptr;   // 最近读取的打包文件
+    uint32_t mReadPack = 0;
+    FILE* mIndexFile = nullptr;  // 索引, 追加写入
+    
+    bool ReadIndex();
+    bool WriteIndex();
+    bool OpenWritePack(bool startNew);
+    void DropOldestPack();
+    void CloseFiles();
+    bool Matches(const Entry& entry, int targetWidth, int targetHeight, uint32_t stamp) const;
+    static std::string PackPath(uint32_t pack);
+    static void AppendRecord(FILE* file, uint64_t key, const Entry& entry);
+};
@@ -0,0 +1,159 @@
+#include "TieredImage.hpp"
+#include "FileLogger.hpp"
+#include "../Gfx.hpp"
+
+void TieredImage::Load(const std::string& thumbUrl, const std::string& hdUrl, bool progressive) {
+    Release();
+    
+    mThumbUrl = thumbUrl;
+    mHdUrl = hdUrl;
+    mTextures = std::make_shared<Textures>();
+    mHdShown = false;
+    mLowShown = false;
+    mPartialShown = false;
+    mFade.SetImmediate(0.0f);
+    mPins.Update({thumbUrl, hdUrl});
+    
+    // 已缓存的分辨率立即可用
+    if (!hdUrl.empty()) {
+        mTextures->hd = ImageLoader::GetCached(hdUrl);
+    }
+    if (!thumbUrl.empty()) {
+        mTextures->thumb = ImageLoader::GetCached(thumbUrl);
+    }
+    
+    std::weak_ptr<Textures> weak = mTextures;
+    if (!mTextures->hd && !hdUrl.empty()) {
+        ImageLoader::LoadRequest request;
+        request.url = hdUrl;
+        request.highPriority = true;
+        // 全屏预览最大为屏幕尺寸, 更大的源图在解码时缩小
+        request.targetWidth = Gfx::SCREEN_WIDTH;
+        request.targetHeight = Gfx::SCREEN_HEIGHT;
+        request.progressive = progressive;
+        request.callback = [weak, hdUrl](SDL_Texture* texture) {
+            if (auto textures = weak.lock()) {
+                textures->hd = texture;
+                FileLogger::GetInstance().LogInfo("[TieredImage] HD ready: %s (%p)", hdUrl.c_str(), texture);
+            }
+        };
+        ImageLoader::LoadAsync(request);
+    }
+}
+
+void TieredImage::Release() {
+    if (!mTextures) {
+        return;
+    }
+    
+    // 之后到达的回调被忽略
+    mTextures.reset();
+    mPins.Clear();
+    
+    // 高清图占用大, 离开界面即释放; 仍在加载的会在完成后进入缓存, 未固定, 按 LRU 淘汰
+    if (!mHdUrl.empty()) {
+        ImageLoader::RemoveFromCache(mHdUrl);
+    }
+    mThumbUrl.clear();
+    mHdUrl.clear();
+}
+
+TieredImage::Layer TieredImage::GetHdLayer() {
+    Layer layer;
+    if (!mTextures || !mTextures->hd) {
+        return layer;
+    }
+    if (!ImageLoader::IsCached(mHdUrl, mTextures->hd)) {
+        mTextures->hd = nullptr;
+        return layer;
+    }
+    layer.texture = mTextures->hd;
+    layer.source = ImageLoader::GetSourceRect(mHdUrl, layer.texture);
+    return layer;
+}
+
+TieredImage::Layer TieredImage::GetThumbLayer() {
+    Layer layer;
+    if (!mTextures || mThumbUrl.empty()) {
+        return layer;
+    }
+    // 被替换后 (例如列表重新加载了缩略图) 取缓存中的新纹理
+    if (!mTextures->thumb || !ImageLoader::IsCached(mThumbUrl, mTextures->thumb)) {
+        mTextures->thumb = ImageLoader::GetCached(mThumbUrl);
+    }
+    if (mTextures->thumb) {
+        layer.texture = mTextures->thumb;
+        layer.source = ImageLoader::GetSourceRect(mThumbUrl, layer.texture);
+    }
+    return layer;
+}
+
+TieredImage::Layer TieredImage::GetPartialLayer() const {
+    Layer layer;
+    if (mHdUrl.empty()) {
+        return layer;
+    }
+    layer.texture = ImageLoader::GetProgressive(mHdUrl);
+    if (layer.texture) {
+        SDL_QueryTexture(layer.texture, nullptr, nullptr, &layer.source.w, &layer.source.h);
+    }
+    return layer;
+}
+
+bool TieredImage::GetSize(int& width, int& height) {
+    Layer layer = GetHdLayer();
+    if (!layer.texture) {
+        layer = GetThumbLayer();
+    }
+    if (!layer.texture) {
+        layer = GetPartialLayer();
+    }
+    if (!layer.texture || layer.source.w <= 0 || layer.source.h <= 0) {
+        return false;
+    }
+    width = layer.source.w;
+    height = layer.source.h;
+    return true;
+}
+
+void TieredImage::DrawLayer(const Layer& layer, const SDL_Rect& dst, Uint8 alpha) {
+    if (alpha != 255) {
+        SDL_SetTextureAlphaMod(layer.texture, alpha);
+    }
+    SDL_RenderCopy(Gfx::GetRenderer(), layer.texture, &layer.source, &dst);
+    if (alpha != 255) {
+        SDL_SetTextureAlphaMod(layer.texture, 255);
+    }
+}
+
+void TieredImage::Draw(const SDL_Rect& dst, Uint8 alpha) {
+    Layer hd = GetHdLayer();
+    if (hd.texture && !mHdShown) {
+        mHdShown = true;
+        if (mLowShown && !mPartialShown) {
+            mFade.Start(0.0f, 1.0f, FADE_MS);
+        } else {
+            mFade.SetImmediate(1.0f);
+        }
+    }
+    mFade.Update();
+    
+    const float fade = hd.texture ? mFade.GetValue() : 0.0f;
+    if (fade < 1.0f) {
+        // 低分辨率层保持不透明, 高清图在上面淡入
+        Layer thumb = GetThumbLayer();
+        if (thumb.texture) {
+            DrawLayer(thumb, dst, alpha);
+            mLowShown = true;
+        }
+        // 部分解码的高清图未解码的部分是透明的, 叠加在缩略图上
+        Layer partial = hd.texture ? Layer() : GetPartialLayer();
+        if (partial.texture) {
+            DrawLayer(partial, dst, alpha);
+            mPartialShown = true;
+        }
+    }
+    if (hd.texture) {
+        DrawLayer(hd, dst, (Uint8)(alpha * fade));
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ImageLoader.hpp"
+#include "Animation.hpp"
+#include <SDL2/SDL.h>
+#include <memory>
+#include <string>
+
+// 分级预览图 (缩略图 -> 高清图)
+// - Load 时立即使用纹理缓存中已有的最佳分辨率, 缩略图放大显示 (缩略图由列表加载, 之后才进入缓存的也会被取用)
+// - 同时以高优先级加载高清图, 网络图片下载期间在缩略图上叠加部分解码的结果
+// - 高清图就绪后在缩略图上淡入; 已经边下载边显示时直接替换部分解码的结果
+// - Release (或析构) 时解除固定并把高清纹理移出缓存, 缩略图留给列表继续使用
+// 只能在主线程使用
+class TieredImage {
+public:
+    TieredImage() = default;
+    ~TieredImage() { Release(); }
+    TieredImage(const TieredImage&) = delete;
+    TieredImage& operator=(const TieredImage&) = delete;
+    
+    // progressive: 高清图需要下载时边下载边显示
+    void Load(const std::string& thumbUrl, const std::string& hdUrl, bool progressive);
+    void Release();
+    
+    // 当前显示的图片尺寸, 用于按比例计算目标矩形; 没有可显示的图片时返回 false
+    bool GetSize(int& width, int& height);
+    
+    // 绘制到 dst, 淡入期间绘制两层; alpha 为整体不透明度
+    void Draw(const SDL_Rect& dst, Uint8 alpha = 255);
+
+private:
+    static constexpr float FADE_MS = 250.0f;
+    
+    // 加载回调写入这里; 释放后到达的回调只持有过期的 weak_ptr, 不会访问已销毁的界面
+    struct Textures {
+        SDL_Texture* thumb = nullptr;
+        SDL_Texture* hd = nullptr;
+    };
+    
+    struct Layer {
+        SDL_Texture* texture = nullptr;
+        SDL_Rect source = {0, 0, 0, 0};
+    };
+    
+    std::string mThumbUrl;
+    std::string mHdUrl;
+    std::shared_ptr<Textures> mTextures;
+    TexturePinSet mPins;
+    Animation mFade;             // 高清图不透明度 0..1
+    bool mHdShown = false;
+    bool mLowShown = false;      // 显示过缩略图时高清图才淡入, 否则直接显示
+    bool mPartialShown = false;  // 显示过部分解码的高清图时直接切换, 已解码部分与高清图相同, 淡入反而会先露出缩略图
+    
+    Layer GetHdLayer();
+    Layer GetThumbLayer();
+    Layer GetPartialLayer() const;
+    static void DrawLayer(const Layer& layer, const SDL_Rect& dst, Uint8 alpha);
+};
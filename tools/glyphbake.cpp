@@ -0,0 +1,360 @@
+// 界面字形烘焙工具 (主机端, 由 Makefile 在构建时调用)
+//
+// 用法: glyphbake <input.lang> <cjk.ttf> <latin.ttf> <sizes> <icons.ttf> <icon size> <icon codes> <output.glyphs>
+//
+// - 收集语言包中出现的全部码位 (另加 ASCII), 按语言包的 CJK 标志选择字体
+// - 在 <sizes> (逗号分隔) 的每个字号下光栅化, 图标按 <icon codes> (十六进制, 空格或逗号分隔) 光栅化
+// - 度量与 SDL_ttf 一致, 打包成一张图集, 生成 GlyphAtlas.hpp 描述的二进制文件
+
+#include "LangPack.hpp"
+#include "GlyphAtlas.hpp"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static constexpr int CELL_PADDING = 2;  // 图标会缩放绘制, 留出线性过滤的余量
+
+struct Cell {
+    uint32_t codepoint;
+    int w;
+    int h;
+    std::vector<uint8_t> alpha;
+    int x = 0;
+    int y = 0;
+};
+
+struct Face {
+    uint32_t kind;
+    uint32_t size;
+    uint32_t height;
+    std::vector<size_t> cells;
+};
+
+static bool ReadFile(const char* path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+static uint32_t GetU32(const std::string& data, size_t offset) {
+    return ((uint32_t)(uint8_t)data[offset] << 24) | ((uint32_t)(uint8_t)data[offset + 1] << 16) |
+           ((uint32_t)(uint8_t)data[offset + 2] << 8) | (uint32_t)(uint8_t)data[offset + 3];
+}
+
+static void PutU32(std::string& out, uint32_t value) {
+    out.push_back((char)(value >> 24));
+    out.push_back((char)(value >> 16));
+    out.push_back((char)(value >> 8));
+    out.push_back((char)value);
+}
+
+static void PutU16(std::string& out, uint16_t value) {
+    out.push_back((char)(value >> 8));
+    out.push_back((char)value);
+}
+
+static std::vector<int> ParseList(const char* text, int base) {
+    std::vector<int> values;
+    std::string item;
+    for (const char* c = text;; c++) {
+        if (*c == ',' || *c == ' ' || *c == '\t' || *c == '\n' || *c == '\0') {
+            if (!item.empty()) {
+                values.push_back((int)strtol(item.c_str(), nullptr, base));
+                item.clear();
+            }
+            if (*c == '\0') {
+                break;
+            }
+        } else {
+            item.push_back(*c);
+        }
+    }
+    return values;
+}
+
+static void CollectCodepoints(const char* text, size_t size, std::set<uint32_t>& out) {
+    for (size_t i = 0; i < size;) {
+        uint8_t c = (uint8_t)text[i];
+        uint32_t cp;
+        int len;
+        if (c < 0x80)      { cp = c;        len = 1; }
+        else if (c < 0xE0) { cp = c & 0x1F; len = 2; }
+        else if (c < 0xF0) { cp = c & 0x0F; len = 3; }
+        else               { cp = c & 0x07; len = 4; }
+        for (int k = 1; k < len && i + k < size; k++) {
+            cp = (cp << 6) | ((uint8_t)text[i + k] & 0x3F);
+        }
+        i += len;
+        if (cp >= ' ' && cp != 0x7F) {
+            out.insert(cp);
+        }
+    }
+}
+
+// 与 SDL_ttf (TTF_initFontMetrics) 相同的字体度量
+static void GetFontMetrics(FT_Face face, int& ascent, int& height) {
+    FT_Fixed scale = face->size->metrics.y_scale;
+    ascent = (int)((FT_MulFix(face->ascender, scale) + 63) >> 6);
+    int descent = (int)((FT_MulFix(face->descender, scale) + 63) >> 6);
+    height = (int)((FT_MulFix(face->ascender - face->descender, scale) + 63) >> 6);
+    
+    // 与 FC_LoadFontFromTTF 的修正一致
+    if (height < ascent - descent) {
+        height = ascent - descent;
+    }
+}
+
+// 单个字符的渲染结果与 SDL_ttf 一致: 宽度覆盖前进宽度和字形范围, 高度为字体高度, 基线在 ascent
+static bool RenderCell(FT_Face face, uint32_t codepoint, int ascent, int height, Cell& cell) {
+    FT_UInt index = FT_Get_Char_Index(face, codepoint);
+    if (index == 0 && codepoint != ' ') {
+        return false;
+    }
+    if (FT_Load_Glyph(face, index, FT_LOAD_DEFAULT) != 0 ||
+        FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0) {
+        return false;
+    }
+    
+    const FT_GlyphSlot slot = face->glyph;
+    const FT_Bitmap& bitmap = slot->bitmap;
+    const int advance = (int)((slot->metrics.horiAdvance + 63) >> 6);
+    const int left = slot->bitmap_left;
+    const int minX = std::min(0, left);
+    const int maxX = std::max(advance, left + (int)bitmap.width);
+    
+    cell.w = std::max(1, maxX - minX);
+    cell.h = height;
+    cell.alpha.assign((size_t)cell.w * cell.h, 0);
+    
+    const int originX = left - minX;
+    const int originY = ascent - slot->bitmap_top;
+    const int pitch = std::abs(bitmap.pitch);
+    for (int row = 0; row < (int)bitmap.rows; row++) {
+        int y = originY + row;
+        if (y < 0 || y >= cell.h) {
+            continue;
+        }
+        const uint8_t* src = bitmap.buffer + (size_t)row * pitch;
+        uint8_t* dst = &cell.alpha[(size_t)y * cell.w + originX];
+        memcpy(dst, src, bitmap.width);
+    }
+    return true;
+}
+
+// 按高度排序后逐行 (shelf) 打包, 返回图集高度
+static int PackCells(std::vector<Cell>& cells, int width) {
+    std::vector<Cell*> order;
+    for (auto& cell : cells) {
+        order.push_back(&cell);
+    }
+    std::stable_sort(order.begin(), order.end(), [](const Cell* a, const Cell* b) {
+        return a->h != b->h ? a->h > b->h : a->w > b->w;
+    });
+    
+    int x = CELL_PADDING;
+    int y = CELL_PADDING;
+    int rowHeight = 0;
+    for (Cell* cell : order) {
+        if (x + cell->w + CELL_PADDING > width) {
+            x = CELL_PADDING;
+            y += rowHeight + CELL_PADDING;
+            rowHeight = 0;
+        }
+        cell->x = x;
+        cell->y = y;
+        x += cell->w + CELL_PADDING;
+        rowHeight = std::max(rowHeight, cell->h);
+    }
+    return y + rowHeight + CELL_PADDING;
+}
+
+static bool BakeFace(FT_Face face, uint32_t kind, int size, const std::set<uint32_t>& codepoints,
+                     std::vector<Face>& faces, std::vector<Cell>& cells, const char* fontPath) {
+    if (FT_Set_Char_Size(face, 0, size * 64, 0, 0) != 0) {
+        fprintf(stderr, "%s: cannot set size %d\n", fontPath, size);
+        return false;
+    }
+    
+    int ascent, height;
+    GetFontMetrics(face, ascent, height);
+    
+    Face out;
+    out.kind = kind;
+    out.size = (uint32_t)size;
+    out.height = (uint32_t)height;
+    
+    for (uint32_t cp : codepoints) {
+        Cell cell;
+        cell.codepoint = cp;
+        if (!RenderCell(face, cp, ascent, height, cell)) {
+            // 字体中没有的字符保留给运行时处理 (与现在的显示效果相同)
+            if (kind == GLYPHATLAS_FACE_ICON) {
+                fprintf(stderr, "%s: warning: no glyph for icon 0x%04x\n", fontPath, cp);
+            }
+            continue;
+        }
+        out.cells.push_back(cells.size());
+        cells.push_back(std::move(cell));
+    }
+    
+    faces.push_back(std::move(out));
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 9) {
+        fprintf(stderr, "usage: %s <input.lang> <cjk.ttf> <latin.ttf> <sizes> <icons.ttf> <icon size> <icon codes> <output.glyphs>\n", argv[0]);
+        return 1;
+    }
+    const char* inPath = argv[1];
+    const char* cjkFontPath = argv[2];
+    const char* latinFontPath = argv[3];
+    const std::vector<int> sizes = ParseList(argv[4], 10);
+    const char* iconFontPath = argv[5];
+    const int iconSize = atoi(argv[6]);
+    const std::vector<int> iconCodes = ParseList(argv[7], 16);
+    const char* outPath = argv[8];
+    
+    std::string pack;
+    if (!ReadFile(inPath, pack) || pack.size() < sizeof(LangPackHeader) || GetU32(pack, 0) != LANGPACK_MAGIC) {
+        fprintf(stderr, "%s: not a language pack\n", inPath);
+        return 1;
+    }
+    const uint32_t flags = GetU32(pack, 8);
+    const size_t blobOffset = sizeof(LangPackHeader) + (size_t)GetU32(pack, 16) * sizeof(LangPackEntry);
+    const size_t blobSize = GetU32(pack, 20);
+    if (blobOffset + blobSize > pack.size()) {
+        fprintf(stderr, "%s: truncated language pack\n", inPath);
+        return 1;
+    }
+    
+    std::set<uint32_t> codepoints;
+    for (uint32_t cp = ' '; cp < 0x7F; cp++) {
+        codepoints.insert(cp);
+    }
+    CollectCodepoints(pack.data() + blobOffset, blobSize, codepoints);
+    
+    std::set<uint32_t> icons;
+    for (int code : iconCodes) {
+        icons.insert((uint32_t)code);
+    }
+    
+    const bool cjk = (flags & LANGPACK_FLAG_CJK) != 0;
+    const char* textFontPath = cjk ? cjkFontPath : latinFontPath;
+    
+    FT_Library library;
+    FT_Face textFace, iconFace;
+    if (FT_Init_FreeType(&library) != 0) {
+        fprintf(stderr, "cannot initialize FreeType\n");
+        return 1;
+    }
+    if (FT_New_Face(library, textFontPath, 0, &textFace) != 0) {
+        fprintf(stderr, "%s: cannot open font\n", textFontPath);
+        return 1;
+    }
+    if (FT_New_Face(library, iconFontPath, 0, &iconFace) != 0) {
+        fprintf(stderr, "%s: cannot open font\n", iconFontPath);
+        return 1;
+    }
+    
+    std::vector<Face> faces;
+    std::vector<Cell> cells;
+    for (int size : sizes) {
+        if (!BakeFace(textFace, GLYPHATLAS_FACE_TEXT, size, codepoints, faces, cells, textFontPath)) {
+            return 1;
+        }
+    }
+    if (!icons.empty() && !BakeFace(iconFace, GLYPHATLAS_FACE_ICON, iconSize, icons, faces, cells, iconFontPath)) {
+        return 1;
+    }
+    
+    FT_Done_Face(iconFace);
+    FT_Done_Face(textFace);
+    FT_Done_FreeType(library);
+    
+    // 宽度取 1024, 内容较少时缩小, 避免图集过于细长或浪费
+    size_t area = 0;
+    for (const auto& cell : cells) {
+        area += (size_t)(cell.w + CELL_PADDING) * (cell.h + CELL_PADDING);
+    }
+    int width = 1024;
+    while (width > 256 && area < (size_t)width * width / 4) {
+        width /= 2;
+    }
+    const int height = PackCells(cells, width);
+    if (height > 0xFFFF) {
+        fprintf(stderr, "%s: atlas too large (%dx%d)\n", outPath, width, height);
+        return 1;
+    }
+    
+    std::vector<uint8_t> pixels((size_t)width * height, 0);
+    for (const auto& cell : cells) {
+        for (int row = 0; row < cell.h; row++) {
+            memcpy(&pixels[(size_t)(cell.y + row) * width + cell.x], &cell.alpha[(size_t)row * cell.w], cell.w);
+        }
+    }
+    
+    uLongf compressedSize = compressBound(pixels.size());
+    std::vector<uint8_t> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, pixels.data(), pixels.size(), Z_BEST_COMPRESSION) != Z_OK) {
+        fprintf(stderr, "%s: compression failed\n", outPath);
+        return 1;
+    }
+    
+    std::string out;
+    PutU32(out, GLYPHATLAS_MAGIC);
+    PutU32(out, GLYPHATLAS_VERSION);
+    PutU32(out, cjk ? (uint32_t)GLYPHATLAS_FLAG_CJK : 0u);
+    PutU32(out, (uint32_t)width);
+    PutU32(out, (uint32_t)height);
+    PutU32(out, (uint32_t)faces.size());
+    PutU32(out, (uint32_t)cells.size());
+    PutU32(out, (uint32_t)compressedSize);
+    
+    // 字形按字号分组, 组内码位升序 (std::set 遍历顺序)
+    uint32_t firstGlyph = 0;
+    for (const auto& face : faces) {
+        PutU32(out, face.kind);
+        PutU32(out, face.size);
+        PutU32(out, face.height);
+        PutU32(out, firstGlyph);
+        PutU32(out, (uint32_t)face.cells.size());
+        firstGlyph += (uint32_t)face.cells.size();
+    }
+    for (const auto& face : faces) {
+        for (size_t index : face.cells) {
+            const Cell& cell = cells[index];
+            PutU32(out, cell.codepoint);
+            PutU16(out, (uint16_t)cell.x);
+            PutU16(out, (uint16_t)cell.y);
+            PutU16(out, (uint16_t)cell.w);
+            PutU16(out, (uint16_t)cell.h);
+        }
+    }
+    out.append((const char*)compressed.data(), compressedSize);
+    
+    std::ofstream file(outPath, std::ios::binary);
+    if (!file.is_open() || !file.write(out.data(), out.size())) {
+        fprintf(stderr, "%s: cannot write file\n", outPath);
+        return 1;
+    }
+    
+    printf("%s: %zu glyphs, %dx%d atlas, %zu KB\n", outPath, cells.size(), width, height, out.size() / 1024);
+    return 0;
+}
@@ -0,0 +1,194 @@
+// 语言包编译工具 (主机端, 由 Makefile 在构建时调用)
+//
+// 用法: langpack <reference.json> <input.json> <output.lang>
+//
+// - 把嵌套的语言 JSON 平坦化为 "section.key" -> 文本
+// - 与参考语言 (zh-cn) 比较键集合, 缺少或多出的键直接报错, 构建失败
+// - 生成 LangPack.hpp 描述的二进制语言包, 运行时只需切换指针
+
+#include "LangPack.hpp"
+#include "rapidjson/document.h"
+#include "rapidjson/error/en.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef std::map<std::string, std::string> TextMap;
+
+static bool ReadFile(const char* path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+static bool Flatten(const char* path, const rapidjson::Value& node, const std::string& prefix, TextMap& out) {
+    if (node.IsObject()) {
+        for (auto it = node.MemberBegin(); it != node.MemberEnd(); ++it) {
+            std::string key = prefix.empty() ? it->name.GetString() : prefix + "." + it->name.GetString();
+            if (!Flatten(path, it->value, key, out)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (node.IsString()) {
+        out[prefix] = std::string(node.GetString(), node.GetStringLength());
+        return true;
+    }
+    fprintf(stderr, "%s: '%s' is not a string\n", path, prefix.c_str());
+    return false;
+}
+
+static bool LoadTexts(const char* path, TextMap& out) {
+    std::string content;
+    if (!ReadFile(path, content)) {
+        fprintf(stderr, "%s: cannot open file\n", path);
+        return false;
+    }
+    
+    rapidjson::Document doc;
+    doc.Parse(content.c_str());
+    if (doc.HasParseError()) {
+        fprintf(stderr, "%s: JSON parse error at offset %zu: %s\n", path,
+            doc.GetErrorOffset(), rapidjson::GetParseError_En(doc.GetParseError()));
+        return false;
+    }
+    
+    return Flatten(path, doc, "", out);
+}
+
+// 假名、CJK 统一表意文字、韩文音节、全角字符等需要 CJK 字体
+static bool IsCJKCodepoint(uint32_t cp) {
+    return (cp >= 0x3000 && cp <= 0x30FF) ||
+           (cp >= 0x3400 && cp <= 0x9FFF) ||
+           (cp >= 0xAC00 && cp <= 0xD7AF) ||
+           (cp >= 0xF900 && cp <= 0xFAFF) ||
+           (cp >= 0xFF00 && cp <= 0xFFEF);
+}
+
+static bool ContainsCJK(const std::string& text) {
+    for (size_t i = 0; i < text.size();) {
+        uint8_t c = (uint8_t)text[i];
+        uint32_t cp;
+        int len;
+        if (c < 0x80)      { cp = c;        len = 1; }
+        else if (c < 0xE0) { cp = c & 0x1F; len = 2; }
+        else if (c < 0xF0) { cp = c & 0x0F; len = 3; }
+        else               { cp = c & 0x07; len = 4; }
+        for (int k = 1; k < len && i + k < text.size(); k++) {
+            cp = (cp << 6) | ((uint8_t)text[i + k] & 0x3F);
+        }
+        if (IsCJKCodepoint(cp)) {
+            return true;
+        }
+        i += len;
+    }
+    return false;
+}
+
+static void PutU32(std::string& out, uint32_t value) {
+    out.push_back((char)(value >> 24));
+    out.push_back((char)(value >> 16));
+    out.push_back((char)(value >> 8));
+    out.push_back((char)value);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s <reference.json> <input.json> <output.lang>\n", argv[0]);
+        return 1;
+    }
+    const char* refPath = argv[1];
+    const char* inPath = argv[2];
+    const char* outPath = argv[3];
+    
+    TextMap reference;
+    TextMap texts;
+    if (!LoadTexts(refPath, reference) || !LoadTexts(inPath, texts)) {
+        return 1;
+    }
+    
+    // 键集合必须与参考语言完全一致
+    int errors = 0;
+    for (const auto& pair : reference) {
+        if (texts.find(pair.first) == texts.end()) {
+            fprintf(stderr, "%s: missing key '%s'\n", inPath, pair.first.c_str());
+            errors++;
+        }
+    }
+    for (const auto& pair : texts) {
+        if (reference.find(pair.first) == reference.end()) {
+            fprintf(stderr, "%s: extra key '%s' (not in %s)\n", inPath, pair.first.c_str(), refPath);
+            errors++;
+        }
+    }
+    if (errors) {
+        return 1;
+    }
+    
+    // 负载不超过 1/2, 与运行时查找方式一致
+    uint32_t tableSize = 16;
+    while (tableSize < texts.size() * 2) {
+        tableSize <<= 1;
+    }
+    const uint32_t mask = tableSize - 1;
+    
+    std::vector<LangPackEntry> table(tableSize, LangPackEntry{0, 0, 0});
+    std::vector<const std::string*> slotKeys(tableSize, nullptr);
+    std::string blob;
+    bool cjk = false;
+    
+    for (const auto& pair : texts) {
+        uint32_t id = LangHash(pair.first);
+        uint32_t slot = id & mask;
+        while (table[slot].id != 0) {
+            if (table[slot].id == id) {
+                fprintf(stderr, "%s: key hash collision between '%s' and '%s', rename one of them\n",
+                    inPath, slotKeys[slot]->c_str(), pair.first.c_str());
+                return 1;
+            }
+            slot = (slot + 1) & mask;
+        }
+        
+        table[slot].id = id;
+        table[slot].offset = (uint32_t)blob.size();
+        table[slot].length = (uint32_t)pair.second.size();
+        slotKeys[slot] = &pair.first;
+        
+        blob.append(pair.second);
+        blob.push_back('\0');
+        cjk = cjk || ContainsCJK(pair.second);
+    }
+    
+    std::string out;
+    out.reserve(sizeof(LangPackHeader) + tableSize * sizeof(LangPackEntry) + blob.size());
+    PutU32(out, LANGPACK_MAGIC);
+    PutU32(out, LANGPACK_VERSION);
+    PutU32(out, cjk ? (uint32_t)LANGPACK_FLAG_CJK : 0u);
+    PutU32(out, (uint32_t)texts.size());
+    PutU32(out, tableSize);
+    PutU32(out, (uint32_t)blob.size());
+    for (const auto& entry : table) {
+        PutU32(out, entry.id);
+        PutU32(out, entry.offset);
+        PutU32(out, entry.length);
+    }
+    out.append(blob);
+    
+    std::ofstream file(outPath, std::ios::binary);
+    if (!file.is_open() || !file.write(out.data(), out.size())) {
+        fprintf(stderr, "%s: cannot write file\n", outPath);
+        return 1;
+    }
+    
+    return 0;
+}